@@ -0,0 +1,79 @@
+// line_index.c
+#include <stdint.h>
+#include <string.h>
+#include "line_index.h"
+
+#define LINE_INDEX_ONES 0x0101010101010101ULL
+#define LINE_INDEX_LOW7 0x7f7f7f7f7f7f7f7fULL
+
+// 8 字节一组（SWAR）：返回字中等于 '\n' 的字节的最高位组成的掩码，不会误报
+static inline uint64_t newline_mask(uint64_t word) {
+    uint64_t x = word ^ (LINE_INDEX_ONES * '\n');
+    uint64_t t = (x & LINE_INDEX_LOW7) + LINE_INDEX_LOW7;
+    return ~(t | x | LINE_INDEX_LOW7);
+}
+
+// 扫描全部换行符；starts 为 NULL 时只计数，否则依次记录每个换行之后的行首偏移
+static size_t scan_newlines(const char* input, size_t length, size_t* starts) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, input + i, sizeof(word));
+        uint64_t mask = newline_mask(word);
+        if (!starts) {
+            count += __builtin_popcountll(mask);
+            continue;
+        }
+        for (; mask; mask &= mask - 1) {
+            starts[count++] = i + (__builtin_ctzll(mask) >> 3) + 1;
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        if (input[i] == '\n') {
+            if (starts) starts[count] = i + 1;
+            count++;
+        }
+    }
+    return count;
+}
+
+void line_index_init(LineIndex* index, const char* input, size_t length, struct Arena* arena) {
+    index->input = input;
+    index->length = length;
+    index->starts = NULL;
+    index->line_count = 0;
+    index->arena = arena;
+}
+
+/// 建立行首偏移表；已建立时直接返回。先计数再填表，整个输入只需两次顺序扫描
+bool line_index_build(LineIndex* index) {
+    if (index->starts) return true;
+    if (!index->input || !index->arena) return false;
+
+    size_t newlines = scan_newlines(index->input, index->length, NULL);
+    size_t* starts = arena_alloc(index->arena, (newlines + 1) * sizeof(size_t));
+    if (!starts) return false;
+    starts[0] = 0;
+    scan_newlines(index->input, index->length, starts + 1);
+    index->starts = starts;
+    index->line_count = newlines + 1;
+    return true;
+}
+
+/// 把字节偏移换算为行列号；首次调用时才建立行首偏移表
+SourcePosition line_index_position(LineIndex* index, size_t offset) {
+    if (!line_index_build(index)) return (SourcePosition){ 0, 0 };
+    if (offset > index->length) offset = index->length;
+
+    // 二分查找最后一个不大于 offset 的行首
+    size_t lo = 0, hi = index->line_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->starts[mid] <= offset) lo = mid;
+        else hi = mid;
+    }
+    return (SourcePosition){ lo + 1, offset - index->starts[lo] + 1 };
+}
@@ -0,0 +1,27 @@
+// line_index.h
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
+
+typedef struct {
+    size_t line;     // 从 1 开始
+    size_t column;   // 从 1 开始，按字节计
+} SourcePosition;
+
+// 行首偏移表：扫描器只产生字节偏移，需要报错时才按需建立，用二分查找换算行列
+typedef struct {
+    const char* input;
+    size_t length;
+    size_t* starts;      // starts[i] 为第 i + 1 行首字节的偏移，未建立时为 NULL
+    size_t line_count;
+    struct Arena* arena;
+} LineIndex;
+
+void line_index_init(LineIndex* index, const char* input, size_t length, struct Arena* arena);
+bool line_index_build(LineIndex* index);
+SourcePosition line_index_position(LineIndex* index, size_t offset);
+
+#endif // LINE_INDEX_H
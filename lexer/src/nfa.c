@@ -5,6 +5,7 @@
 State* create_state(struct Arena* arena) {
     State* s = (State*)arena_alloc(arena, sizeof(State));
     s->is_accepting = 0;
+    s->id = -1;
     s->transitions = NULL;
     return s;
 }
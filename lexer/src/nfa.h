@@ -15,6 +15,7 @@ struct Transition {
 
 typedef struct State {
     int is_accepting;
+    int id;          // 子集构造时分配的编号，-1 表示尚未编号
     Transition* transitions;
 } State;
 
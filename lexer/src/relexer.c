@@ -0,0 +1,157 @@
+// relexer.c
+#include <stdio.h>
+#include <string.h>
+#include "relexer.h"
+
+// arena 不做对齐，这里统一按 8 字节取整
+static void* relexer_alloc(struct Arena* arena, size_t size) {
+    return arena_alloc(arena, (size + 7) & ~(size_t)7);
+}
+
+// 间隙前后的 token 在绝对坐标与“相对末尾”坐标之间互换，两个方向的换算相同
+static LexedToken flip_token(LexedToken token, size_t length) {
+    token.start = length - token.start;
+    token.lookahead = length + 1 - token.lookahead;
+    return token;
+}
+
+// 取第 index 个 token 的绝对坐标
+static LexedToken token_at(const Relexer* r, size_t index) {
+    if (index < r->gap_start) return r->tokens[index];
+    return flip_token(r->tokens[index + (r->gap_end - r->gap_start)], r->length);
+}
+
+size_t relexer_token_count(const Relexer* r) {
+    return r->token_capacity - (r->gap_end - r->gap_start);
+}
+
+ScanToken relexer_token(const Relexer* r, size_t index) {
+    LexedToken token = token_at(r, index);
+    return (ScanToken){ token.rule, token.start, token.length };
+}
+
+// 把间隙移动到第 index 个 token 之前，代价与移动距离成正比
+static void move_gap(Relexer* r, size_t index) {
+    while (r->gap_start > index) {
+        r->tokens[--r->gap_end] = flip_token(r->tokens[--r->gap_start], r->length);
+    }
+    while (r->gap_start < index) {
+        r->tokens[r->gap_start++] = flip_token(r->tokens[r->gap_end++], r->length);
+    }
+}
+
+static bool grow_tokens(Relexer* r) {
+    size_t new_capacity = r->token_capacity * 2 + 64;
+    LexedToken* tokens = relexer_alloc(r->arena, new_capacity * sizeof(LexedToken));
+    if (!tokens) return false;
+    size_t tail = r->token_capacity - r->gap_end;
+    if (r->gap_start) memcpy(tokens, r->tokens, r->gap_start * sizeof(LexedToken));
+    if (tail) memcpy(tokens + new_capacity - tail, r->tokens + r->gap_end, tail * sizeof(LexedToken));
+    r->tokens = tokens;
+    r->gap_end = new_capacity - tail;
+    r->token_capacity = new_capacity;
+    return true;
+}
+
+// 文本容量不足时倍增；扫描器的回退栈随文本长度一起扩容
+static bool reserve_text(Relexer* r, size_t length) {
+    if (length <= r->text_capacity && r->text) return true;
+    size_t new_capacity = r->text_capacity * 2;
+    if (new_capacity < length) new_capacity = length;
+    char* text = relexer_alloc(r->arena, new_capacity + 1);
+    ScanFrame* stack = relexer_alloc(r->arena, (new_capacity + 1) * sizeof(ScanFrame));
+    if (!text || !stack) return false;
+    if (r->length) memcpy(text, r->text, r->length);
+    r->text = text;
+    r->text_capacity = new_capacity;
+    r->scanner.stack = stack;
+    return true;
+}
+
+// 从 scanner 当前位置扫描，新 token 写入间隙；遇到与编辑区之后旧 token 对齐的边界时停止
+static bool relex_until_sync(Relexer* r, size_t sync_from) {
+    Scanner* sc = &r->scanner;
+    size_t begin = sc->pos;
+    ScanToken tok;
+    r->relexed_tokens = 0;
+    for (;;) {
+        size_t boundary = sc->pos;
+        // 丢弃起点已被新 token 覆盖的旧 token（编辑区内及其之前的旧 token 换算出的起点都小于 sync_from）
+        while (r->gap_end < r->token_capacity && r->tokens[r->gap_end].start + boundary > r->length) {
+            r->gap_end++;
+        }
+        // 旧 token 完全位于编辑区之后，且与当前边界对齐：之后的扫描结果与旧结果相同
+        if (boundary >= sync_from && r->gap_end < r->token_capacity &&
+            r->tokens[r->gap_end].start + boundary == r->length) {
+            break;
+        }
+        if (!scanner_next(sc, &tok)) {
+            r->gap_end = r->token_capacity;
+            break;
+        }
+        if (r->gap_start == r->gap_end && !grow_tokens(r)) return false;
+        r->tokens[r->gap_start++] = (LexedToken){ tok.rule, tok.start, tok.length, sc->lookahead };
+        r->relexed_tokens++;
+    }
+    r->relexed_bytes = sc->pos - begin;
+    return true;
+}
+
+bool relexer_init(Relexer* r, const LexDFA* dfa, const char* text, size_t length, struct Arena* arena) {
+    if (!r || !dfa || (!text && length) || !arena) return false;
+    memset(r, 0, sizeof(Relexer));
+    r->dfa = dfa;
+    r->arena = arena;
+    r->scanner.dfa = dfa;
+    if (!reserve_text(r, length > 64 ? length : 64)) return false;
+    if (length) memcpy(r->text, text, length);
+    r->length = length;
+
+    // 首次全量扫描时记忆表覆盖整个文本，之后的编辑只用其中一段窗口
+    r->memo_capacity = (length > RELEXER_MIN_MEMO_SPAN ? length : RELEXER_MIN_MEMO_SPAN) + 1;
+    size_t bits = r->memo_capacity * (size_t)dfa->state_count;
+    r->scanner.failed = relexer_alloc(arena, (bits + 63) / 64 * sizeof(uint64_t));
+    if (!r->scanner.failed) return false;
+
+    r->token_capacity = length / 4 + 64;
+    r->tokens = relexer_alloc(arena, r->token_capacity * sizeof(LexedToken));
+    if (!r->tokens) return false;
+    r->gap_start = 0;
+    r->gap_end = r->token_capacity;
+
+    scanner_restart(&r->scanner, r->text, length, 0, r->memo_capacity - 1);
+    return relex_until_sync(r, length + 1);
+}
+
+/// 把 [offset, offset + removed) 替换为 inserted，并增量更新 token 序列。
+/// 重新扫描从依赖范围越过 offset 的第一个 token 开始，代价与编辑区大小（加上同步所需的少量 token）成正比
+bool relexer_edit(Relexer* r, size_t offset, size_t removed, const char* inserted, size_t inserted_length) {
+    if (!r || offset > r->length || removed > r->length - offset || (!inserted && inserted_length)) return false;
+
+    // 1. 找到受影响的第一个 token：先二分找到包含 offset 的 token，再向前找依赖范围越过 offset 的 token
+    size_t count = relexer_token_count(r);
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (token_at(r, mid).start <= offset) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t first = lo;
+    while (first > 0 && token_at(r, first - 1).lookahead > offset) first--;
+    move_gap(r, first);
+
+    // 2. 修改文本；间隙之后的 token 相对末尾定位，编辑区之后的部分因此自动正确
+    size_t new_length = r->length - removed + inserted_length;
+    if (!reserve_text(r, new_length)) return false;
+    memmove(r->text + offset + inserted_length, r->text + offset + removed, r->length - offset - removed);
+    if (inserted_length) memcpy(r->text + offset, inserted, inserted_length);
+    r->length = new_length;
+
+    // 3. 从受影响的第一个 token 起重新扫描，记忆表窗口与本次需要扫描的范围同量级
+    size_t rescan = first > 0 ? r->tokens[first - 1].start + r->tokens[first - 1].length : 0;
+    size_t sync_from = offset + inserted_length;
+    size_t span = 4 * (sync_from - rescan) + RELEXER_MIN_MEMO_SPAN;
+    if (span > r->memo_capacity - 1) span = r->memo_capacity - 1;
+    scanner_restart(&r->scanner, r->text, new_length, rescan, span);
+    return relex_until_sync(r, sync_from);
+}
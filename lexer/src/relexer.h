@@ -0,0 +1,44 @@
+// relexer.h
+#ifndef RELEXER_H
+#define RELEXER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
+#include "scanner.h"
+
+#define RELEXER_MIN_MEMO_SPAN 4096
+
+// 增量词法分析保存的 token：除了位置，还记录扫描它时依赖的输入范围
+typedef struct {
+    int rule;
+    size_t start;       // 间隙之前为绝对偏移；间隙之后为到文本末尾的距离 (length - start)
+    size_t length;
+    size_t lookahead;   // 依赖范围的右端（不含）；间隙之后存 length + 1 - lookahead
+} LexedToken;
+
+// 编辑器场景下的增量词法分析：编辑后只从受影响的第一个 token 开始重新扫描，
+// 一旦新的 token 边界与编辑区之后的旧 token 边界重合就停止，并把结果拼接回 token 序列。
+// token 序列用间隙缓冲保存，间隙之后的 token 相对文本末尾定位，编辑时无需逐个平移偏移量。
+typedef struct {
+    const LexDFA* dfa;
+    struct Arena* arena;
+    char* text;
+    size_t length;
+    size_t text_capacity;
+    LexedToken* tokens;
+    size_t gap_start;
+    size_t gap_end;
+    size_t token_capacity;
+    Scanner scanner;
+    size_t memo_capacity;    // scanner.failed 可以覆盖的位置数
+    size_t relexed_bytes;    // 最近一次编辑重新扫描的字节数
+    size_t relexed_tokens;   // 最近一次编辑新产生的 token 数
+} Relexer;
+
+bool relexer_init(Relexer* relexer, const LexDFA* dfa, const char* text, size_t length, struct Arena* arena);
+bool relexer_edit(Relexer* relexer, size_t offset, size_t removed, const char* inserted, size_t inserted_length);
+size_t relexer_token_count(const Relexer* relexer);
+ScanToken relexer_token(const Relexer* relexer, size_t index);
+
+#endif // RELEXER_H
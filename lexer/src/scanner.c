@@ -0,0 +1,317 @@
+// scanner.c
+#include <stdio.h>
+#include <string.h>
+#include "scanner.h"
+#include "nfa.h"
+#include "parser.h"
+
+// arena 不做对齐，这里统一按 8 字节取整，保证后续分配的地址仍然对齐
+static void* scanner_alloc(struct Arena* arena, size_t size) {
+    return arena_alloc(arena, (size + 7) & ~(size_t)7);
+}
+
+typedef struct {
+    State** items;
+    int count;
+    int capacity;
+} StateVec;
+
+static bool statevec_push(StateVec* vec, State* s, struct Arena* arena) {
+    if (vec->count >= vec->capacity) {
+        int new_capacity = vec->capacity ? vec->capacity * 2 : 64;
+        State** items = scanner_alloc(arena, new_capacity * sizeof(State*));
+        if (!items) return false;
+        if (vec->count) memcpy(items, vec->items, vec->count * sizeof(State*));
+        vec->items = items;
+        vec->capacity = new_capacity;
+    }
+    vec->items[vec->count++] = s;
+    return true;
+}
+
+// 为从 root 可达且尚未编号的 NFA 状态编号，states 本身充当 BFS 队列
+static bool number_states(State* root, StateVec* states, struct Arena* arena) {
+    if (root->id != -1) return true;
+    int first = states->count;
+    root->id = states->count;
+    if (!statevec_push(states, root, arena)) return false;
+    for (int i = first; i < states->count; i++) {
+        for (Transition* t = states->items[i]->transitions; t; t = t->next) {
+            if (t->target->id == -1) {
+                t->target->id = states->count;
+                if (!statevec_push(states, t->target, arena)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 求集合的 epsilon 闭包，stack 至少能容纳全部 NFA 状态
+static void close_set(uint64_t* set, int words, State** nfa, int* stack) {
+    int top = 0;
+    for (int w = 0; w < words; w++) {
+        for (uint64_t bits = set[w]; bits; bits &= bits - 1) {
+            stack[top++] = w * 64 + __builtin_ctzll(bits);
+        }
+    }
+    while (top > 0) {
+        State* s = nfa[stack[--top]];
+        for (Transition* t = s->transitions; t; t = t->next) {
+            int id = t->target->id;
+            if (t->symbol == '\0' && !(set[id / 64] & (1ULL << (id % 64)))) {
+                set[id / 64] |= 1ULL << (id % 64);
+                stack[top++] = id;
+            }
+        }
+    }
+}
+
+static uint32_t hash_set(const uint64_t* set, int words) {
+    uint64_t h = 1469598103934665603ULL;
+    for (int w = 0; w < words; w++) {
+        h ^= set[w];
+        h *= 1099511628211ULL;
+    }
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+// 子集构造过程中的 DFA 状态表（按需倍增，旧空间留在 arena 中）
+typedef struct {
+    uint64_t* sets;
+    int16_t* next;
+    int16_t* accept;
+    int count;
+    int capacity;
+} DStates;
+
+static bool dstates_grow(DStates* ds, int words, int class_count, struct Arena* arena) {
+    int new_capacity = ds->capacity ? ds->capacity * 2 : 32;
+    if (new_capacity > SCANNER_MAX_DFA_STATES) new_capacity = SCANNER_MAX_DFA_STATES;
+    if (new_capacity <= ds->capacity) {
+        fprintf(stderr, "Exceeded maximum number of DFA states (%d)\n", SCANNER_MAX_DFA_STATES);
+        return false;
+    }
+    uint64_t* sets = scanner_alloc(arena, (size_t)new_capacity * words * sizeof(uint64_t));
+    int16_t* next = scanner_alloc(arena, (size_t)new_capacity * class_count * sizeof(int16_t));
+    int16_t* accept = scanner_alloc(arena, (size_t)new_capacity * sizeof(int16_t));
+    if (!sets || !next || !accept) return false;
+    if (ds->count) {
+        memcpy(sets, ds->sets, (size_t)ds->count * words * sizeof(uint64_t));
+        memcpy(next, ds->next, (size_t)ds->count * class_count * sizeof(int16_t));
+        memcpy(accept, ds->accept, (size_t)ds->count * sizeof(int16_t));
+    }
+    ds->sets = sets;
+    ds->next = next;
+    ds->accept = accept;
+    ds->capacity = new_capacity;
+    return true;
+}
+
+// 在 hash 表中查找集合，不存在则新建 DFA 状态；返回状态编号，失败返回 -1
+static int intern_set(DStates* ds, int16_t* table, const uint64_t* set, int words,
+                      int class_count, const int* rule_of, struct Arena* arena)
+{
+    uint32_t mask = 2 * SCANNER_MAX_DFA_STATES - 1;
+    uint32_t slot = hash_set(set, words) & mask;
+    while (table[slot] != -1) {
+        int id = table[slot];
+        if (memcmp(ds->sets + (size_t)id * words, set, words * sizeof(uint64_t)) == 0) return id;
+        slot = (slot + 1) & mask;
+    }
+    if (ds->count >= ds->capacity && !dstates_grow(ds, words, class_count, arena)) return -1;
+
+    int id = ds->count++;
+    memcpy(ds->sets + (size_t)id * words, set, words * sizeof(uint64_t));
+    // 同时接受多条规则时，取编号最小（写在最前面）的规则
+    int16_t accept = SCANNER_NO_RULE;
+    for (int w = 0; w < words; w++) {
+        for (uint64_t bits = set[w]; bits; bits &= bits - 1) {
+            int rule = rule_of[w * 64 + __builtin_ctzll(bits)];
+            if (rule != SCANNER_NO_RULE && (accept == SCANNER_NO_RULE || rule < accept)) accept = rule;
+        }
+    }
+    ds->accept[id] = accept;
+    table[slot] = id;
+    return id;
+}
+
+LexDFA* lexdfa_build(const char* const* patterns, int rule_count, struct Arena* arena) {
+    if (!patterns || rule_count <= 0 || !arena) return NULL;
+
+    // 1. 每条规则单独构造 NFA，再用 epsilon 转移并联到一个新的开始状态
+    StateVec states = {0};
+    int* rule_first = scanner_alloc(arena, (rule_count + 1) * sizeof(int));
+    State* start = create_state(arena);
+    if (!rule_first || !start) return NULL;
+    for (int r = 0; r < rule_count; r++) {
+        State* rule_start = parse_regex(patterns[r], arena);
+        if (!rule_start) return NULL;
+        add_transition(arena, start, '\0', rule_start);
+        rule_first[r] = states.count;
+        if (!number_states(rule_start, &states, arena)) return NULL;
+    }
+    rule_first[rule_count] = states.count;
+    if (!number_states(start, &states, arena)) return NULL;
+
+    int n = states.count;
+    int words = (n + 63) / 64;
+    int* rule_of = scanner_alloc(arena, n * sizeof(int));
+    int* stack = scanner_alloc(arena, n * sizeof(int));
+    LexDFA* dfa = scanner_alloc(arena, sizeof(LexDFA));
+    if (!rule_of || !stack || !dfa) return NULL;
+    for (int i = 0; i < n; i++) rule_of[i] = SCANNER_NO_RULE;
+    for (int r = 0; r < rule_count; r++) {
+        for (int i = rule_first[r]; i < rule_first[r + 1]; i++) {
+            if (states.items[i]->is_accepting) rule_of[i] = r;
+        }
+    }
+
+    // 2. 字节等价类：出现在转移上的每个字符各成一类，其余字符归入 0 类（总是通向死状态）
+    memset(dfa->classes, 0, sizeof(dfa->classes));
+    int class_count = 1;
+    for (int i = 0; i < n; i++) {
+        for (Transition* t = states.items[i]->transitions; t; t = t->next) {
+            unsigned char c = (unsigned char)t->symbol;
+            if (c != '\0' && dfa->classes[c] == 0) dfa->classes[c] = (uint8_t)class_count++;
+        }
+    }
+
+    // 3. 子集构造
+    DStates ds = {0};
+    int16_t* table = scanner_alloc(arena, 2 * SCANNER_MAX_DFA_STATES * sizeof(int16_t));
+    uint64_t* moves = scanner_alloc(arena, (size_t)class_count * words * sizeof(uint64_t));
+    if (!table || !moves) return NULL;
+    memset(table, 0xff, 2 * SCANNER_MAX_DFA_STATES * sizeof(int16_t));
+
+    memset(moves, 0, words * sizeof(uint64_t));
+    moves[start->id / 64] |= 1ULL << (start->id % 64);
+    close_set(moves, words, states.items, stack);
+    int start_id = intern_set(&ds, table, moves, words, class_count, rule_of, arena);
+    if (start_id < 0) return NULL;
+
+    for (int d = 0; d < ds.count; d++) {
+        memset(moves, 0, (size_t)class_count * words * sizeof(uint64_t));
+        for (int w = 0; w < words; w++) {
+            for (uint64_t bits = ds.sets[(size_t)d * words + w]; bits; bits &= bits - 1) {
+                State* s = states.items[w * 64 + __builtin_ctzll(bits)];
+                for (Transition* t = s->transitions; t; t = t->next) {
+                    if (t->symbol == '\0') continue;
+                    uint64_t* move = moves + (size_t)dfa->classes[(unsigned char)t->symbol] * words;
+                    move[t->target->id / 64] |= 1ULL << (t->target->id % 64);
+                }
+            }
+        }
+        ds.next[(size_t)d * class_count] = SCANNER_DEAD;
+        for (int c = 1; c < class_count; c++) {
+            uint64_t* move = moves + (size_t)c * words;
+            bool empty = true;
+            for (int w = 0; w < words && empty; w++) empty = (move[w] == 0);
+            if (empty) {
+                ds.next[(size_t)d * class_count + c] = SCANNER_DEAD;
+                continue;
+            }
+            close_set(move, words, states.items, stack);
+            int target = intern_set(&ds, table, move, words, class_count, rule_of, arena);
+            if (target < 0) return NULL;
+            ds.next[(size_t)d * class_count + c] = (int16_t)target;
+        }
+    }
+
+    dfa->next = ds.next;
+    dfa->accept = ds.accept;
+    dfa->class_count = class_count;
+    dfa->state_count = ds.count;
+    dfa->start = start_id;
+    return dfa;
+}
+
+bool scanner_init(Scanner* scanner, const LexDFA* dfa, const char* input, size_t length, struct Arena* arena) {
+    if (!scanner || !dfa || !input || !arena) return false;
+    size_t bits = (length + 1) * (size_t)dfa->state_count;
+    size_t words = (bits + 63) / 64;
+    scanner->failed = scanner_alloc(arena, words * sizeof(uint64_t));
+    scanner->stack = scanner_alloc(arena, (length + 1) * sizeof(ScanFrame));
+    if (!scanner->failed || !scanner->stack) return false;
+    scanner->dfa = dfa;
+    scanner->transitions = 0;
+    scanner_restart(scanner, input, length, 0, length);
+    return true;
+}
+
+/// 从 pos 开始一轮新的扫描（例如输入被编辑之后），记忆表窗口为 [pos, pos + memo_span]。
+/// 调用者保证 failed 至少能容纳 (memo_span + 1) * state_count 位，stack 至少 length - pos + 1 个元素
+void scanner_restart(Scanner* scanner, const char* input, size_t length, size_t pos, size_t memo_span) {
+    if (pos + memo_span > length) memo_span = length - pos;
+    size_t bits = (memo_span + 1) * (size_t)scanner->dfa->state_count;
+    memset(scanner->failed, 0, (bits + 63) / 64 * sizeof(uint64_t));
+    scanner->input = input;
+    scanner->length = length;
+    scanner->pos = pos;
+    scanner->memo_base = pos;
+    scanner->memo_end = pos + memo_span;
+    scanner->horizon = pos;
+    scanner->lookahead = pos;
+}
+
+/// 取下一个 token；输入结束时返回 false。
+/// 沿 DFA 一直走到死状态、输入末尾或已知失败的格局，再回退到最近的接受格局。
+/// 回退途中经过的 (state, pos) 都记入 failed，之后任何 token 再到达这些格局时立即停止，
+/// 因此每个格局至多被展开一次，整体扫描为 O(n)。
+bool scanner_next(Scanner* scanner, ScanToken* token) {
+    const LexDFA* dfa = scanner->dfa;
+    size_t begin = scanner->pos;
+    if (begin >= scanner->length) return false;
+
+    size_t memo_span = scanner->memo_end - scanner->memo_base;
+    size_t top = 0;
+    size_t reach = begin;   // 本 token 读过的最远位置（不含）
+    int q = dfa->start;
+    size_t i = begin;
+    while (q != SCANNER_DEAD) {
+        size_t rel = i - scanner->memo_base;
+        if (rel <= memo_span) {
+            size_t bit = rel * dfa->state_count + q;
+            // 失败格局是之前读到 horizon 为止的输入得出的结论，本 token 同样依赖这段输入
+            if (scanner->failed[bit / 64] & (1ULL << (bit % 64))) {
+                reach = scanner->horizon;
+                break;
+            }
+        }
+        // 遇到接受格局就清栈：更早的格局不会再被回退到
+        if (i > begin && dfa->accept[q] != SCANNER_NO_RULE) top = 0;
+        scanner->stack[top++] = (ScanFrame){ q, i };
+        if (i == scanner->length) {
+            if (reach < i + 1) reach = i + 1;   // 结果依赖“输入在此结束”，记为多读了一个字节
+            break;
+        }
+        q = dfa->next[q * dfa->class_count + dfa->classes[(unsigned char)scanner->input[i]]];
+        i++;
+        if (reach < i) reach = i;
+        scanner->transitions++;
+    }
+    if (scanner->horizon < reach) scanner->horizon = reach;
+    scanner->lookahead = reach;
+
+    while (top > 0) {
+        ScanFrame frame = scanner->stack[--top];
+        if (frame.pos > begin && dfa->accept[frame.state] != SCANNER_NO_RULE) {
+            token->rule = dfa->accept[frame.state];
+            token->start = begin;
+            token->length = frame.pos - begin;
+            scanner->pos = frame.pos;
+            return true;
+        }
+        size_t rel = frame.pos - scanner->memo_base;
+        if (rel <= memo_span) {
+            size_t bit = rel * dfa->state_count + frame.state;
+            scanner->failed[bit / 64] |= 1ULL << (bit % 64);
+        }
+    }
+
+    // 没有任何非空前缀可被接受：消费一个字节作为错误 token，与 lexer_next_token 对 T_INVALID 的处理一致
+    token->rule = SCANNER_NO_RULE;
+    token->start = begin;
+    token->length = 1;
+    scanner->pos = begin + 1;
+    return true;
+}
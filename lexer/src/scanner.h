@@ -0,0 +1,56 @@
+// scanner.h
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+#define SCANNER_MAX_DFA_STATES 4096
+#define SCANNER_NO_RULE (-1)   // 无法识别的字符，单独成为一个长度为 1 的 token
+#define SCANNER_DEAD (-1)      // DFA 中的死状态
+
+// 由多条词法规则合并而成的 DFA
+typedef struct {
+    int16_t* next;            // 稠密转移表 next[state * class_count + class]
+    int16_t* accept;          // 状态接受的规则编号（编号越小优先级越高），-1 表示非接受
+    uint8_t classes[256];     // 字节到等价类的映射，0 类为未出现在任何规则中的字符
+    int class_count;
+    int state_count;
+    int start;
+} LexDFA;
+
+typedef struct {
+    int rule;        // 匹配到的规则编号，SCANNER_NO_RULE 表示错误字符
+    size_t start;    // token 在输入中的字节偏移
+    size_t length;
+} ScanToken;
+
+typedef struct {
+    int state;
+    size_t pos;
+} ScanFrame;
+
+// 表驱动的最长匹配扫描器（Reps 的 tabulating maximal munch），保证 O(n)
+typedef struct {
+    const LexDFA* dfa;
+    const char* input;
+    size_t length;
+    size_t pos;
+    uint64_t* failed;     // 记忆表：位 ((pos - memo_base) * state_count + state) 表示从该格局出发不可能再接受
+    size_t memo_base;     // 记忆表只覆盖位置 [memo_base, memo_end]，窗口外的格局不做记忆
+    size_t memo_end;
+    ScanFrame* stack;     // 至少 length - pos + 1 个元素
+    size_t horizon;       // 本次扫描读到过的最远位置（不含），读到输入末尾时为 length + 1
+    size_t lookahead;     // 上一个 token 的结果所依赖的输入范围的右端（不含），含义同 horizon
+    size_t transitions;   // 已执行的 DFA 转移次数，供基准测试检查线性
+} Scanner;
+
+LexDFA* lexdfa_build(const char* const* patterns, int rule_count, struct Arena* arena);
+
+bool scanner_init(Scanner* scanner, const LexDFA* dfa, const char* input, size_t length, struct Arena* arena);
+void scanner_restart(Scanner* scanner, const char* input, size_t length, size_t pos, size_t memo_span);
+bool scanner_next(Scanner* scanner, ScanToken* token);
+
+#endif // SCANNER_H
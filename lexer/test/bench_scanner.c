@@ -0,0 +1,112 @@
+// bench_scanner.c
+// 最长匹配扫描的回归基准：在最坏情况输入上对比朴素回溯扫描与记忆化扫描。
+// clang -std=c11 -O2 bench_scanner.c -o bench_scanner -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/lexer.h"
+#include "../src/lexer.c"
+
+#include "../src/nfa.h"
+#include "../src/nfa.c"
+
+#include "../src/parser.h"
+#include "../src/parser.c"
+
+#include "../src/scanner.h"
+#include "../src/scanner.c"
+
+// 朴素的最长匹配：每个 token 都一直读到死状态，再回退到最后一个接受位置
+static size_t naive_scan(const LexDFA* dfa, const char* input, size_t length, size_t* token_count) {
+    size_t transitions = 0;
+    size_t pos = 0;
+    *token_count = 0;
+    while (pos < length) {
+        int q = dfa->start;
+        size_t end = pos;
+        for (size_t i = pos; i < length; i++) {
+            q = dfa->next[q * dfa->class_count + dfa->classes[(unsigned char)input[i]]];
+            transitions++;
+            if (q == SCANNER_DEAD) break;
+            if (dfa->accept[q] != SCANNER_NO_RULE) end = i + 1;
+        }
+        pos = (end > pos) ? end : pos + 1;
+        (*token_count)++;
+    }
+    return transitions;
+}
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+typedef struct {
+    const char* name;
+    const char* patterns[4];
+    int rule_count;
+    const char* unit;   // 输入由 unit 重复构成，最后追加 tail
+    const char* tail;
+} BenchCase;
+
+int main(void) {
+    BenchCase cases[] = {
+        // 每个 "a" 都会诱使朴素扫描读到输入末尾去找 b
+        { "a*b | a on a^n", { "a*b", "a" }, 2, "a", "" },
+        // 前缀 a^k b^m 一直像是 a*b*c 的前缀，直到末尾也没有 c
+        { "a*b*c | a | b on a^n b^n", { "a*b*c", "a", "b" }, 3, "a", "b" },
+    };
+    size_t sizes[] = { 1000, 4000, 16000, 32000 };
+    int failed = 0;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        printf("=== %s ===\n", cases[c].name);
+        printf("%10s %14s %10s %14s %10s\n", "n", "naive steps", "naive s", "tabular steps", "tabular s");
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t n = sizes[s];
+            char* input = malloc(n + 1);
+            // 前一半为 unit，后一半为 tail（tail 为空时整段都是 unit）
+            size_t half = cases[c].tail[0] ? n / 2 : n;
+            memset(input, cases[c].unit[0], half);
+            if (half < n) memset(input + half, cases[c].tail[0], n - half);
+            input[n] = '\0';
+
+            struct Arena* arena = arena_create(64 * n + 1024 * 1024);
+            LexDFA* dfa = lexdfa_build(cases[c].patterns, cases[c].rule_count, arena);
+            if (!dfa) {
+                fprintf(stderr, "Failed to build DFA\n");
+                return 1;
+            }
+
+            size_t naive_tokens;
+            clock_t begin = clock();
+            size_t naive_steps = naive_scan(dfa, input, n, &naive_tokens);
+            double naive_time = seconds_since(begin);
+
+            Scanner sc;
+            scanner_init(&sc, dfa, input, n, arena);
+            ScanToken tok;
+            size_t tokens = 0;
+            begin = clock();
+            while (scanner_next(&sc, &tok)) tokens++;
+            double tab_time = seconds_since(begin);
+
+            printf("%10zu %14zu %10.4f %14zu %10.4f\n", n, naive_steps, naive_time, sc.transitions, tab_time);
+            // 回归检查：两种扫描得到的 token 数一致，且记忆化扫描的转移数线性于输入长度
+            if (tokens != naive_tokens || sc.transitions > 3 * n) {
+                fprintf(stderr, "REGRESSION: tokens %zu vs %zu, transitions %zu for n=%zu\n",
+                        tokens, naive_tokens, sc.transitions, n);
+                failed = 1;
+            }
+            arena_free(arena);
+            free(input);
+        }
+        printf("\n");
+    }
+    return failed;
+}
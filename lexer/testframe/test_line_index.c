@@ -0,0 +1,72 @@
+// test/test_line_index.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tiny_test_framework.h"
+#include "../src/arena.h"
+#include "../src/line_index.h"
+
+// --- Helper: compare a lookup against the expected line:column ---
+static void expect_position(LineIndex* index, size_t offset, size_t line, size_t column) {
+    SourcePosition pos = line_index_position(index, offset);
+    ASSERT_EQ_SIZE(line, pos.line);
+    ASSERT_EQ_SIZE(column, pos.column);
+}
+
+// --- Individual Test Functions ---
+
+static void test_line_index_lazy_build(void) {
+    struct Arena* a = arena_create(1024);
+    ASSERT_NOT_NULL(a);
+    const char* input = "ab\ncd";
+    LineIndex index;
+    line_index_init(&index, input, strlen(input), a);
+    ASSERT_NULL(index.starts); // Nothing is scanned until a position is requested
+    expect_position(&index, 4, 2, 2);
+    ASSERT_NOT_NULL(index.starts);
+    ASSERT_EQ_SIZE(2, index.line_count);
+    arena_free(a);
+}
+
+static void test_line_index_positions(void) {
+    struct Arena* a = arena_create(1024);
+    ASSERT_NOT_NULL(a);
+    const char* input = "a\n\nbc\n";
+    LineIndex index;
+    line_index_init(&index, input, strlen(input), a);
+    expect_position(&index, 0, 1, 1);
+    expect_position(&index, 1, 1, 2); // the newline itself belongs to its line
+    expect_position(&index, 2, 2, 1);
+    expect_position(&index, 3, 3, 1);
+    expect_position(&index, 4, 3, 2);
+    expect_position(&index, 6, 4, 1); // end of input after a trailing newline
+    arena_free(a);
+}
+
+static void test_line_index_matches_bytewise_scan(void) {
+    // Long enough to exercise the 8-byte word loop and the byte tail
+    enum { N = 1000 };
+    struct Arena* a = arena_create(N * sizeof(size_t) + 64);
+    ASSERT_NOT_NULL(a);
+    char* input = malloc(N);
+    for (int i = 0; i < N; i++) input[i] = (i * 7 % 13 == 0) ? '\n' : (char)('a' + i % 26);
+
+    LineIndex index;
+    line_index_init(&index, input, N, a);
+    size_t line = 1, column = 1;
+    for (size_t i = 0; i < N; i++) {
+        SourcePosition pos = line_index_position(&index, i);
+        ASSERT_TRUE(pos.line == line && pos.column == column);
+        if (input[i] == '\n') { line++; column = 1; } else { column++; }
+    }
+    free(input);
+    arena_free(a);
+}
+
+// --- Test Registration Function ---
+void register_line_index_tests(void) {
+    register_test("line_index_lazy_build", test_line_index_lazy_build);
+    register_test("line_index_positions", test_line_index_positions);
+    register_test("line_index_matches_bytewise_scan", test_line_index_matches_bytewise_scan);
+}
@@ -0,0 +1,107 @@
+// test/test_relexer.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tiny_test_framework.h"
+#include "../src/arena.h"
+#include "../src/scanner.h"
+#include "../src/relexer.h"
+
+static const char* g_relexer_patterns[] = { "ab*", "b", "a*c", "x" };
+
+// --- Helper: the incremental token stream must equal a fresh full scan of the text ---
+static void expect_same_as_full_scan(const Relexer* r, const LexDFA* dfa) {
+    struct Arena* a = arena_create(r->length * 64 + 4096);
+    Scanner sc;
+    ASSERT_TRUE(scanner_init(&sc, dfa, r->text, r->length, a));
+    ScanToken tok;
+    size_t i = 0;
+    size_t count = relexer_token_count(r);
+    while (scanner_next(&sc, &tok)) {
+        ASSERT_TRUE(i < count);
+        if (i >= count) break;
+        ScanToken got = relexer_token(r, i++);
+        ASSERT_TRUE(got.rule == tok.rule && got.start == tok.start && got.length == tok.length);
+    }
+    ASSERT_EQ_SIZE(count, i);
+    arena_free(a);
+}
+
+// --- Individual Test Functions ---
+
+static void test_relexer_insert_and_delete(void) {
+    struct Arena* a = arena_create(1024 * 1024);
+    LexDFA* dfa = lexdfa_build(g_relexer_patterns, 4, a);
+    ASSERT_NOT_NULL(dfa);
+    Relexer r;
+    const char* text = "abbxaacbx";
+    ASSERT_TRUE(relexer_init(&r, dfa, text, strlen(text), a));
+    expect_same_as_full_scan(&r, dfa);
+
+    ASSERT_TRUE(relexer_edit(&r, 3, 0, "bb", 2));   // abb|bb|xaacbx: joins the first token
+    expect_same_as_full_scan(&r, dfa);
+    ASSERT_TRUE(relexer_edit(&r, 0, 5, NULL, 0));   // delete the prefix
+    expect_same_as_full_scan(&r, dfa);
+    ASSERT_TRUE(relexer_edit(&r, r.length, 0, "c", 1)); // append at end of input
+    expect_same_as_full_scan(&r, dfa);
+    ASSERT_FALSE(relexer_edit(&r, r.length + 1, 0, "a", 1));
+    arena_free(a);
+}
+
+static void test_relexer_lookahead_dependency(void) {
+    // "aaa" lexes as a, a, a only because no 'c' follows; appending 'c' must re-lex all of it
+    struct Arena* a = arena_create(1024 * 1024);
+    LexDFA* dfa = lexdfa_build(g_relexer_patterns, 4, a);
+    Relexer r;
+    ASSERT_TRUE(relexer_init(&r, dfa, "aaa", 3, a));
+    ASSERT_EQ_SIZE(3, relexer_token_count(&r));
+    ASSERT_TRUE(relexer_edit(&r, 3, 0, "c", 1));
+    ASSERT_EQ_SIZE(1, relexer_token_count(&r));
+    ASSERT_EQ_INT(2, relexer_token(&r, 0).rule);
+    arena_free(a);
+}
+
+static void test_relexer_random_edits(void) {
+    struct Arena* a = arena_create(8 * 1024 * 1024);
+    LexDFA* dfa = lexdfa_build(g_relexer_patterns, 4, a);
+    Relexer r;
+    ASSERT_TRUE(relexer_init(&r, dfa, "", 0, a));
+    const char alphabet[] = "abcx?";
+    char inserted[8];
+    srand(42);
+    for (int step = 0; step < 300; step++) {
+        size_t offset = r.length ? (size_t)rand() % (r.length + 1) : 0;
+        size_t removed = (size_t)rand() % 3;
+        if (removed > r.length - offset) removed = r.length - offset;
+        size_t inserted_length = (size_t)rand() % 5;
+        for (size_t i = 0; i < inserted_length; i++) inserted[i] = alphabet[rand() % 5];
+        ASSERT_TRUE(relexer_edit(&r, offset, removed, inserted, inserted_length));
+        expect_same_as_full_scan(&r, dfa);
+    }
+    arena_free(a);
+}
+
+static void test_relexer_cost_independent_of_file_size(void) {
+    enum { N = 100000 };
+    struct Arena* a = arena_create(64 * 1024 * 1024);
+    LexDFA* dfa = lexdfa_build(g_relexer_patterns, 4, a);
+    char* text = malloc(N);
+    for (size_t i = 0; i < N; i++) text[i] = "abbx"[i % 4];
+    Relexer r;
+    ASSERT_TRUE(relexer_init(&r, dfa, text, N, a));
+    ASSERT_TRUE(relexer_edit(&r, N / 2, 1, "c", 1));
+    ASSERT_TRUE(r.relexed_bytes < 16);
+    ASSERT_TRUE(r.relexed_tokens < 8);
+    expect_same_as_full_scan(&r, dfa);
+    free(text);
+    arena_free(a);
+}
+
+// --- Test Registration Function ---
+void register_relexer_tests(void) {
+    register_test("relexer_insert_and_delete", test_relexer_insert_and_delete);
+    register_test("relexer_lookahead_dependency", test_relexer_lookahead_dependency);
+    register_test("relexer_random_edits", test_relexer_random_edits);
+    register_test("relexer_cost_independent_of_file_size", test_relexer_cost_independent_of_file_size);
+}
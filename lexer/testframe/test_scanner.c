@@ -0,0 +1,95 @@
+// test/test_scanner.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tiny_test_framework.h"
+#include "../src/arena.h"
+#include "../src/scanner.h"
+
+// --- Helper: scan the whole input and compare (rule, start, length) triples ---
+static void expect_tokens(const char* const* patterns, int rule_count,
+                          const char* input, const ScanToken* expected, int expected_count)
+{
+    struct Arena* a = arena_create(1024 * 64);
+    ASSERT_NOT_NULL(a);
+    LexDFA* dfa = lexdfa_build(patterns, rule_count, a);
+    ASSERT_NOT_NULL(dfa);
+    if (!dfa) { arena_free(a); return; }
+
+    Scanner sc;
+    ASSERT_TRUE(scanner_init(&sc, dfa, input, strlen(input), a));
+    ScanToken tok;
+    int i = 0;
+    while (scanner_next(&sc, &tok)) {
+        ASSERT_TRUE(i < expected_count);
+        if (i >= expected_count) break;
+        ASSERT_EQ_INT(expected[i].rule, tok.rule);
+        ASSERT_EQ_SIZE(expected[i].start, tok.start);
+        ASSERT_EQ_SIZE(expected[i].length, tok.length);
+        i++;
+    }
+    ASSERT_EQ_INT(expected_count, i);
+    arena_free(a);
+}
+
+// --- Individual Test Functions ---
+
+static void test_scanner_longest_match(void) {
+    const char* patterns[] = { "a", "ab*" };
+    ScanToken expected[] = { {1, 0, 3}, {0, 3, 1}, {1, 4, 2} };
+    expect_tokens(patterns, 2, "abbaab", expected, 3);
+}
+
+static void test_scanner_rule_priority(void) {
+    // "ab" is matched by both rules; the rule listed first wins
+    const char* patterns[] = { "ab", "a*b" };
+    ScanToken expected[] = { {0, 0, 2}, {1, 2, 3} };
+    expect_tokens(patterns, 2, "abaab", expected, 2);
+}
+
+static void test_scanner_backtrack(void) {
+    // "aac" is not a prefix of any token: fall back to single "a" tokens, then an error byte
+    const char* patterns[] = { "a*b", "a" };
+    ScanToken expected[] = { {1, 0, 1}, {1, 1, 1}, {SCANNER_NO_RULE, 2, 1}, {0, 3, 2} };
+    expect_tokens(patterns, 2, "aacab", expected, 4);
+}
+
+static void test_scanner_empty_match_ignored(void) {
+    // "a*" accepts the empty string, which must never produce a zero-length token
+    const char* patterns[] = { "a*" };
+    ScanToken expected[] = { {0, 0, 2}, {SCANNER_NO_RULE, 2, 1}, {0, 3, 1} };
+    expect_tokens(patterns, 1, "aaxa", expected, 3);
+}
+
+static void test_scanner_linear_on_adversarial_input(void) {
+    // Naive backtracking re-reads the rest of the input for every "a": O(n^2)
+    enum { N = 4096 };
+    struct Arena* a = arena_create(1024 * 1024);
+    ASSERT_NOT_NULL(a);
+    const char* patterns[] = { "a*b", "a" };
+    LexDFA* dfa = lexdfa_build(patterns, 2, a);
+    ASSERT_NOT_NULL(dfa);
+
+    char* input = malloc(N);
+    memset(input, 'a', N);
+    Scanner sc;
+    ASSERT_TRUE(scanner_init(&sc, dfa, input, N, a));
+    ScanToken tok;
+    size_t count = 0;
+    while (scanner_next(&sc, &tok)) count++;
+    ASSERT_EQ_SIZE(N, count);
+    ASSERT_TRUE(sc.transitions <= 3 * (size_t)N);
+
+    free(input);
+    arena_free(a);
+}
+
+// --- Test Registration Function ---
+void register_scanner_tests(void) {
+    register_test("scanner_longest_match", test_scanner_longest_match);
+    register_test("scanner_rule_priority", test_scanner_rule_priority);
+    register_test("scanner_backtrack", test_scanner_backtrack);
+    register_test("scanner_empty_match_ignored", test_scanner_empty_match_ignored);
+    register_test("scanner_linear_on_adversarial_input", test_scanner_linear_on_adversarial_input);
+}
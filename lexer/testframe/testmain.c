@@ -10,17 +10,38 @@
 #include "../src/lexer.h"
 #include "../src/lexer.c"
 
+#include "../src/nfa.h"
+#include "../src/nfa.c"
+
+#include "../src/parser.h"
+#include "../src/parser.c"
+
+#include "../src/scanner.h"
+#include "../src/scanner.c"
+
+#include "../src/line_index.h"
+#include "../src/line_index.c"
+
+#include "../src/relexer.h"
+#include "../src/relexer.c"
+
 // --- Test Framework & Tests ---
 // Include the framework's implementation
 #include "tiny_test_framework.h" // Include framework header first
 #include "tiny_test_framework.c" // Include framework implementation
 #include "test_arena.c"
 #include "test_lexer.c"
+#include "test_scanner.c"
+#include "test_line_index.c"
+#include "test_relexer.c"
 
 int main() {
     printf("Registering tests...\n");
     register_arena_tests();
     register_lexer_tests();
+    register_scanner_tests();
+    register_line_index_tests();
+    register_relexer_tests();
     printf("Test registration complete.\n\n");
 
     int failures = run_all_tests();
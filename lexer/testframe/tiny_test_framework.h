@@ -86,5 +86,8 @@ extern int g_current_test_failed; // Defined in .c file
 // Declare functions that register tests for each module
 void register_arena_tests(void);
 void register_lexer_tests(void);
+void register_scanner_tests(void);
+void register_line_index_tests(void);
+void register_relexer_tests(void);
 
 #endif // TINY_TEST_FRAMEWORK_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#define UNITY_BUILD // 启用 Unity Build
+
+// 递归下降分析器生成工具：
+//   gen_parser <文法文件> <输出 .c 文件> <前缀> [ll1_parser.h 的包含路径]
+#include <stdio.h>
+#include <stdlib.h> 
+
+// Arena
+#include "src/arena.h"      
+#include "src/arena.c"
+
+#include "src/first_follow.h"
+#include "src/first_follow.c"
+
+#include "src/digraph.h"
+#include "src/digraph.c"
+
+#include "src/grammar.h"
+#include "src/grammar.c"
+
+#include "src/first_set.h"
+#include "src/first_set.c"
+
+#include "src/follow_set.h"
+#include "src/follow_set.c"
+
+#include "src/table_compress.h"
+#include "src/table_compress.c"
+
+#include "src/parse_table.h"
+#include "src/parse_table.c"
+
+#include "src/rd_codegen.h"
+#include "src/rd_codegen.c"
+
+int main(int argc, char** argv){
+    if(argc < 4){
+        fprintf(stderr, "Usage: %s <grammar> <output.c> <prefix> [ll1_parser.h path]\n", argv[0]);
+        return 1;
+    }
+    const char* header = argc > 4 ? argv[4] : "ll1_parser.h";
+    struct Arena* arena = arena_create(16 * 1024 * 1024);
+    if(!arena) return 1;
+
+    GrammarResultGrammar result = read_grammar(argv[1], arena);
+    if (result.status != GRAMMAR_OK) {
+        fprintf(stderr, "Error: Failed to read grammar from file. Status code: %d\n", result.status);
+        arena_free(arena);
+        return 1;
+    }
+    Grammar* grammar = result.value;
+
+    SymbolSet* sets = arena_alloc(arena, (grammar->nonterminals_count + 1) * sizeof(SymbolSet));
+    ParseTable table;
+    int set_count = 0;
+    if(!sets){
+        arena_free(arena);
+        return 1;
+    }
+    compute_first_sets(grammar, sets, &set_count, arena);
+    compute_follow_sets(grammar, sets, &set_count, arena);
+    if(!build_parse_table(grammar, sets, &table, arena)){
+        arena_free(arena);
+        return 1;
+    }
+    if(table.conflict_count) print_table_conflicts(grammar, &table);
+
+    FILE* out = fopen(argv[2], "w");
+    if(!out){
+        fprintf(stderr, "Error: Failed to open %s.\n", argv[2]);
+        arena_free(arena);
+        return 1;
+    }
+    bool ok = generate_rd_parser(grammar, &table, argv[3], header, out);
+    fclose(out);
+    arena_free(arena);
+    return ok ? 0 : 1;
+}
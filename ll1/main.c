@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h> 
+#include <string.h>
 
 // Arena
 #include "src/arena.h"      
@@ -10,6 +11,9 @@
 #include "src/first_follow.h"
 #include "src/first_follow.c"
 
+#include "src/digraph.h"
+#include "src/digraph.c"
+
 #include "src/grammar.h"
 #include "src/grammar.c"
 
@@ -19,37 +23,132 @@
 #include "src/follow_set.h"
 #include "src/follow_set.c"
 
-int main(){
-    struct Arena* arena = arena_create(1024*10);
-    char filename[] = "grammar.txt";
+#include "src/grammar_reduce.h"
+#include "src/grammar_reduce.c"
+
+#include "src/table_compress.h"
+#include "src/table_compress.c"
+
+#include "src/parse_table.h"
+#include "src/parse_table.c"
+
+#include "src/grammar_cache.h"
+#include "src/grammar_cache.c"
+
+#include "src/ll1_cache.h"
+#include "src/ll1_cache.c"
 
+#define CACHE_PATH "grammar.ll1.cache"
+
+/// 读入文法并完整分析：可选的化简、First/Follow 集与预测分析表
+static bool analyze_grammar(const char* filename, bool reduce, Grammar** grammar_out, SymbolSet** sets_out,
+                            int* set_count, ParseTable* table, Arena* arena){
     GrammarResultGrammar result =  read_grammar(filename, arena);
     if (result.status != GRAMMAR_OK) {
         fprintf(stderr, "Error: Failed to read grammar from file. Status code: %d\n", result.status);
-        arena_free(arena);
-        return 1;
+        return false;
     }
-
     Grammar* grammar = result.value;
-    print_grammar(grammar);
+    if(reduce){
+        GrammarReduction reduction;
+        if(grammar_reduce(grammar, &reduction).status != GRAMMAR_OK) return false;
+        printf("---文法化简---\n");
+        print_grammar_reduction(grammar, &reduction);
+    }
 
-    SymbolSet* sets = arena_alloc(arena, GRAMMAR_MAX_SYMBOLS * sizeof(SymbolSet));
+    SymbolSet* sets = arena_alloc(arena, (grammar->nonterminals_count + 1) * sizeof(SymbolSet));
     if(!sets){
         fprintf(stderr, "Error: Failed to allocate memory for sets of symbolset.\n");
-        return 1; 
+        return false;
     }
+    compute_first_sets(grammar, sets, set_count, arena);
+    compute_follow_sets(grammar, sets, set_count, arena);
+    if(!build_parse_table(grammar, sets, table, arena)) return false;
+    *grammar_out = grammar;
+    *sets_out = sets;
+    return true;
+}
+
+static bool load_cached_analysis(const GrammarCache* cache, Grammar** grammar, SymbolSet** sets, int* set_count,
+                                 ParseTable* table, Arena* arena){
+    *grammar = grammar_cache_load_grammar(cache, arena);
+    if(!*grammar) return false;
+    *sets = cache_load_symbol_sets(cache, *grammar, set_count, arena);
+    return *sets && cache_load_parse_table(cache, *grammar, table);
+}
+
+static bool save_analysis(uint64_t key, const Grammar* grammar, const SymbolSet* sets, int set_count,
+                          const ParseTable* table, Arena* arena){
+    GrammarCacheWriter writer;
+    grammar_cache_writer_init(&writer);
+    return grammar_cache_put_grammar(&writer, grammar, arena) &&
+           cache_put_symbol_sets(&writer, grammar, sets, set_count, arena) &&
+           cache_put_parse_table(&writer, grammar, table, arena) &&
+           grammar_cache_write(CACHE_PATH, key, &writer);
+}
+
+// 用法：main [-r] [-n]，-r 表示分析前先化简文法，-n 表示不读写缓存。
+// 分析结果按文法内容的散列缓存在 grammar.ll1.cache 中，文法未变时直接映射缓存，不再重新分析
+int main(int argc, char** argv){
+    bool reduce = false, use_cache = true;
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-r") == 0) reduce = true;
+        else if(strcmp(argv[i], "-n") == 0) use_cache = false;
+        else{
+            fprintf(stderr, "Usage: %s [-r] [-n]\n", argv[0]);
+            return 1;
+        }
+    }
+    struct Arena* arena = arena_create(1024*1024);
+    char filename[] = "grammar.txt";
+
+    uint64_t key = 0;
+    use_cache = use_cache && grammar_cache_key(filename, reduce ? "ll1 -r" : "ll1", &key);
+    GrammarCache cache = {0};
+    Grammar* grammar = NULL;
+    SymbolSet* sets = NULL;
     int set_count = 0;
+    ParseTable table;
+    bool cached = use_cache && grammar_cache_open(CACHE_PATH, key, &cache);
+    if(cached && !load_cached_analysis(&cache, &grammar, &sets, &set_count, &table, arena)){
+        grammar_cache_close(&cache);
+        cached = false;
+    }
+    if(cached){
+        printf("---分析结果来自缓存 %s---\n", CACHE_PATH);
+    }else{
+        if(!analyze_grammar(filename, reduce, &grammar, &sets, &set_count, &table, arena)){
+            arena_free(arena);
+            return 1;
+        }
+        if(use_cache) save_analysis(key, grammar, sets, set_count, &table, arena);
+    }
+
+    print_grammar(grammar);
     printf("---非终结符的First集---\n");
-    compute_first_sets(grammar, sets, &set_count, arena);
     for(int i = 0; i < set_count; i++){
-        printf("First set[%c] : %s\n", sets[i].symbol, sets[i].first);
+        printf("First set[");
+        fprint_symbol(stdout, grammar, sets[i].symbol);
+        printf("] : ");
+        print_symbol_set(grammar, sets[i].first, sets[i].nullable);
+        printf("\n");
     }
     printf("---非终结符的Follow集---\n");
-    compute_follow_sets(grammar, sets, &set_count, arena);
     for(int i = 0; i < set_count; i++){
-        printf("Follow set[%c] : %s\n", sets[i].symbol, sets[i].follow);
+        printf("Follow set[");
+        fprint_symbol(stdout, grammar, sets[i].symbol);
+        printf("] : ");
+        print_symbol_set(grammar, sets[i].follow, false);
+        printf("\n");
+    }
+    printf("---LL(1)预测分析表---\n");
+    print_parse_table(grammar, &table);
+    if(table.conflict_count){
+        printf("文法不是 LL(1) 的，共 %u 处冲突：\n", table.conflict_count);
+        print_table_conflicts(grammar, &table);
     }
 
+    grammar_cache_close(&cache);
     arena_free(arena);
     return 0;
-}
\ No newline at end of file
+}
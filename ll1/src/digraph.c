@@ -0,0 +1,82 @@
+#include "digraph.h"
+#include "first_follow.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+/// 由边表 (from[i], to[i]) 经计数排序建立 CSR 形式的关系
+bool digraph_build(Digraph* graph, int node_count, const int* from, const int* to, int edge_count, Arena* arena){
+    graph->node_count = node_count;
+    graph->edge_count = edge_count;
+    graph->edge_start = arena_alloc(arena, (node_count + 1) * sizeof(int));
+    graph->targets = arena_alloc(arena, (edge_count ? edge_count : 1) * sizeof(int));
+    if(!graph->edge_start || !graph->targets){
+        fprintf(stderr, "Error: Failed to allocate memory for digraph.\n");
+        return false;
+    }
+    memset(graph->edge_start, 0, (node_count + 1) * sizeof(int));
+    for(int i = 0; i < edge_count; i++) graph->edge_start[from[i] + 1]++;
+    for(int x = 0; x < node_count; x++) graph->edge_start[x + 1] += graph->edge_start[x];
+    // 借用 edge_start[x] 作为写指针，填完后整体右移一格即恢复
+    for(int i = 0; i < edge_count; i++) graph->targets[graph->edge_start[from[i]]++] = to[i];
+    for(int x = node_count; x > 0; x--) graph->edge_start[x] = graph->edge_start[x - 1];
+    graph->edge_start[0] = 0;
+    return true;
+}
+
+typedef struct DigraphContext{
+    const Digraph* graph;
+    uint64_t* const* sets;
+    size_t words;
+    int* depth;     // 0 表示未访问，INT_MAX 表示所在强连通分量已完成
+    int* stack;
+    int top;
+} DigraphContext;
+
+// DeRemer–Pennello 的 traverse：Tarjan 强连通分量 + 沿关系合并集合，
+// 同一强连通分量中的结点最终得到相同的集合，每条边只合并一次
+static void traverse(DigraphContext* ctx, int x){
+    const Digraph* graph = ctx->graph;
+    ctx->stack[ctx->top++] = x;
+    int d = ctx->top;
+    ctx->depth[x] = d;
+
+    for(int e = graph->edge_start[x]; e < graph->edge_start[x + 1]; e++){
+        int y = graph->targets[e];
+        if(ctx->depth[y] == 0) traverse(ctx, y);
+        if(ctx->depth[y] < ctx->depth[x]) ctx->depth[x] = ctx->depth[y];
+        bitset_union(ctx->sets[x], ctx->sets[y], ctx->words);
+    }
+
+    if(ctx->depth[x] == d){
+        int y;
+        do{
+            y = ctx->stack[--ctx->top];
+            ctx->depth[y] = INT_MAX;
+            if(y != x) memcpy(ctx->sets[y], ctx->sets[x], ctx->words * sizeof(uint64_t));
+        }while(y != x);
+    }
+}
+
+/// 求解 F(x) = F'(x) ∪ { F(y) | x R y }；调用前 sets[x] 中为初值 F'(x)，返回时为结果 F(x)
+bool digraph_solve(const Digraph* graph, uint64_t* const* sets, size_t words, Arena* arena){
+    int n = graph->node_count;
+    DigraphContext ctx = {
+        .graph = graph,
+        .sets = sets,
+        .words = words,
+        .depth = arena_alloc(arena, (n ? n : 1) * sizeof(int)),
+        .stack = arena_alloc(arena, (n ? n : 1) * sizeof(int)),
+        .top = 0
+    };
+    if(!ctx.depth || !ctx.stack){
+        fprintf(stderr, "Error: Failed to allocate memory for digraph traversal.\n");
+        return false;
+    }
+    memset(ctx.depth, 0, n * sizeof(int));
+    for(int x = 0; x < n; x++){
+        if(ctx.depth[x] == 0) traverse(&ctx, x);
+    }
+    return true;
+}
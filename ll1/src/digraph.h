@@ -0,0 +1,20 @@
+#ifndef DIGRAPH_H
+#define DIGRAPH_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 以 CSR 形式保存的关系 R：结点 x 的后继为 targets[edge_start[x] .. edge_start[x+1])
+typedef struct Digraph{
+    int node_count;
+    int edge_count;
+    int* edge_start;
+    int* targets;
+} Digraph;
+
+bool digraph_build(Digraph* graph, int node_count, const int* from, const int* to, int edge_count, Arena* arena);
+bool digraph_solve(const Digraph* graph, uint64_t* const* sets, size_t words, Arena* arena);
+
+#endif
@@ -2,36 +2,72 @@
 #include "grammar.h"
 
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-SymbolSet* get_or_create_set(SymbolSet* sets, 
-                             int* count, 
-                             char symbol, 
-                             Arena* arena)
+/// 位集所需的 64 位字数：全部终结符加上结束符 '$'
+size_t symbol_set_words(const Grammar* grammar){
+    return (grammar->terminals_count + 1 + SYMBOL_SET_WORD_BITS - 1) / SYMBOL_SET_WORD_BITS;
+}
+
+int grammar_end_marker_id(const Grammar* grammar){
+    return grammar->terminals_count;
+}
+
+/// 按非终结符编号为每个非终结符建表，之后 sets[grammar_nonterminal_id(grammar, c)] 即为 c 的表
+bool init_symbol_sets(const Grammar* grammar,
+                      SymbolSet* sets,
+                      int* count,
+                      Arena* arena)
 {
-    // symbol对应的表如果存在就返回这个表
-    for(int i = 0; i < *count; i++){
-        if(sets[i].symbol == symbol) return &sets[i];
-    }
-    // symbol对应的表不存在，则创建新表
-    SymbolSet* set = &sets[(*count)++];
-    set->symbol = symbol;
-    set->first = arena_alloc(arena, GRAMMAR_MAX_SYMBOLS);
-    set->follow = arena_alloc(arena, GRAMMAR_MAX_SYMBOLS);
-    if(!set->first || !set->follow){
-        fprintf(stderr, "Error: Failed to allocate memory for First or Follow.\n");
-        return NULL; 
+    size_t words = symbol_set_words(grammar);
+    for(uint32_t i = 0; i < grammar->nonterminals_count; i++){
+        SymbolSet* set = &sets[i];
+        set->symbol = grammar->nonterminals[i];
+        set->first = arena_alloc(arena, words * sizeof(uint64_t));
+        set->follow = arena_alloc(arena, words * sizeof(uint64_t));
+        if(!set->first || !set->follow){
+            fprintf(stderr, "Error: Failed to allocate memory for First or Follow.\n");
+            return false;
+        }
+        memset(set->first, 0, words * sizeof(uint64_t));
+        memset(set->follow, 0, words * sizeof(uint64_t));
+        set->nullable = false;
     }
-    set->first[0] = '\0';
-    set->follow[0] = '\0';
-    return set;
+    *count = (int)grammar->nonterminals_count;
+    return true;
 }
 
-bool add_char(char* set, char c){
-    if(strchr(set, c)) return false;
-    int len = strlen(set);
-    set[len] = c;
-    set[len+1] = '\0';
-    return true;
+/// 按终结符编号顺序把集合写成字符串，nullable 时先写 '#'，结束符 '$' 放在最后。
+/// 单字符符号紧挨着写，多字符符号之间用空格隔开；返回值与 snprintf 相同，为完整写出所需的长度
+size_t format_symbol_set(const Grammar* grammar, const uint64_t* set, bool nullable, char* out, size_t out_size){
+    size_t len = 0;
+    bool prev_long = false;
+    if(out_size) out[0] = '\0';
+    if(nullable) len += (size_t)snprintf(out, out_size, "#");
+    for(uint32_t i = 0; i <= grammar->terminals_count; i++){
+        if(!bitset_contains(set, (int)i)) continue;
+        const char* name = i < grammar->terminals_count ? grammar_symbol_name(grammar, grammar->terminals[i]) : "$";
+        bool is_long = name[1] != '\0';
+        size_t room = len < out_size ? out_size - len : 0;
+        if(len > 0 && (is_long || prev_long)) len += (size_t)snprintf(room ? out + len : NULL, room, " %s", name);
+        else len += (size_t)snprintf(room ? out + len : NULL, room, "%s", name);
+        prev_long = is_long;
+    }
+    return len;
 }
 
+void print_symbol_set(const Grammar* grammar, const uint64_t* set, bool nullable){
+    char buffer[256];
+    size_t len = format_symbol_set(grammar, set, nullable, buffer, sizeof(buffer));
+    if(len < sizeof(buffer)){
+        printf("%s", buffer);
+        return;
+    }
+    char* large = malloc(len + 1);
+    if(!large) return;
+    format_symbol_set(grammar, set, nullable, large, len + 1);
+    printf("%s", large);
+    free(large);
+}
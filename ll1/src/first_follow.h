@@ -2,17 +2,51 @@
 #define FIRST_FOLLOW_H
 
 #include "arena.h"
+#include "grammar.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
+#define SYMBOL_SET_WORD_BITS 64
 
+// sets[i] 对应编号为 i 的非终结符（即 grammar->nonterminals[i]）。
+// First/Follow 集用定长位集表示，第 i 位对应编号为 i 的终结符（即 grammar->terminals[i]），
+// 编号 grammar->terminals_count 留给输入结束符 '$'。空串 '#' 不占位，单独记在 nullable 中
 typedef struct SymbolSet{
-    char symbol;
-    char* first;
-    char* follow;
+    SymbolId symbol;
+    uint64_t* first;
+    uint64_t* follow;
+    bool nullable;
 } SymbolSet;
 
-SymbolSet* get_or_create_set(SymbolSet* sets, int* count, char symbol, Arena* arena);
-bool add_char(char* set, char c);
+size_t symbol_set_words(const Grammar* grammar);
+int grammar_end_marker_id(const Grammar* grammar);
 
+bool init_symbol_sets(const Grammar* grammar, SymbolSet* sets, int* count, Arena* arena);
+size_t format_symbol_set(const Grammar* grammar, const uint64_t* set, bool nullable, char* out, size_t out_size);
+void print_symbol_set(const Grammar* grammar, const uint64_t* set, bool nullable);
 
-#endif
\ No newline at end of file
+/// 置位，返回该位原先是否为 0
+static inline bool bitset_add(uint64_t* set, int id){
+    uint64_t mask = 1ULL << (id % SYMBOL_SET_WORD_BITS);
+    uint64_t* word = &set[id / SYMBOL_SET_WORD_BITS];
+    if(*word & mask) return false;
+    *word |= mask;
+    return true;
+}
+
+static inline bool bitset_contains(const uint64_t* set, int id){
+    return (set[id / SYMBOL_SET_WORD_BITS] >> (id % SYMBOL_SET_WORD_BITS)) & 1;
+}
+
+/// 按字并集 dst |= src，返回 dst 是否发生变化
+static inline bool bitset_union(uint64_t* dst, const uint64_t* src, size_t words){
+    uint64_t added = 0;
+    for(size_t i = 0; i < words; i++){
+        added |= src[i] & ~dst[i];
+        dst[i] |= src[i];
+    }
+    return added != 0;
+}
+
+#endif
@@ -1,60 +1,105 @@
 #include "first_set.h"
+#include "digraph.h"
 
-static void process_right_symbol_first(char* rhs, 
-                                       SymbolSet* lhs_set, 
-                                       SymbolSet* sets, 
-                                       int* set_count, 
-                                       bool* changed, 
-                                       Arena* arena)
+/// 预先求出所有可空的非终结符（工作表算法，线性于文法大小）。
+/// remaining[r] 为产生式 r 右部尚未确认可空的非终结符出现次数，含终结符的产生式永远不可空
+static bool compute_nullable(Grammar* grammar, SymbolSet* sets, int set_count, Arena* arena)
 {
-    bool epsilon_in_rhs = true;
-
-    for(size_t j = 0; rhs[j]; j++){
-        char symbol = rhs[j];
-        if(isspace(symbol)) continue;
-
-        if(grammar_is_terminal(symbol) || symbol == '#'){
-            if(add_char(lhs_set->first, symbol)) *changed = true;
-            epsilon_in_rhs = (symbol == '#');
-            break;
-        }else{
-            SymbolSet* sym_set = get_or_create_set(sets, set_count, symbol, arena);
-            for(int k = 0; sym_set->first[k]; k++){
-                if(sym_set->first[k] != '#'){
-                    if(add_char(lhs_set->first, sym_set->first[k])) *changed = true;
-                }
-            }
-            if(!strchr(sym_set->first, '#')){
-                epsilon_in_rhs = false;
+    int total = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++) total += (int)grammar->rules[i].right_hs_count;
+
+    int* remaining = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(int));
+    int* occ_from = arena_alloc(arena, (total + 1) * sizeof(int));
+    int* occ_rule = arena_alloc(arena, (total + 1) * sizeof(int));
+    int* queue = arena_alloc(arena, (set_count + 1) * sizeof(int));
+    if(!remaining || !occ_from || !occ_rule || !queue){
+        fprintf(stderr, "Error: Failed to allocate memory for nullable computation.\n");
+        return false;
+    }
+
+    int occ_count = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++){
+        const Rule* rule = &grammar->rules[i];
+        remaining[i] = 0;
+        for(uint32_t j = 0; j < rule->right_hs_count; j++){
+            if(grammar_symbol_is_terminal(grammar, rule->right_hs[j])){
+                remaining[i] = -1;
                 break;
             }
+            remaining[i]++;
+        }
+        if(remaining[i] <= 0) continue;
+        for(uint32_t j = 0; j < rule->right_hs_count; j++){
+            occ_from[occ_count] = grammar_nonterminal_id(grammar, rule->right_hs[j]);
+            occ_rule[occ_count++] = (int)i;
         }
     }
-    
-    if(epsilon_in_rhs){
-        if(add_char(lhs_set->first, '#')) *changed = true;
+    // 按非终结符分组出现位置，复用 CSR 关系
+    Digraph occurrences;
+    if(!digraph_build(&occurrences, set_count, occ_from, occ_rule, occ_count, arena)) return false;
+
+    int head = 0, tail = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++){
+        SymbolSet* lhs = &sets[grammar_nonterminal_id(grammar, grammar->rules[i].left_hs)];
+        if(remaining[i] == 0 && !lhs->nullable){
+            lhs->nullable = true;
+            queue[tail++] = (int)(lhs - sets);
+        }
+    }
+    while(head < tail){
+        int x = queue[head++];
+        for(int e = occurrences.edge_start[x]; e < occurrences.edge_start[x + 1]; e++){
+            int r = occurrences.targets[e];
+            if(--remaining[r] != 0) continue;
+            SymbolSet* lhs = &sets[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs)];
+            if(!lhs->nullable){
+                lhs->nullable = true;
+                queue[tail++] = (int)(lhs - sets);
+            }
+        }
     }
+    return true;
 }
+
+/// First 集：A -> αXβ 且 α 可空时，X 为终结符则直接加入 First(A)，X 为非终结符则建立关系 A R X，
+/// 再用 digraph 算法沿关系按强连通分量一次性传播
 void compute_first_sets(Grammar* grammar, 
                         SymbolSet* sets, 
                         int* set_count, 
                         Arena* arena)
 {
-    bool changed;
-    do{
-        changed = false;
-        for(int i = 0; i < grammar->rule_count; i++){
-            Rule* rule = &grammar->rules[i];
-            SymbolSet* left_symbol_set = get_or_create_set(sets, 
-                                                           set_count, 
-                                                           rule->left_hs, 
-                                                           arena);
-            process_right_symbol_first(rule->right_hs, 
-                                       left_symbol_set, 
-                                       sets, 
-                                       set_count, 
-                                       &changed, 
-                                       arena);
+    if(!init_symbol_sets(grammar, sets, set_count, arena)) return;
+    if(!compute_nullable(grammar, sets, *set_count, arena)) return;
+
+    int total = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++) total += (int)grammar->rules[i].right_hs_count;
+    int* from = arena_alloc(arena, (total + 1) * sizeof(int));
+    int* to = arena_alloc(arena, (total + 1) * sizeof(int));
+    uint64_t** first = arena_alloc(arena, (*set_count + 1) * sizeof(uint64_t*));
+    if(!from || !to || !first){
+        fprintf(stderr, "Error: Failed to allocate memory for First relation.\n");
+        return;
+    }
+
+    int edge_count = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++){
+        Rule* rule = &grammar->rules[i];
+        int lhs = grammar_nonterminal_id(grammar, rule->left_hs);
+        for(uint32_t j = 0; j < rule->right_hs_count; j++){
+            SymbolId sym = rule->right_hs[j];
+            if(grammar_symbol_is_terminal(grammar, sym)){
+                bitset_add(sets[lhs].first, grammar_terminal_id(grammar, sym));
+                break;
+            }
+            int x = grammar_nonterminal_id(grammar, sym);
+            from[edge_count] = lhs;
+            to[edge_count++] = x;
+            if(!sets[x].nullable) break;
         }
-    }while (changed);
-}
\ No newline at end of file
+    }
+
+    Digraph relation;
+    if(!digraph_build(&relation, *set_count, from, to, edge_count, arena)) return;
+    for(int i = 0; i < *set_count; i++) first[i] = sets[i].first;
+    digraph_solve(&relation, first, symbol_set_words(grammar), arena);
+}
@@ -1,62 +1,62 @@
 #include "follow_set.h"
-static void propagate_follow(Grammar* grammar, 
-                             SymbolSet* sets, 
-                             int* set_count, 
-                             bool* changed,
-                             Arena* arena)
+#include "digraph.h"
+
+/// Follow 集：A -> αBβ 时 First(β) 直接加入 Follow(B)；β 可空时建立关系 B R A（Follow(B) 包含 Follow(A)），
+/// 再用 digraph 算法沿关系按强连通分量一次性传播。调用前须已求出 First 集与 nullable
+void compute_follow_sets(Grammar* grammar, 
+                         SymbolSet* sets, 
+                         int* set_count, 
+                         Arena* arena)
 {
-    for(int i = 0; i < grammar->rule_count; i++){
-        Rule* rule = &grammar->rules[i];
-        size_t len_rule = strlen(rule->right_hs);
+    if(grammar->rule_count == 0) return;
+    SymbolSet* start = &sets[grammar_nonterminal_id(grammar, grammar->start_symbol)];
+    bitset_add(start->follow, grammar_end_marker_id(grammar));
+    size_t words = symbol_set_words(grammar);
+
+    int total = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++) total += (int)grammar->rules[i].right_hs_count;
+    int* from = arena_alloc(arena, (total + 1) * sizeof(int));
+    int* to = arena_alloc(arena, (total + 1) * sizeof(int));
+    uint64_t** follow = arena_alloc(arena, (*set_count + 1) * sizeof(uint64_t*));
+    if(!from || !to || !follow){
+        fprintf(stderr, "Error: Failed to allocate memory for Follow relation.\n");
+        return;
+    }
 
-        for(size_t j = 0; j < len_rule; j++){
-            char B = rule->right_hs[j];
-            if(!grammar_is_nonterminal(B)) continue;
-            SymbolSet* B_set = get_or_create_set(sets, set_count, B, arena);
+    int edge_count = 0;
+    for(uint32_t i = 0; i < grammar->rule_count; i++){
+        Rule* rule = &grammar->rules[i];
+        for(uint32_t j = 0; j < rule->right_hs_count; j++){
+            SymbolId B = rule->right_hs[j];
+            if(grammar_symbol_is_terminal(grammar, B)) continue;
+            SymbolSet* B_set = &sets[grammar_nonterminal_id(grammar, B)];
 
-            bool epsilon_chain = true; // epsilon 闭包运输
-            for(size_t k = j+1; k < len_rule; k++){
-                char next_sym = rule->right_hs[k];
+            bool epsilon_chain = true;
+            for(uint32_t k = j+1; k < rule->right_hs_count; k++){
+                SymbolId next_sym = rule->right_hs[k];
                 //非终结符B后紧跟着终结符，就将其加入到B的follow集
-                if(grammar_is_terminal(next_sym)){
-                    if(add_char(B_set->follow, next_sym)) *changed = true;
+                if(grammar_symbol_is_terminal(grammar, next_sym)){
+                    bitset_add(B_set->follow, grammar_terminal_id(grammar, next_sym));
                     epsilon_chain = false;
                     break;
                 }
-                //B后可能跟着非终结符，将该终结符first集/epsilon的符合加入到B的follow集
-                SymbolSet* next_sym_set = get_or_create_set(sets, set_count, next_sym, arena);
-                for(size_t m = 0; next_sym_set->first[m]; m++){
-                    if(next_sym_set->first[m] != '#'){
-                        if(add_char(B_set->follow, next_sym_set->first[m])) *changed = true;
-                    }
-                }
-                //B后面字符first集没有空串，就不需要做闭包运算
-                if(!strchr(next_sym_set->first, '#')){
+                //B后跟着非终结符，将其first集（不含空串）加入到B的follow集，不可空时停止
+                SymbolSet* next_sym_set = &sets[grammar_nonterminal_id(grammar, next_sym)];
+                bitset_union(B_set->follow, next_sym_set->first, words);
+                if(!next_sym_set->nullable){
                     epsilon_chain = false;
                     break;
                 }
             }
-            //闭包运算
             if(epsilon_chain){
-                SymbolSet* A_set = get_or_create_set(sets, set_count, rule->left_hs, arena);
-                for(size_t n = 0; A_set->follow[n]; n++){
-                    if(add_char(B_set->follow, A_set->follow[n])) *changed = true;
-                }
+                from[edge_count] = grammar_nonterminal_id(grammar, B);
+                to[edge_count++] = grammar_nonterminal_id(grammar, rule->left_hs);
             }
         }
     }
-}
 
-void compute_follow_sets(Grammar* grammar, 
-                         SymbolSet* sets, 
-                         int* set_count, 
-                         Arena* arena)
-{
-    SymbolSet* start = get_or_create_set(sets, set_count, 'S', arena);
-    add_char(start->follow, '$');
-    bool changed;
-    do{
-        changed = false;
-        propagate_follow(grammar, sets, set_count, &changed, arena);
-    }while(changed);
+    Digraph relation;
+    if(!digraph_build(&relation, *set_count, from, to, edge_count, arena)) return;
+    for(int i = 0; i < *set_count; i++) follow[i] = sets[i].follow;
+    digraph_solve(&relation, follow, words, arena);
 }
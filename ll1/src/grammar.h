@@ -3,12 +3,12 @@
 
 #include "arena.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 
-#define GRAMMAR_MAX_SYMBOLS 64
-#define GRAMMAR_MAX_RULES 128
-#define GRAMMAR_MAX_LINE_LEN 256
+#define GRAMMAR_NO_SYMBOL (-1)
 
 #ifdef DEBUG_GRAMMAR
 #define GRAMMAR_DEBUG(fmt, ...) fprintf(stderr, "[GRAMMAR DEBUG] " fmt "\n", ##__VA_ARGS__)
@@ -16,21 +16,45 @@
 #define GRAMMAR_DEBUG(fmt, ...) ((void)0)
 #endif
 
+// 文法符号的写法：
+//   单个字符：大写字母为非终结符，其余为终结符（与旧格式兼容，空白被忽略，"AB" 即两个符号）
+//   <Name>     ：任意名字的非终结符
+//   'name' 或 "name"：任意名字的终结符
+//   #          ：空串，不作为符号保存，空产生式的右部长度为 0
+// 同名符号只保存一份，用 32 位编号引用
+typedef int32_t SymbolId;
+
+typedef struct Symbol
+{
+    const char* name;   //以 '\0' 结尾，存放在 arena 中
+    uint32_t length;
+    bool terminal;
+    int32_t index;      //在 terminals 或 nonterminals 中的下标
+} Symbol;
+
 typedef struct Rule
 {
-    char left_hs;   //产生式左边的非终结符
-    char* right_hs; //产生式右边的串，包括终结符与非终结符
-    uint8_t right_hs_count;
+    SymbolId left_hs;    //产生式左边的非终结符
+    SymbolId* right_hs;  //产生式右边的符号串，包括终结符与非终结符
+    uint32_t right_hs_count;
 } Rule;
 
 typedef struct Grammar
 {
     Rule* rules;
-    uint8_t rule_count;
-    char nonterminals[GRAMMAR_MAX_SYMBOLS];
-    uint8_t nonterminals_count;
-    char terminals[GRAMMAR_MAX_SYMBOLS];
-    uint8_t terminals_count;
+    uint32_t rule_count;
+    uint32_t rule_capacity;
+    SymbolId start_symbol;  //开始符号：第一条产生式的左部
+    Symbol* symbols;
+    uint32_t symbol_count;
+    uint32_t symbol_capacity;
+    SymbolId* nonterminals;
+    uint32_t nonterminals_count;
+    SymbolId* terminals;
+    uint32_t terminals_count;
+    SymbolId* symbol_table;        //按名字散列的开放寻址表，空位为 GRAMMAR_NO_SYMBOL
+    uint32_t symbol_table_capacity; //2 的幂
+    Arena* arena;
 } Grammar;
 
 // ==== 错误码 ====
@@ -42,20 +66,23 @@ typedef enum {
     GRAMMAR_ERROR_ALLOCATION_FAILED,
     GRAMMAR_ERROR_IO_FAILED,
     GRAMMAR_ERROR_TOO_MANY_RULES,
-    GRAMMAR_ERROR_TOO_MANY_SYMBOLS
+    GRAMMAR_ERROR_TOO_MANY_SYMBOLS,
+    GRAMMAR_ERROR_SYMBOL_CONFLICT
 } GrammarStatus;
 
-/// 用于返回 Grammar*
+/// 用于返回 Grammar*；解析出错时 line/column 为第一个错误的位置（从 1 开始），其余情况为 0
 typedef struct GrammarResultGrammar{
     GrammarStatus status;
     Grammar* value;
+    uint32_t line;
+    uint32_t column;
 } GrammarResultGrammar;
 
-/// 用于返回 char
-typedef struct GrammarResultChar{
+/// 用于返回符号编号
+typedef struct GrammarResultSymbol{
     GrammarStatus status;
-    char value;
-} GrammarResultChar;
+    SymbolId value;
+} GrammarResultSymbol;
 
 /// 用于返回字符串
 typedef struct GrammarResultString{
@@ -71,7 +98,36 @@ typedef struct GrammarResultVoid{
 bool grammar_is_terminal(char c);
 bool grammar_is_nonterminal(char c);
 
+GrammarResultSymbol grammar_intern_symbol(Grammar* grammar, const char* name, size_t length, bool terminal);
+SymbolId grammar_lookup_symbol(const Grammar* grammar, const char* name, size_t length);
+
+static inline const char* grammar_symbol_name(const Grammar* grammar, SymbolId symbol){
+    return grammar->symbols[symbol].name;
+}
+
+static inline bool grammar_symbol_is_terminal(const Grammar* grammar, SymbolId symbol){
+    return grammar->symbols[symbol].terminal;
+}
+
+/// 符号在非终结符/终结符中的稠密编号，类别不符时为 -1
+static inline int grammar_nonterminal_id(const Grammar* grammar, SymbolId symbol){
+    return grammar->symbols[symbol].terminal ? -1 : grammar->symbols[symbol].index;
+}
+
+static inline int grammar_terminal_id(const Grammar* grammar, SymbolId symbol){
+    return grammar->symbols[symbol].terminal ? grammar->symbols[symbol].index : -1;
+}
+
+GrammarResultVoid grammar_append_rule(Grammar* grammar, SymbolId lhs, const SymbolId* rhs, uint32_t count);
+GrammarResultVoid grammar_remove_rule(Grammar* grammar, uint32_t index);
+
+// 解析内存中的文法文本（不要求以 '\0' 结尾），source 只用于出错信息
+GrammarResultGrammar parse_grammar(const char* text, size_t length, const char* source, Arena* arena);
 GrammarResultGrammar read_grammar(const char* filename, Arena* arena);
+size_t format_symbol(const Grammar* grammar, SymbolId symbol, char* out, size_t out_size);
+size_t format_rule_rhs(const Grammar* grammar, const Rule* rule, char* out, size_t out_size);
+void fprint_symbol(FILE* out, const Grammar* grammar, SymbolId symbol);
+void fprint_rule_rhs(FILE* out, const Grammar* grammar, const Rule* rule);
 void print_grammar(const Grammar* grammar);
-
-#endif
\ No newline at end of file
+void grammar_free(Grammar* grammar);
+#endif
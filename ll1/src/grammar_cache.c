@@ -0,0 +1,318 @@
+#include "grammar_cache.h"
+#include "grammar.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct CachedGrammarHeader{
+    uint32_t symbol_count;
+    uint32_t rule_count;
+    uint32_t nonterminals_count;
+    uint32_t terminals_count;
+    uint32_t symbol_table_capacity;
+    uint32_t rhs_total;
+    int32_t start_symbol;
+    uint32_t names_size;
+} CachedGrammarHeader;
+
+typedef struct CachedSymbol{
+    uint32_t name_offset;
+    uint32_t length;
+    int32_t index;
+    uint32_t terminal;
+} CachedSymbol;
+
+typedef struct CachedRule{
+    int32_t lhs;
+    uint32_t rhs_offset;
+    uint32_t rhs_count;
+} CachedRule;
+
+static uint64_t fnv1a64(uint64_t hash, const void* data, size_t size){
+    const unsigned char* p = data;
+    for(size_t i = 0; i < size; i++){
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// 私有映射整个文件（可写时为写时复制），空文件返回 size 为 0、base 为 NULL
+static bool map_file(const char* path, int prot, char** base, size_t* size){
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < 0){
+        close(fd);
+        return false;
+    }
+    *size = (size_t)st.st_size;
+    *base = NULL;
+    if(*size){
+        void* ptr = mmap(NULL, *size, prot, MAP_PRIVATE, fd, 0);
+        if(ptr == MAP_FAILED){
+            close(fd);
+            return false;
+        }
+        *base = ptr;
+    }
+    close(fd);
+    return true;
+}
+
+bool grammar_cache_key(const char* filename, const char* variant, uint64_t* key){
+    char* text;
+    size_t size;
+    if(!map_file(filename, PROT_READ, &text, &size)) return false;
+    uint64_t hash = fnv1a64(1469598103934665603ULL, text, size);
+    if(text) munmap(text, size);
+    uint32_t version = GRAMMAR_CACHE_VERSION;
+    hash = fnv1a64(hash, &version, sizeof(version));
+    if(variant) hash = fnv1a64(hash, variant, strlen(variant) + 1);
+    *key = hash;
+    return true;
+}
+
+void grammar_cache_writer_init(GrammarCacheWriter* writer){
+    memset(writer, 0, sizeof(GrammarCacheWriter));
+}
+
+bool grammar_cache_writer_add(GrammarCacheWriter* writer, GrammarCacheTag tag, const void* data, size_t size){
+    if(writer->section_count >= GRAMMAR_CACHE_MAX_SECTIONS) return false;
+    writer->sections[writer->section_count] = (CacheSection){ .tag = tag, .size = size };
+    writer->data[writer->section_count++] = data;
+    return true;
+}
+
+bool grammar_cache_write(const char* path, uint64_t key, const GrammarCacheWriter* writer){
+    char tmp[1024];
+    if(snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid()) >= (int)sizeof(tmp)) return false;
+
+    CacheSection sections[GRAMMAR_CACHE_MAX_SECTIONS];
+    uint64_t offset = cache_align(sizeof(GrammarCacheHeader) + writer->section_count * sizeof(CacheSection));
+    for(uint32_t i = 0; i < writer->section_count; i++){
+        sections[i] = writer->sections[i];
+        sections[i].offset = offset;
+        offset += cache_align(sections[i].size);
+    }
+    GrammarCacheHeader header = { GRAMMAR_CACHE_MAGIC, GRAMMAR_CACHE_VERSION, writer->section_count, key, offset };
+
+    FILE* file = fopen(tmp, "wb");
+    if(!file){
+        fprintf(stderr, "Warning: Failed to create cache file %s.\n", tmp);
+        return false;
+    }
+    static const char padding[8];
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(sections, sizeof(CacheSection), writer->section_count, file) == writer->section_count;
+    uint64_t position = sizeof(header) + writer->section_count * sizeof(CacheSection);
+    for(uint32_t i = 0; ok && i < writer->section_count; i++){
+        size_t pad = (size_t)(sections[i].offset - position);
+        ok = fwrite(padding, 1, pad, file) == pad &&
+             fwrite(writer->data[i], 1, sections[i].size, file) == sections[i].size;
+        position = sections[i].offset + sections[i].size;
+    }
+    size_t tail = (size_t)(offset - position);
+    ok = ok && fwrite(padding, 1, tail, file) == tail;
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(tmp, path) != 0){
+        fprintf(stderr, "Warning: Failed to write cache file %s.\n", path);
+        remove(tmp);
+        return false;
+    }
+    return true;
+}
+
+bool grammar_cache_open(const char* path, uint64_t key, GrammarCache* cache){
+    memset(cache, 0, sizeof(GrammarCache));
+    char* base;
+    size_t size;
+    if(!map_file(path, PROT_READ | PROT_WRITE, &base, &size)) return false;
+    const GrammarCacheHeader* header = (const GrammarCacheHeader*)base;
+    bool ok = size >= sizeof(GrammarCacheHeader) && header->magic == GRAMMAR_CACHE_MAGIC &&
+              header->version == GRAMMAR_CACHE_VERSION && header->key == key && header->file_size == size &&
+              header->section_count <= GRAMMAR_CACHE_MAX_SECTIONS &&
+              sizeof(GrammarCacheHeader) + header->section_count * sizeof(CacheSection) <= size;
+    const CacheSection* sections = (const CacheSection*)(base + sizeof(GrammarCacheHeader));
+    for(uint32_t i = 0; ok && i < header->section_count; i++){
+        ok = sections[i].offset % 8 == 0 && sections[i].offset <= size && sections[i].size <= size - sections[i].offset;
+    }
+    if(!ok){
+        if(base) munmap(base, size);
+        return false;
+    }
+    cache->base = base;
+    cache->size = size;
+    cache->sections = sections;
+    cache->section_count = header->section_count;
+    return true;
+}
+
+const void* grammar_cache_section(const GrammarCache* cache, GrammarCacheTag tag, size_t* size){
+    for(uint32_t i = 0; i < cache->section_count; i++){
+        if(cache->sections[i].tag != (uint32_t)tag) continue;
+        *size = (size_t)cache->sections[i].size;
+        return cache->base + cache->sections[i].offset;
+    }
+    return NULL;
+}
+
+void grammar_cache_close(GrammarCache* cache){
+    if(cache->base) munmap(cache->base, cache->size);
+    memset(cache, 0, sizeof(GrammarCache));
+}
+
+/// 文法段的各数组，写入与读取按同一顺序划分
+typedef struct CachedGrammarLayout{
+    CachedGrammarHeader* header;
+    CachedSymbol* symbols;
+    CachedRule* rules;
+    SymbolId* rhs;
+    SymbolId* nonterminals;
+    SymbolId* terminals;
+    SymbolId* symbol_table;
+    char* names;
+} CachedGrammarLayout;
+
+static bool cached_grammar_layout(CacheCursor* cursor, const CachedGrammarHeader* header, CachedGrammarLayout* layout){
+    layout->symbols = cache_cursor_take(cursor, header->symbol_count * sizeof(CachedSymbol));
+    layout->rules = cache_cursor_take(cursor, header->rule_count * sizeof(CachedRule));
+    layout->rhs = cache_cursor_take(cursor, header->rhs_total * sizeof(SymbolId));
+    layout->nonterminals = cache_cursor_take(cursor, header->nonterminals_count * sizeof(SymbolId));
+    layout->terminals = cache_cursor_take(cursor, header->terminals_count * sizeof(SymbolId));
+    layout->symbol_table = cache_cursor_take(cursor, header->symbol_table_capacity * sizeof(SymbolId));
+    layout->names = cache_cursor_take(cursor, header->names_size);
+    return layout->symbols && layout->rules && layout->rhs && layout->nonterminals && layout->terminals &&
+           layout->symbol_table && layout->names;
+}
+
+bool grammar_cache_put_grammar(GrammarCacheWriter* writer, const Grammar* grammar, Arena* arena){
+    CachedGrammarHeader header = {
+        .symbol_count = grammar->symbol_count,
+        .rule_count = grammar->rule_count,
+        .nonterminals_count = grammar->nonterminals_count,
+        .terminals_count = grammar->terminals_count,
+        .symbol_table_capacity = grammar->symbol_table_capacity,
+        .start_symbol = grammar->start_symbol,
+    };
+    for(uint32_t r = 0; r < grammar->rule_count; r++) header.rhs_total += grammar->rules[r].right_hs_count;
+    for(uint32_t s = 0; s < grammar->symbol_count; s++) header.names_size += grammar->symbols[s].length + 1;
+
+    size_t size = cache_align(sizeof(CachedGrammarHeader)) + cache_align(header.symbol_count * sizeof(CachedSymbol)) +
+                  cache_align(header.rule_count * sizeof(CachedRule)) + cache_align(header.rhs_total * sizeof(SymbolId)) +
+                  cache_align(header.nonterminals_count * sizeof(SymbolId)) +
+                  cache_align(header.terminals_count * sizeof(SymbolId)) +
+                  cache_align(header.symbol_table_capacity * sizeof(SymbolId)) + cache_align(header.names_size);
+    char* data = arena_alloc(arena, size);
+    if(!data){
+        fprintf(stderr, "Error: Failed to allocate memory for the grammar cache.\n");
+        return false;
+    }
+    memset(data, 0, size);
+    CacheCursor cursor = { data, 0, size };
+    CachedGrammarLayout layout;
+    layout.header = cache_cursor_take(&cursor, sizeof(CachedGrammarHeader));
+    *layout.header = header;
+    cached_grammar_layout(&cursor, &header, &layout);
+
+    uint32_t name_offset = 0;
+    for(uint32_t s = 0; s < grammar->symbol_count; s++){
+        const Symbol* symbol = &grammar->symbols[s];
+        layout.symbols[s] = (CachedSymbol){ name_offset, symbol->length, symbol->index, symbol->terminal };
+        memcpy(layout.names + name_offset, symbol->name, symbol->length + 1);
+        name_offset += symbol->length + 1;
+    }
+    uint32_t rhs_offset = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        layout.rules[r] = (CachedRule){ rule->left_hs, rhs_offset, rule->right_hs_count };
+        if(rule->right_hs_count) memcpy(layout.rhs + rhs_offset, rule->right_hs, rule->right_hs_count * sizeof(SymbolId));
+        rhs_offset += rule->right_hs_count;
+    }
+    memcpy(layout.nonterminals, grammar->nonterminals, header.nonterminals_count * sizeof(SymbolId));
+    memcpy(layout.terminals, grammar->terminals, header.terminals_count * sizeof(SymbolId));
+    memcpy(layout.symbol_table, grammar->symbol_table, header.symbol_table_capacity * sizeof(SymbolId));
+    return grammar_cache_writer_add(writer, CACHE_SECTION_GRAMMAR, data, size);
+}
+
+static bool symbol_valid(const CachedGrammarHeader* header, SymbolId id){
+    return id >= 0 && (uint32_t)id < header->symbol_count;
+}
+
+Grammar* grammar_cache_load_grammar(const GrammarCache* cache, Arena* arena){
+    size_t size;
+    char* data = (char*)grammar_cache_section(cache, CACHE_SECTION_GRAMMAR, &size);
+    if(!data) return NULL;
+    CacheCursor cursor = { data, 0, size };
+    CachedGrammarLayout layout;
+    layout.header = cache_cursor_take(&cursor, sizeof(CachedGrammarHeader));
+    if(!layout.header || !cached_grammar_layout(&cursor, layout.header, &layout)) return NULL;
+    const CachedGrammarHeader* header = layout.header;
+    uint32_t capacity = header->symbol_table_capacity;
+    if(capacity == 0 || (capacity & (capacity - 1)) != 0 || header->symbol_count > capacity / 2 ||
+       (header->start_symbol != GRAMMAR_NO_SYMBOL && !symbol_valid(header, header->start_symbol))){
+        return NULL;
+    }
+
+    Grammar* grammar = arena_alloc(arena, sizeof(Grammar));
+    Symbol* symbols = arena_alloc(arena, (header->symbol_count + 1) * sizeof(Symbol));
+    Rule* rules = arena_alloc(arena, (header->rule_count + 1) * sizeof(Rule));
+    if(!grammar || !symbols || !rules){
+        fprintf(stderr, "Error: Failed to allocate memory for the cached grammar.\n");
+        return NULL;
+    }
+    // 下标越界或名字不以 '\0' 结尾说明文件已损坏，放弃缓存
+    for(uint32_t s = 0; s < header->symbol_count; s++){
+        const CachedSymbol* cached = &layout.symbols[s];
+        if(cached->name_offset >= header->names_size || cached->length >= header->names_size - cached->name_offset ||
+           layout.names[cached->name_offset + cached->length] != '\0'){
+            return NULL;
+        }
+        uint32_t class_count = cached->terminal ? header->terminals_count : header->nonterminals_count;
+        if(cached->index != -1 && (cached->index < 0 || (uint32_t)cached->index >= class_count)) return NULL;
+        symbols[s] = (Symbol){ layout.names + cached->name_offset, cached->length, cached->terminal != 0, cached->index };
+    }
+    for(uint32_t r = 0; r < header->rule_count; r++){
+        const CachedRule* cached = &layout.rules[r];
+        if(!symbol_valid(header, cached->lhs) || symbols[cached->lhs].terminal || cached->rhs_offset > header->rhs_total ||
+           cached->rhs_count > header->rhs_total - cached->rhs_offset){
+            return NULL;
+        }
+        rules[r] = (Rule){ cached->lhs, layout.rhs + cached->rhs_offset, cached->rhs_count };
+    }
+    for(uint32_t i = 0; i < header->rhs_total; i++){
+        if(!symbol_valid(header, layout.rhs[i])) return NULL;
+    }
+    for(uint32_t i = 0; i < header->nonterminals_count; i++){
+        if(!symbol_valid(header, layout.nonterminals[i]) || symbols[layout.nonterminals[i]].terminal) return NULL;
+    }
+    for(uint32_t i = 0; i < header->terminals_count; i++){
+        if(!symbol_valid(header, layout.terminals[i]) || !symbols[layout.terminals[i]].terminal) return NULL;
+    }
+    for(uint32_t i = 0; i < capacity; i++){
+        if(layout.symbol_table[i] != GRAMMAR_NO_SYMBOL && !symbol_valid(header, layout.symbol_table[i])) return NULL;
+    }
+
+    // 容量等于当前个数：之后登记新符号或追加产生式时会先在 arena 中扩容，不会写出映射的范围
+    memset(grammar, 0, sizeof(Grammar));
+    grammar->rules = rules;
+    grammar->rule_count = header->rule_count;
+    grammar->rule_capacity = header->rule_count + 1;
+    grammar->start_symbol = header->start_symbol;
+    grammar->symbols = symbols;
+    grammar->symbol_count = header->symbol_count;
+    grammar->symbol_capacity = header->symbol_count;
+    grammar->nonterminals = layout.nonterminals;
+    grammar->nonterminals_count = header->nonterminals_count;
+    grammar->terminals = layout.terminals;
+    grammar->terminals_count = header->terminals_count;
+    grammar->symbol_table = layout.symbol_table;
+    grammar->symbol_table_capacity = capacity;
+    grammar->arena = arena;
+    return grammar;
+}
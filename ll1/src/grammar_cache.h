@@ -0,0 +1,92 @@
+#ifndef GRAMMAR_CACHE_H
+#define GRAMMAR_CACHE_H
+
+#include "arena.h"
+#include "grammar.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define GRAMMAR_CACHE_MAGIC 0x31454843414d5247ULL   //"GRMACHE1"
+#define GRAMMAR_CACHE_VERSION 1
+#define GRAMMAR_CACHE_MAX_SECTIONS 8
+
+// 缓存文件由若干段组成，段的内容由各分析模块自行约定
+typedef enum GrammarCacheTag{
+    CACHE_SECTION_GRAMMAR = 1,      //符号表与产生式
+    CACHE_SECTION_SETS,             //nullable/First/Follow
+    CACHE_SECTION_PARSE_TABLE,      //LL(1) 预测分析表
+    CACHE_SECTION_LR_TABLE          //LR ACTION/GOTO 表
+} GrammarCacheTag;
+
+// 文件布局：头部、段表，之后是按 8 字节对齐的各段。所有数据按本机字节序与结构布局存放，
+// key 中混入了版本号，换机器或换版本后只会失配重建，不会读错
+typedef struct CacheSection{
+    uint32_t tag;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+} CacheSection;
+
+typedef struct GrammarCacheHeader{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t key;
+    uint64_t file_size;
+} GrammarCacheHeader;
+
+// 在一段连续内存上顺序划出 8 字节对齐的数组：写缓存时先算总长再逐个填入，读缓存时按同样的顺序取回。
+// 越界时返回 NULL，损坏或截断的缓存因此不会读出段外
+typedef struct CacheCursor{
+    char* data;
+    size_t offset;
+    size_t size;
+} CacheCursor;
+
+static inline size_t cache_align(size_t size){
+    return (size + 7) & ~(size_t)7;
+}
+
+static inline void* cache_cursor_take(CacheCursor* cursor, size_t size){
+    if(size > cursor->size - cursor->offset) return NULL;
+    void* ptr = cursor->data + cursor->offset;
+    cursor->offset += cache_align(size);
+    if(cursor->offset > cursor->size) cursor->offset = cursor->size;
+    return ptr;
+}
+
+typedef struct GrammarCacheWriter{
+    CacheSection sections[GRAMMAR_CACHE_MAX_SECTIONS];
+    const void* data[GRAMMAR_CACHE_MAX_SECTIONS];
+    uint32_t section_count;
+} GrammarCacheWriter;
+
+// 已映射的缓存文件。映射为私有可写（写时复制），由缓存恢复的文法仍可以就地修改，不会写回文件
+typedef struct GrammarCache{
+    char* base;
+    size_t size;
+    const CacheSection* sections;
+    uint32_t section_count;
+} GrammarCache;
+
+// 缓存的键：文法文件内容的 64 位 FNV-1a 散列，再混入 variant（区分同一文法的不同用法，如是否化简）与版本号
+bool grammar_cache_key(const char* filename, const char* variant, uint64_t* key);
+
+void grammar_cache_writer_init(GrammarCacheWriter* writer);
+bool grammar_cache_writer_add(GrammarCacheWriter* writer, GrammarCacheTag tag, const void* data, size_t size);
+// 先写临时文件再改名，并发运行或中途失败都不会留下不完整的缓存
+bool grammar_cache_write(const char* path, uint64_t key, const GrammarCacheWriter* writer);
+
+// 文件不存在、键不符或格式不对时返回 false，调用方回到完整分析
+// 只校验头部、段表与各段的头部；段内的表格内容不逐项检查，键一致即视为与文法一致，
+// 这样命中时只有实际用到的页才会载入
+bool grammar_cache_open(const char* path, uint64_t key, GrammarCache* cache);
+const void* grammar_cache_section(const GrammarCache* cache, GrammarCacheTag tag, size_t* size);
+void grammar_cache_close(GrammarCache* cache);
+
+// 文法段：符号名、右部、终结符/非终结符列表与符号散列表直接指向映射，只在 arena 中重建 Symbol 与 Rule 数组
+bool grammar_cache_put_grammar(GrammarCacheWriter* writer, const Grammar* grammar, Arena* arena);
+Grammar* grammar_cache_load_grammar(const GrammarCache* cache, Arena* arena);
+
+#endif
@@ -0,0 +1,262 @@
+#include "grammar_reduce.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// 以计数排序按 key 分组：组 k 的成员为 items[start[k] .. start[k+1])
+static bool group_by(uint32_t group_count, const uint32_t* keys, const uint32_t* values, uint32_t count,
+                     uint32_t** start_out, uint32_t** items_out, Arena* arena){
+    uint32_t* start = arena_alloc(arena, (group_count + 2) * sizeof(uint32_t));
+    uint32_t* items = arena_alloc(arena, (count + 1) * sizeof(uint32_t));
+    if(!start || !items) return false;
+    memset(start, 0, (group_count + 2) * sizeof(uint32_t));
+    for(uint32_t i = 0; i < count; i++) start[keys[i] + 2]++;
+    for(uint32_t k = 0; k < group_count; k++) start[k + 2] += start[k + 1];
+    for(uint32_t i = 0; i < count; i++) items[start[keys[i] + 1]++] = values[i];
+    *start_out = start;
+    *items_out = items;
+    return true;
+}
+
+static uint32_t rule_hash(const Rule* rule){
+    uint32_t hash = 2166136261u ^ (uint32_t)rule->left_hs;
+    hash *= 16777619u;
+    for(uint32_t i = 0; i < rule->right_hs_count; i++){
+        hash ^= (uint32_t)rule->right_hs[i];
+        hash *= 16777619u;
+    }
+    return hash ^ rule->right_hs_count;
+}
+
+static bool rule_equal(const Rule* a, const Rule* b){
+    return a->left_hs == b->left_hs && a->right_hs_count == b->right_hs_count &&
+           (a->right_hs_count == 0 || memcmp(a->right_hs, b->right_hs, a->right_hs_count * sizeof(SymbolId)) == 0);
+}
+
+/// 可终止的非终结符：右部的非终结符全部可终止的产生式使左部可终止（与求 nullable 相同的计数工作表）
+static bool mark_productive(const Grammar* grammar, bool* productive, Arena* arena){
+    uint32_t nt_count = grammar->nonterminals_count;
+    uint32_t total = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++) total += grammar->rules[r].right_hs_count;
+    uint32_t* remaining = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(uint32_t));
+    uint32_t* occ_symbol = arena_alloc(arena, (total + 1) * sizeof(uint32_t));
+    uint32_t* occ_rule = arena_alloc(arena, (total + 1) * sizeof(uint32_t));
+    uint32_t* queue = arena_alloc(arena, (nt_count + 1) * sizeof(uint32_t));
+    if(!remaining || !occ_symbol || !occ_rule || !queue) return false;
+
+    uint32_t occ_count = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        remaining[r] = 0;
+        for(uint32_t i = 0; i < rule->right_hs_count; i++){
+            int x = grammar_nonterminal_id(grammar, rule->right_hs[i]);
+            if(x < 0) continue;
+            occ_symbol[occ_count] = (uint32_t)x;
+            occ_rule[occ_count++] = r;
+            remaining[r]++;
+        }
+    }
+    uint32_t* occ_start;
+    uint32_t* occ_items;
+    if(!group_by(nt_count, occ_symbol, occ_rule, occ_count, &occ_start, &occ_items, arena)) return false;
+
+    memset(productive, 0, nt_count * sizeof(bool));
+    uint32_t head = 0, tail = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        uint32_t lhs = (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[r].left_hs);
+        if(remaining[r] == 0 && !productive[lhs]){
+            productive[lhs] = true;
+            queue[tail++] = lhs;
+        }
+    }
+    while(head < tail){
+        uint32_t x = queue[head++];
+        for(uint32_t e = occ_start[x]; e < occ_start[x + 1]; e++){
+            uint32_t r = occ_items[e];
+            if(--remaining[r] != 0) continue;
+            uint32_t lhs = (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[r].left_hs);
+            if(!productive[lhs]){
+                productive[lhs] = true;
+                queue[tail++] = lhs;
+            }
+        }
+    }
+    return true;
+}
+
+static bool rule_productive(const Grammar* grammar, const Rule* rule, const bool* productive){
+    if(!productive[grammar_nonterminal_id(grammar, rule->left_hs)]) return false;
+    for(uint32_t i = 0; i < rule->right_hs_count; i++){
+        int x = grammar_nonterminal_id(grammar, rule->right_hs[i]);
+        if(x >= 0 && !productive[x]) return false;
+    }
+    return true;
+}
+
+/// 从开始符号出发，沿 keep 中的产生式标记可达的非终结符
+static bool mark_reachable(const Grammar* grammar, const bool* keep, bool* reachable, Arena* arena){
+    uint32_t nt_count = grammar->nonterminals_count;
+    uint32_t* keys = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(uint32_t));
+    uint32_t* values = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(uint32_t));
+    uint32_t* queue = arena_alloc(arena, (nt_count + 1) * sizeof(uint32_t));
+    if(!keys || !values || !queue) return false;
+    uint32_t count = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        if(!keep[r]) continue;
+        keys[count] = (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[r].left_hs);
+        values[count++] = r;
+    }
+    uint32_t* start;
+    uint32_t* rules;
+    if(!group_by(nt_count, keys, values, count, &start, &rules, arena)) return false;
+
+    memset(reachable, 0, nt_count * sizeof(bool));
+    uint32_t head = 0, tail = 0;
+    uint32_t s = (uint32_t)grammar_nonterminal_id(grammar, grammar->start_symbol);
+    reachable[s] = true;
+    queue[tail++] = s;
+    while(head < tail){
+        uint32_t x = queue[head++];
+        for(uint32_t e = start[x]; e < start[x + 1]; e++){
+            const Rule* rule = &grammar->rules[rules[e]];
+            for(uint32_t i = 0; i < rule->right_hs_count; i++){
+                int y = grammar_nonterminal_id(grammar, rule->right_hs[i]);
+                if(y < 0 || reachable[y]) continue;
+                reachable[y] = true;
+                queue[tail++] = (uint32_t)y;
+            }
+        }
+    }
+    return true;
+}
+
+/// 在 keep 为真的产生式中，与前面某条完全相同的产生式置为 false
+static bool drop_duplicates(const Grammar* grammar, bool* keep, uint8_t* reason, Arena* arena){
+    uint32_t capacity = 16;
+    while(capacity < grammar->rule_count * 2) capacity *= 2;
+    int32_t* slots = arena_alloc(arena, capacity * sizeof(int32_t));
+    if(!slots) return false;
+    memset(slots, 0xff, capacity * sizeof(int32_t));
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        if(!keep[r]) continue;
+        const Rule* rule = &grammar->rules[r];
+        uint32_t i = rule_hash(rule) & (capacity - 1);
+        while(slots[i] >= 0 && !rule_equal(&grammar->rules[slots[i]], rule)) i = (i + 1) & (capacity - 1);
+        if(slots[i] >= 0){
+            keep[r] = false;
+            reason[r] = REDUCE_DUPLICATE;
+        }else{
+            slots[i] = (int32_t)r;
+        }
+    }
+    return true;
+}
+
+/// 去掉 used 为假的符号，其余符号按原顺序重新编号
+static uint32_t compact_symbols(Grammar* grammar, SymbolId* list, uint32_t* count, const bool* used,
+                                GrammarReduction* report){
+    uint32_t kept = 0;
+    for(uint32_t i = 0; i < *count; i++){
+        SymbolId sym = list[i];
+        if(used[sym]){
+            grammar->symbols[sym].index = (int32_t)kept;
+            list[kept++] = sym;
+        }else{
+            grammar->symbols[sym].index = -1;
+            report->symbols[report->symbol_count++] = sym;
+        }
+    }
+    uint32_t removed = *count - kept;
+    *count = kept;
+    return removed;
+}
+
+GrammarResultVoid grammar_reduce(Grammar* grammar, GrammarReduction* report){
+    memset(report, 0, sizeof(GrammarReduction));
+    if(!grammar || !grammar->arena) return (GrammarResultVoid){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
+    if(grammar->start_symbol == GRAMMAR_NO_SYMBOL) return (GrammarResultVoid){ .status = GRAMMAR_OK };
+    Arena* arena = grammar->arena;
+    uint32_t nt_count = grammar->nonterminals_count;
+    bool* productive = arena_alloc(arena, (nt_count + 1) * sizeof(bool));
+    bool* reachable = arena_alloc(arena, (nt_count + 1) * sizeof(bool));
+    bool* keep = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(bool));
+    uint8_t* reason = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(uint8_t));
+    bool* used = arena_alloc(arena, (grammar->symbol_count + 1) * sizeof(bool));
+    report->symbols = arena_alloc(arena, (grammar->symbol_count + 1) * sizeof(SymbolId));
+    if(!productive || !reachable || !keep || !reason || !used || !report->symbols ||
+       !mark_productive(grammar, productive, arena)){
+        fprintf(stderr, "Error: Failed to allocate memory for grammar reduction.\n");
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+    }
+
+    // 顺序不能交换：删去不可终止的产生式后，才能得到真正可达的符号
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        keep[r] = rule_productive(grammar, &grammar->rules[r], productive);
+        reason[r] = REDUCE_UNPRODUCTIVE;
+    }
+    if(!mark_reachable(grammar, keep, reachable, arena)){
+        fprintf(stderr, "Error: Failed to allocate memory for grammar reduction.\n");
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+    }
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        if(keep[r] && !reachable[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs)]){
+            keep[r] = false;
+            reason[r] = REDUCE_UNREACHABLE;
+        }
+    }
+    if(!drop_duplicates(grammar, keep, reason, arena)){
+        fprintf(stderr, "Error: Failed to allocate memory for grammar reduction.\n");
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+    }
+
+    uint32_t removed = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++) removed += !keep[r];
+    report->rules = arena_alloc(arena, (removed + 1) * sizeof(RemovedRule));
+    if(!report->rules){
+        fprintf(stderr, "Error: Failed to allocate memory for grammar reduction.\n");
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+    }
+
+    // 保留的产生式原位前移，同时统计仍在使用的符号
+    memset(used, 0, grammar->symbol_count * sizeof(bool));
+    used[grammar->start_symbol] = true;
+    uint32_t kept = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        if(!keep[r]){
+            report->rules[report->rule_count++] = (RemovedRule){ *rule, (ReduceReason)reason[r] };
+            continue;
+        }
+        used[rule->left_hs] = true;
+        for(uint32_t i = 0; i < rule->right_hs_count; i++) used[rule->right_hs[i]] = true;
+        grammar->rules[kept++] = *rule;
+    }
+    grammar->rule_count = kept;
+
+    report->removed_nonterminals = compact_symbols(grammar, grammar->nonterminals, &grammar->nonterminals_count, used, report);
+    report->removed_terminals = compact_symbols(grammar, grammar->terminals, &grammar->terminals_count, used, report);
+    return (GrammarResultVoid){ .status = GRAMMAR_OK };
+}
+
+void print_grammar_reduction(const Grammar* grammar, const GrammarReduction* report){
+    static const char* reasons[] = { "unproductive", "unreachable", "duplicate" };
+    printf("Removed %u rules, %u nonterminals, %u terminals\n",
+           report->rule_count, report->removed_nonterminals, report->removed_terminals);
+    for(uint32_t i = 0; i < report->rule_count; i++){
+        const RemovedRule* removed = &report->rules[i];
+        printf("  [%s] ", reasons[removed->reason]);
+        fprint_symbol(stdout, grammar, removed->rule.left_hs);
+        printf(" -> ");
+        fprint_rule_rhs(stdout, grammar, &removed->rule);
+        printf("\n");
+    }
+    if(report->symbol_count){
+        printf("  symbols:");
+        for(uint32_t i = 0; i < report->symbol_count; i++){
+            printf(" ");
+            fprint_symbol(stdout, grammar, report->symbols[i]);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef GRAMMAR_REDUCE_H
+#define GRAMMAR_REDUCE_H
+
+#include "grammar.h"
+#include <stdint.h>
+
+typedef enum {
+    REDUCE_UNPRODUCTIVE = 0,    //含推不出终结符串的非终结符
+    REDUCE_UNREACHABLE,         //左部不能由开始符号推出
+    REDUCE_DUPLICATE            //与前面某条产生式完全相同
+} ReduceReason;
+
+typedef struct RemovedRule{
+    Rule rule;
+    ReduceReason reason;
+} RemovedRule;
+
+// 化简的结果：删去的产生式（保留原右部）与不再出现的符号
+typedef struct GrammarReduction{
+    RemovedRule* rules;
+    uint32_t rule_count;
+    SymbolId* symbols;
+    uint32_t symbol_count;
+    uint32_t removed_nonterminals;
+    uint32_t removed_terminals;
+} GrammarReduction;
+
+// 就地化简文法：先删去含不可终止符号的产生式，再删去不可达的产生式和重复的产生式，
+// 其余产生式保持原有顺序。不再出现的符号从 nonterminals/terminals 中去掉，其余符号重新编号，
+// 之后 grammar_nonterminal_id/grammar_terminal_id 对被删符号返回 -1。开始符号总是保留
+GrammarResultVoid grammar_reduce(Grammar* grammar, GrammarReduction* report);
+void print_grammar_reduction(const Grammar* grammar, const GrammarReduction* report);
+
+#endif
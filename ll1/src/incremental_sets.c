@@ -0,0 +1,609 @@
+#include "incremental_sets.h"
+#include "digraph.h"
+#include "first_set.h"
+#include "follow_set.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FLAG_QUEUED     1   //已在工作表中
+#define FLAG_CHANGED    2   //已记录在 changed 中
+#define FLAG_NULLABLE   4   //删除时：nullable 可能变为假
+#define FLAG_FIRST      8   //删除时：First 可能变小
+#define FLAG_FOLLOW    16   //删除时：Follow 可能变小
+
+static inline void bitset_remove(uint64_t* set, int id){
+    set[id / SYMBOL_SET_WORD_BITS] &= ~(1ULL << (id % SYMBOL_SET_WORD_BITS));
+}
+
+static inline uint32_t lhs_of(const Grammar* grammar, uint32_t rule){
+    return (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[rule].left_hs);
+}
+
+// ==== 索引 ====
+
+static bool rule_list_push(RuleList* list, uint32_t rule, Arena* arena){
+    if(list->count >= list->capacity){
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 4;
+        uint32_t* rules = arena_alloc(arena, capacity * sizeof(uint32_t));
+        if(!rules) return false;
+        if(list->count) memcpy(rules, list->rules, list->count * sizeof(uint32_t));
+        list->rules = rules;
+        list->capacity = capacity;
+    }
+    list->rules[list->count++] = rule;
+    return true;
+}
+
+static bool use_list_push(UseList* list, RuleUse use, Arena* arena){
+    if(list->count >= list->capacity){
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 4;
+        RuleUse* uses = arena_alloc(arena, capacity * sizeof(RuleUse));
+        if(!uses) return false;
+        if(list->count) memcpy(uses, list->uses, list->count * sizeof(RuleUse));
+        list->uses = uses;
+        list->capacity = capacity;
+    }
+    list->uses[list->count++] = use;
+    return true;
+}
+
+static bool index_rule(IncrementalSets* inc, uint32_t rule){
+    const Grammar* grammar = inc->grammar;
+    const Rule* r = &grammar->rules[rule];
+    if(!rule_list_push(&inc->lhs_rules[lhs_of(grammar, rule)], rule, inc->arena)) return false;
+    for(uint32_t i = 0; i < r->right_hs_count; i++){
+        int x = grammar_nonterminal_id(grammar, r->right_hs[i]);
+        if(x >= 0 && !use_list_push(&inc->uses[x], (RuleUse){ rule, i }, inc->arena)) return false;
+    }
+    return true;
+}
+
+/// 从索引中去掉产生式 rule 的全部记录
+static void unindex_rule(IncrementalSets* inc, uint32_t rule){
+    const Grammar* grammar = inc->grammar;
+    const Rule* r = &grammar->rules[rule];
+    RuleList* list = &inc->lhs_rules[lhs_of(grammar, rule)];
+    for(uint32_t i = 0; i < list->count; i++){
+        if(list->rules[i] == rule){
+            list->rules[i] = list->rules[--list->count];
+            break;
+        }
+    }
+    for(uint32_t i = 0; i < r->right_hs_count; i++){
+        int x = grammar_nonterminal_id(grammar, r->right_hs[i]);
+        if(x < 0) continue;
+        UseList* uses = &inc->uses[x];
+        uint32_t kept = 0;
+        for(uint32_t j = 0; j < uses->count; j++){
+            if(uses->uses[j].rule != rule) uses->uses[kept++] = uses->uses[j];
+        }
+        uses->count = kept;
+    }
+}
+
+/// 产生式从下标 from 移到了 to（grammar->rules[to] 已是该产生式），更新索引中的下标
+static void renumber_rule(IncrementalSets* inc, uint32_t from, uint32_t to){
+    const Grammar* grammar = inc->grammar;
+    const Rule* r = &grammar->rules[to];
+    RuleList* list = &inc->lhs_rules[lhs_of(grammar, to)];
+    for(uint32_t i = 0; i < list->count; i++){
+        if(list->rules[i] == from) list->rules[i] = to;
+    }
+    for(uint32_t i = 0; i < r->right_hs_count; i++){
+        int x = grammar_nonterminal_id(grammar, r->right_hs[i]);
+        if(x < 0) continue;
+        UseList* uses = &inc->uses[x];
+        for(uint32_t j = 0; j < uses->count; j++){
+            if(uses->uses[j].rule == from) uses->uses[j].rule = to;
+        }
+    }
+}
+
+// ==== 新符号 ====
+
+/// 位集扩展到 words 个字，原内容复制过去
+static bool grow_words(IncrementalSets* inc, size_t words){
+    for(uint32_t i = 0; i < inc->set_count; i++){
+        uint64_t* first = arena_alloc(inc->arena, words * sizeof(uint64_t));
+        uint64_t* follow = arena_alloc(inc->arena, words * sizeof(uint64_t));
+        if(!first || !follow) return false;
+        memset(first, 0, words * sizeof(uint64_t));
+        memset(follow, 0, words * sizeof(uint64_t));
+        memcpy(first, inc->sets[i].first, inc->words * sizeof(uint64_t));
+        memcpy(follow, inc->sets[i].follow, inc->words * sizeof(uint64_t));
+        inc->sets[i].first = first;
+        inc->sets[i].follow = follow;
+    }
+    inc->scratch = arena_alloc(inc->arena, words * sizeof(uint64_t));
+    if(!inc->scratch) return false;
+    inc->words = words;
+    return true;
+}
+
+/// 非终结符数组与各工作区扩展到 capacity
+static bool grow_sets(IncrementalSets* inc, uint32_t capacity){
+    Arena* arena = inc->arena;
+    SymbolSet* sets = arena_alloc(arena, capacity * sizeof(SymbolSet));
+    RuleList* lhs_rules = arena_alloc(arena, capacity * sizeof(RuleList));
+    UseList* uses = arena_alloc(arena, capacity * sizeof(UseList));
+    uint32_t* queue = arena_alloc(arena, (capacity + 1) * sizeof(uint32_t));
+    uint8_t* flags = arena_alloc(arena, capacity * sizeof(uint8_t));
+    int32_t* local_id = arena_alloc(arena, capacity * sizeof(int32_t));
+    uint32_t* changed = arena_alloc(arena, capacity * sizeof(uint32_t));
+    if(!sets || !lhs_rules || !uses || !queue || !flags || !local_id || !changed) return false;
+    memset(lhs_rules, 0, capacity * sizeof(RuleList));
+    memset(uses, 0, capacity * sizeof(UseList));
+    memset(flags, 0, capacity * sizeof(uint8_t));
+    memset(local_id, 0xff, capacity * sizeof(int32_t));
+    if(inc->set_count){
+        memcpy(sets, inc->sets, inc->set_count * sizeof(SymbolSet));
+        memcpy(lhs_rules, inc->lhs_rules, inc->set_count * sizeof(RuleList));
+        memcpy(uses, inc->uses, inc->set_count * sizeof(UseList));
+    }
+    inc->sets = sets;
+    inc->lhs_rules = lhs_rules;
+    inc->uses = uses;
+    inc->queue = queue;
+    inc->flags = flags;
+    inc->local_id = local_id;
+    inc->changed = changed;
+    inc->set_capacity = capacity;
+    return true;
+}
+
+/// 文法中新登记的符号：为新非终结符建空集合；新终结符占据了原来 '$' 的编号，把 '$' 移到最后
+static bool sync_symbols(IncrementalSets* inc){
+    const Grammar* grammar = inc->grammar;
+    size_t words = symbol_set_words(grammar);
+    if(words > inc->words && !grow_words(inc, words > inc->words * 2 ? words : inc->words * 2)) return false;
+
+    if(grammar->nonterminals_count > inc->set_capacity){
+        uint32_t capacity = inc->set_capacity * 2;
+        if(capacity < grammar->nonterminals_count) capacity = grammar->nonterminals_count;
+        if(!grow_sets(inc, capacity)) return false;
+    }
+    for(uint32_t i = inc->set_count; i < grammar->nonterminals_count; i++){
+        SymbolSet* set = &inc->sets[i];
+        set->symbol = grammar->nonterminals[i];
+        set->first = arena_alloc(inc->arena, inc->words * sizeof(uint64_t));
+        set->follow = arena_alloc(inc->arena, inc->words * sizeof(uint64_t));
+        if(!set->first || !set->follow) return false;
+        memset(set->first, 0, inc->words * sizeof(uint64_t));
+        memset(set->follow, 0, inc->words * sizeof(uint64_t));
+        set->nullable = false;
+    }
+    inc->set_count = grammar->nonterminals_count;
+
+    if(grammar->terminals_count != inc->terminal_count){
+        int old_end = (int)inc->terminal_count;
+        for(uint32_t i = 0; i < inc->set_count; i++){
+            uint64_t* follow = inc->sets[i].follow;
+            if(!bitset_contains(follow, old_end)) continue;
+            bitset_remove(follow, old_end);
+            bitset_add(follow, grammar_end_marker_id(grammar));
+        }
+        inc->terminal_count = grammar->terminals_count;
+    }
+    return true;
+}
+
+bool incremental_sets_init(IncrementalSets* inc, Grammar* grammar, Arena* arena){
+    memset(inc, 0, sizeof(IncrementalSets));
+    inc->grammar = grammar;
+    inc->arena = arena;
+    uint32_t capacity = grammar->nonterminals_count > 8 ? grammar->nonterminals_count : 8;
+    if(!grow_sets(inc, capacity)){
+        fprintf(stderr, "Error: Failed to allocate memory for incremental sets.\n");
+        return false;
+    }
+    int count = 0;
+    compute_first_sets(grammar, inc->sets, &count, arena);
+    compute_follow_sets(grammar, inc->sets, &count, arena);
+    inc->set_count = (uint32_t)count;
+    inc->words = symbol_set_words(grammar);
+    inc->terminal_count = grammar->terminals_count;
+    inc->scratch = arena_alloc(arena, inc->words * sizeof(uint64_t));
+    if(!inc->scratch){
+        fprintf(stderr, "Error: Failed to allocate memory for incremental sets.\n");
+        return false;
+    }
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        if(!index_rule(inc, r)){
+            fprintf(stderr, "Error: Failed to allocate memory for incremental sets.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==== 规则上的局部计算 ====
+
+/// 右部前 position 个符号是否都是可空的非终结符
+static bool prefix_nullable(const IncrementalSets* inc, uint32_t rule, uint32_t position){
+    const Grammar* grammar = inc->grammar;
+    const Rule* r = &grammar->rules[rule];
+    for(uint32_t i = 0; i < position; i++){
+        int x = grammar_nonterminal_id(grammar, r->right_hs[i]);
+        if(x < 0 || !inc->sets[x].nullable) return false;
+    }
+    return true;
+}
+
+static bool rule_nullable(const IncrementalSets* inc, uint32_t rule){
+    return prefix_nullable(inc, rule, inc->grammar->rules[rule].right_hs_count);
+}
+
+/// 把产生式右部的 First 集并入左部的 First 集，返回左部是否变化
+static bool merge_rule_first(IncrementalSets* inc, uint32_t rule){
+    const Grammar* grammar = inc->grammar;
+    const Rule* r = &grammar->rules[rule];
+    uint64_t* first = inc->sets[lhs_of(grammar, rule)].first;
+    bool changed = false;
+    for(uint32_t i = 0; i < r->right_hs_count; i++){
+        SymbolId sym = r->right_hs[i];
+        if(grammar_symbol_is_terminal(grammar, sym)) return bitset_add(first, grammar_terminal_id(grammar, sym)) || changed;
+        const SymbolSet* set = &inc->sets[grammar_nonterminal_id(grammar, sym)];
+        changed = bitset_union(first, set->first, inc->words) || changed;
+        if(!set->nullable) break;
+    }
+    return changed;
+}
+
+typedef struct Worklist{
+    IncrementalSets* inc;
+    uint32_t head;
+    uint32_t count;
+} Worklist;
+
+static void worklist_push(Worklist* list, uint32_t x){
+    IncrementalSets* inc = list->inc;
+    if(inc->flags[x] & FLAG_QUEUED) return;
+    inc->flags[x] |= FLAG_QUEUED;
+    inc->queue[(list->head + list->count++) % (inc->set_capacity + 1)] = x;
+}
+
+static bool worklist_pop(Worklist* list, uint32_t* x){
+    IncrementalSets* inc = list->inc;
+    if(list->count == 0) return false;
+    *x = inc->queue[list->head];
+    list->head = (list->head + 1) % (inc->set_capacity + 1);
+    list->count--;
+    inc->flags[*x] &= (uint8_t)~FLAG_QUEUED;
+    return true;
+}
+
+static void record_changed(IncrementalSets* inc, uint32_t* changed_count, uint32_t x){
+    if(inc->flags[x] & FLAG_CHANGED) return;
+    inc->flags[x] |= FLAG_CHANGED;
+    inc->changed[(*changed_count)++] = x;
+}
+
+/// 把产生式对右部各非终结符 Follow 集的全部贡献并入：自右向左扫描，累积后缀的 First 集与可空性
+static void merge_rule_follow(IncrementalSets* inc, uint32_t rule, Worklist* follow_list){
+    const Grammar* grammar = inc->grammar;
+    const Rule* r = &grammar->rules[rule];
+    const uint64_t* lhs_follow = inc->sets[lhs_of(grammar, rule)].follow;
+    uint64_t* acc = inc->scratch;
+    memset(acc, 0, inc->words * sizeof(uint64_t));
+    bool suffix_nullable = true;
+    for(uint32_t k = r->right_hs_count; k-- > 0;){
+        SymbolId sym = r->right_hs[k];
+        if(grammar_symbol_is_terminal(grammar, sym)){
+            memset(acc, 0, inc->words * sizeof(uint64_t));
+            bitset_add(acc, grammar_terminal_id(grammar, sym));
+            suffix_nullable = false;
+            continue;
+        }
+        uint32_t b = (uint32_t)grammar_nonterminal_id(grammar, sym);
+        SymbolSet* set = &inc->sets[b];
+        bool changed = bitset_union(set->follow, acc, inc->words);
+        if(suffix_nullable) changed = bitset_union(set->follow, lhs_follow, inc->words) || changed;
+        if(changed) worklist_push(follow_list, b);
+        if(set->nullable){
+            bitset_union(acc, set->first, inc->words);
+        }else{
+            memcpy(acc, set->first, inc->words * sizeof(uint64_t));
+            suffix_nullable = false;
+        }
+    }
+}
+
+// ==== 增加产生式：集合只增不减，沿依赖边传播新增部分 ====
+
+bool incremental_add_rule(IncrementalSets* inc, SymbolId lhs, const SymbolId* rhs, uint32_t count){
+    Grammar* grammar = inc->grammar;
+    if(grammar_append_rule(grammar, lhs, rhs, count).status != GRAMMAR_OK) return false;
+    uint32_t rule = grammar->rule_count - 1;
+    if(!sync_symbols(inc) || !index_rule(inc, rule)){
+        fprintf(stderr, "Error: Failed to allocate memory for incremental sets.\n");
+        return false;
+    }
+
+    // nullable：新产生式可空时，沿出现位置向上传播
+    uint32_t changed_count = 0;
+    Worklist list = { inc, 0, 0 };
+    uint32_t a = lhs_of(grammar, rule);
+    if(!inc->sets[a].nullable && rule_nullable(inc, rule)){
+        inc->sets[a].nullable = true;
+        worklist_push(&list, a);
+    }
+    uint32_t x;
+    while(worklist_pop(&list, &x)){
+        record_changed(inc, &changed_count, x);
+        const UseList* uses = &inc->uses[x];
+        for(uint32_t i = 0; i < uses->count; i++){
+            uint32_t q = uses->uses[i].rule;
+            uint32_t l = lhs_of(grammar, q);
+            if(inc->sets[l].nullable || !rule_nullable(inc, q)) continue;
+            inc->sets[l].nullable = true;
+            worklist_push(&list, l);
+        }
+    }
+    uint32_t nullable_count = changed_count;
+
+    // First：新产生式及含新可空符号的产生式重新并入左部，再沿 X -> 左部 的边传播
+    if(merge_rule_first(inc, rule)) worklist_push(&list, a);
+    for(uint32_t i = 0; i < nullable_count; i++){
+        const UseList* uses = &inc->uses[inc->changed[i]];
+        for(uint32_t j = 0; j < uses->count; j++){
+            uint32_t q = uses->uses[j].rule;
+            if(merge_rule_first(inc, q)) worklist_push(&list, lhs_of(grammar, q));
+        }
+    }
+    while(worklist_pop(&list, &x)){
+        record_changed(inc, &changed_count, x);
+        const UseList* uses = &inc->uses[x];
+        for(uint32_t i = 0; i < uses->count; i++){
+            RuleUse use = uses->uses[i];
+            if(!prefix_nullable(inc, use.rule, use.position)) continue;
+            uint32_t l = lhs_of(grammar, use.rule);
+            if(bitset_union(inc->sets[l].first, inc->sets[x].first, inc->words)) worklist_push(&list, l);
+        }
+    }
+
+    // Follow：新产生式及含有 nullable 或 First 变化符号的产生式重新贡献，再沿 左部 -> 尾部符号 的边传播
+    SymbolSet* start = &inc->sets[grammar_nonterminal_id(grammar, grammar->start_symbol)];
+    if(bitset_add(start->follow, grammar_end_marker_id(grammar))) worklist_push(&list, (uint32_t)(start - inc->sets));
+    merge_rule_follow(inc, rule, &list);
+    for(uint32_t i = 0; i < changed_count; i++){
+        const UseList* uses = &inc->uses[inc->changed[i]];
+        for(uint32_t j = 0; j < uses->count; j++) merge_rule_follow(inc, uses->uses[j].rule, &list);
+    }
+    while(worklist_pop(&list, &x)){
+        const RuleList* rules = &inc->lhs_rules[x];
+        for(uint32_t i = 0; i < rules->count; i++){
+            const Rule* r = &grammar->rules[rules->rules[i]];
+            for(uint32_t k = r->right_hs_count; k-- > 0;){
+                int b = grammar_nonterminal_id(grammar, r->right_hs[k]);
+                if(b < 0) break;
+                if(bitset_union(inc->sets[b].follow, inc->sets[x].follow, inc->words)) worklist_push(&list, (uint32_t)b);
+                if(!inc->sets[b].nullable) break;
+            }
+        }
+    }
+
+    for(uint32_t i = 0; i < changed_count; i++) inc->flags[inc->changed[i]] = 0;
+    return true;
+}
+
+// ==== 删除产生式：求出可能变小的部分，清空后局部重算 ====
+
+typedef struct NodeList{
+    uint32_t* nodes;
+    uint32_t count;
+} NodeList;
+
+static void node_list_add(IncrementalSets* inc, NodeList* list, uint32_t x, uint8_t flag){
+    if(inc->flags[x] & flag) return;
+    inc->flags[x] |= flag;
+    list->nodes[list->count++] = x;
+}
+
+/// 在删除前的依赖关系上求三个受影响集合（旧关系包含新关系，所以结果是安全的上界）：
+/// nullable 可能变假的 N、First 可能变小的 F（N 与左部沿 First 边向上闭包）、
+/// Follow 可能变小的 W（被删右部中的非终结符、含 N/F 中符号的产生式里的非终结符，沿 Follow 边闭包）
+static void collect_affected(IncrementalSets* inc, uint32_t rule, NodeList* n, NodeList* f, NodeList* w){
+    const Grammar* grammar = inc->grammar;
+    uint32_t a = lhs_of(grammar, rule);
+
+    if(inc->sets[a].nullable && rule_nullable(inc, rule)) node_list_add(inc, n, a, FLAG_NULLABLE);
+    for(uint32_t i = 0; i < n->count; i++){
+        const UseList* uses = &inc->uses[n->nodes[i]];
+        for(uint32_t j = 0; j < uses->count; j++){
+            uint32_t q = uses->uses[j].rule;
+            uint32_t l = lhs_of(grammar, q);
+            if(inc->sets[l].nullable && rule_nullable(inc, q)) node_list_add(inc, n, l, FLAG_NULLABLE);
+        }
+    }
+
+    node_list_add(inc, f, a, FLAG_FIRST);
+    for(uint32_t i = 0; i < n->count; i++) node_list_add(inc, f, n->nodes[i], FLAG_FIRST);
+    for(uint32_t i = 0; i < f->count; i++){
+        const UseList* uses = &inc->uses[f->nodes[i]];
+        for(uint32_t j = 0; j < uses->count; j++){
+            RuleUse use = uses->uses[j];
+            if(prefix_nullable(inc, use.rule, use.position)) node_list_add(inc, f, lhs_of(grammar, use.rule), FLAG_FIRST);
+        }
+    }
+
+    const Rule* removed = &grammar->rules[rule];
+    for(uint32_t k = 0; k < removed->right_hs_count; k++){
+        int b = grammar_nonterminal_id(grammar, removed->right_hs[k]);
+        if(b >= 0) node_list_add(inc, w, (uint32_t)b, FLAG_FOLLOW);
+    }
+    for(uint32_t i = 0; i < f->count; i++){
+        const UseList* uses = &inc->uses[f->nodes[i]];
+        for(uint32_t j = 0; j < uses->count; j++){
+            const Rule* r = &grammar->rules[uses->uses[j].rule];
+            for(uint32_t k = 0; k < r->right_hs_count; k++){
+                int b = grammar_nonterminal_id(grammar, r->right_hs[k]);
+                if(b >= 0) node_list_add(inc, w, (uint32_t)b, FLAG_FOLLOW);
+            }
+        }
+    }
+    for(uint32_t i = 0; i < w->count; i++){
+        const RuleList* rules = &inc->lhs_rules[w->nodes[i]];
+        for(uint32_t j = 0; j < rules->count; j++){
+            const Rule* r = &grammar->rules[rules->rules[j]];
+            for(uint32_t k = r->right_hs_count; k-- > 0;){
+                int b = grammar_nonterminal_id(grammar, r->right_hs[k]);
+                if(b < 0) break;
+                node_list_add(inc, w, (uint32_t)b, FLAG_FOLLOW);
+                if(!inc->sets[b].nullable) break;
+            }
+        }
+    }
+}
+
+static void recompute_nullable(IncrementalSets* inc, const NodeList* n){
+    for(uint32_t i = 0; i < n->count; i++) inc->sets[n->nodes[i]].nullable = false;
+    bool changed = true;
+    while(changed){
+        changed = false;
+        for(uint32_t i = 0; i < n->count; i++){
+            SymbolSet* set = &inc->sets[n->nodes[i]];
+            if(set->nullable) continue;
+            const RuleList* rules = &inc->lhs_rules[n->nodes[i]];
+            for(uint32_t j = 0; j < rules->count; j++){
+                if(rule_nullable(inc, rules->rules[j])){
+                    set->nullable = true;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/// 对受影响的结点建局部关系并用 digraph 求解，边界外结点的集合已是最终结果，直接并入初值
+static bool solve_local(IncrementalSets* inc, const NodeList* nodes, const int* from, const int* to, int edge_count,
+                        bool follow){
+    Digraph relation;
+    uint64_t** sets = arena_alloc(inc->arena, (nodes->count + 1) * sizeof(uint64_t*));
+    if(!sets || !digraph_build(&relation, (int)nodes->count, from, to, edge_count, inc->arena)) return false;
+    for(uint32_t i = 0; i < nodes->count; i++){
+        SymbolSet* set = &inc->sets[nodes->nodes[i]];
+        sets[i] = follow ? set->follow : set->first;
+    }
+    return digraph_solve(&relation, sets, inc->words, inc->arena);
+}
+
+static bool recompute_first(IncrementalSets* inc, const NodeList* f){
+    const Grammar* grammar = inc->grammar;
+    int bound = 0;
+    for(uint32_t i = 0; i < f->count; i++){
+        inc->local_id[f->nodes[i]] = (int32_t)i;
+        memset(inc->sets[f->nodes[i]].first, 0, inc->words * sizeof(uint64_t));
+        const RuleList* rules = &inc->lhs_rules[f->nodes[i]];
+        for(uint32_t j = 0; j < rules->count; j++) bound += (int)grammar->rules[rules->rules[j]].right_hs_count;
+    }
+    int* from = arena_alloc(inc->arena, (bound + 1) * sizeof(int));
+    int* to = arena_alloc(inc->arena, (bound + 1) * sizeof(int));
+    if(!from || !to) return false;
+
+    int edge_count = 0;
+    for(uint32_t i = 0; i < f->count; i++){
+        SymbolSet* set = &inc->sets[f->nodes[i]];
+        const RuleList* rules = &inc->lhs_rules[f->nodes[i]];
+        for(uint32_t j = 0; j < rules->count; j++){
+            const Rule* r = &grammar->rules[rules->rules[j]];
+            for(uint32_t k = 0; k < r->right_hs_count; k++){
+                SymbolId sym = r->right_hs[k];
+                if(grammar_symbol_is_terminal(grammar, sym)){
+                    bitset_add(set->first, grammar_terminal_id(grammar, sym));
+                    break;
+                }
+                int y = grammar_nonterminal_id(grammar, sym);
+                if(inc->local_id[y] >= 0){
+                    from[edge_count] = (int)i;
+                    to[edge_count++] = inc->local_id[y];
+                }else{
+                    bitset_union(set->first, inc->sets[y].first, inc->words);
+                }
+                if(!inc->sets[y].nullable) break;
+            }
+        }
+    }
+    bool ok = solve_local(inc, f, from, to, edge_count, false);
+    for(uint32_t i = 0; i < f->count; i++) inc->local_id[f->nodes[i]] = -1;
+    return ok;
+}
+
+static bool recompute_follow(IncrementalSets* inc, const NodeList* w){
+    const Grammar* grammar = inc->grammar;
+    int bound = 0;
+    for(uint32_t i = 0; i < w->count; i++){
+        inc->local_id[w->nodes[i]] = (int32_t)i;
+        memset(inc->sets[w->nodes[i]].follow, 0, inc->words * sizeof(uint64_t));
+        bound += (int)inc->uses[w->nodes[i]].count;
+    }
+    int start = grammar_nonterminal_id(grammar, grammar->start_symbol);
+    if(inc->local_id[start] >= 0) bitset_add(inc->sets[start].follow, grammar_end_marker_id(grammar));
+    int* from = arena_alloc(inc->arena, (bound + 1) * sizeof(int));
+    int* to = arena_alloc(inc->arena, (bound + 1) * sizeof(int));
+    if(!from || !to) return false;
+
+    int edge_count = 0;
+    for(uint32_t i = 0; i < w->count; i++){
+        SymbolSet* set = &inc->sets[w->nodes[i]];
+        const UseList* uses = &inc->uses[w->nodes[i]];
+        for(uint32_t j = 0; j < uses->count; j++){
+            RuleUse use = uses->uses[j];
+            const Rule* r = &grammar->rules[use.rule];
+            bool suffix_nullable = true;
+            for(uint32_t k = use.position + 1; k < r->right_hs_count && suffix_nullable; k++){
+                SymbolId sym = r->right_hs[k];
+                if(grammar_symbol_is_terminal(grammar, sym)){
+                    bitset_add(set->follow, grammar_terminal_id(grammar, sym));
+                    suffix_nullable = false;
+                    break;
+                }
+                const SymbolSet* next = &inc->sets[grammar_nonterminal_id(grammar, sym)];
+                bitset_union(set->follow, next->first, inc->words);
+                suffix_nullable = next->nullable;
+            }
+            if(!suffix_nullable) continue;
+            uint32_t l = lhs_of(grammar, use.rule);
+            if(inc->local_id[l] >= 0){
+                from[edge_count] = (int)i;
+                to[edge_count++] = inc->local_id[l];
+            }else{
+                bitset_union(set->follow, inc->sets[l].follow, inc->words);
+            }
+        }
+    }
+    bool ok = solve_local(inc, w, from, to, edge_count, true);
+    for(uint32_t i = 0; i < w->count; i++) inc->local_id[w->nodes[i]] = -1;
+    return ok;
+}
+
+bool incremental_remove_rule(IncrementalSets* inc, uint32_t rule){
+    Grammar* grammar = inc->grammar;
+    if(rule >= grammar->rule_count) return false;
+
+    // 局部重算用到的临时空间在结束时整体归还
+    size_t mark = inc->arena->offset;
+    NodeList n = { arena_alloc(inc->arena, (inc->set_count + 1) * sizeof(uint32_t)), 0 };
+    NodeList f = { arena_alloc(inc->arena, (inc->set_count + 1) * sizeof(uint32_t)), 0 };
+    NodeList w = { arena_alloc(inc->arena, (inc->set_count + 1) * sizeof(uint32_t)), 0 };
+    if(!n.nodes || !f.nodes || !w.nodes){
+        fprintf(stderr, "Error: Failed to allocate memory for incremental sets.\n");
+        return false;
+    }
+    collect_affected(inc, rule, &n, &f, &w);
+
+    uint32_t last = grammar->rule_count - 1;
+    unindex_rule(inc, rule);
+    grammar_remove_rule(grammar, rule);
+    if(rule != last) renumber_rule(inc, last, rule);
+
+    recompute_nullable(inc, &n);
+    bool ok = recompute_first(inc, &f) && recompute_follow(inc, &w);
+    for(uint32_t i = 0; i < n.count; i++) inc->flags[n.nodes[i]] = 0;
+    for(uint32_t i = 0; i < f.count; i++) inc->flags[f.nodes[i]] = 0;
+    for(uint32_t i = 0; i < w.count; i++) inc->flags[w.nodes[i]] = 0;
+    inc->arena->offset = mark;
+    if(!ok) fprintf(stderr, "Error: Failed to allocate memory for incremental sets.\n");
+    return ok;
+}
@@ -0,0 +1,57 @@
+#ifndef INCREMENTAL_SETS_H
+#define INCREMENTAL_SETS_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "first_follow.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 非终结符 X 在产生式 rule 右部第 position 个位置出现
+typedef struct RuleUse{
+    uint32_t rule;
+    uint32_t position;
+} RuleUse;
+
+typedef struct RuleList{
+    uint32_t* rules;
+    uint32_t count;
+    uint32_t capacity;
+} RuleList;
+
+typedef struct UseList{
+    RuleUse* uses;
+    uint32_t count;
+    uint32_t capacity;
+} UseList;
+
+// 随文法编辑增量维护的 nullable/First/Follow 集。sets 的布局与 compute_first_sets 相同，
+// 位集按 words 个字分配（不小于 symbol_set_words(grammar)），新增终结符时 '$' 位随之后移。
+// 增加产生式时各集合只会变大，沿依赖边用工作表传播新增的位；
+// 删除产生式时先在旧的依赖关系上求出可能变小的非终结符，清空后只对这部分重新求解（digraph 按强连通分量传播）
+typedef struct IncrementalSets{
+    Grammar* grammar;
+    SymbolSet* sets;
+    uint32_t set_count;
+    uint32_t set_capacity;
+    size_t words;
+    uint32_t terminal_count;    //上次同步时的终结符数，即 '$' 所在的位
+    RuleList* lhs_rules;        //lhs_rules[A]：左部为 A 的产生式
+    UseList* uses;              //uses[X]：X 在右部的全部出现位置
+    uint32_t* queue;            //工作表，容量 set_capacity + 1 的循环队列
+    uint8_t* flags;             //非终结符的标记位，操作结束时清零
+    int32_t* local_id;          //局部重算时在受影响子图中的编号，平时为 -1
+    uint32_t* changed;          //本次操作中集合发生变化的非终结符
+    uint64_t* scratch;          //一个位集的临时空间
+    Arena* arena;
+} IncrementalSets;
+
+// 对当前文法完整计算一次，并建立按左部和按出现位置的索引
+bool incremental_sets_init(IncrementalSets* inc, Grammar* grammar, Arena* arena);
+// 追加产生式 lhs -> rhs（符号须已用 grammar_intern_symbol 登记，可以是新符号），并增量更新各集合
+bool incremental_add_rule(IncrementalSets* inc, SymbolId lhs, const SymbolId* rhs, uint32_t count);
+// 删除第 rule 条产生式（与 grammar_remove_rule 相同，最后一条产生式移到该下标），并增量更新各集合
+bool incremental_remove_rule(IncrementalSets* inc, uint32_t rule);
+
+#endif
@@ -0,0 +1,114 @@
+#include "ll1_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct CachedSetsHeader{
+    uint32_t count;
+    uint32_t words;
+} CachedSetsHeader;
+
+typedef struct CachedParseTableHeader{
+    uint32_t row_count;
+    uint32_t column_count;
+    uint32_t rule_count;
+    uint32_t words;
+    uint32_t conflict_count;
+    uint32_t reserved;
+} CachedParseTableHeader;
+
+bool cache_put_symbol_sets(GrammarCacheWriter* writer, const Grammar* grammar, const SymbolSet* sets, int count, Arena* arena){
+    CachedSetsHeader header = { (uint32_t)count, (uint32_t)symbol_set_words(grammar) };
+    size_t bits = (size_t)header.count * header.words * sizeof(uint64_t);
+    size_t size = cache_align(sizeof(header)) + cache_align(header.count * sizeof(SymbolId)) +
+                  cache_align(header.count * sizeof(bool)) + 2 * cache_align(bits);
+    char* data = arena_alloc(arena, size);
+    if(!data){
+        fprintf(stderr, "Error: Failed to allocate memory for the cached sets.\n");
+        return false;
+    }
+    memset(data, 0, size);
+    CacheCursor cursor = { data, 0, size };
+    *(CachedSetsHeader*)cache_cursor_take(&cursor, sizeof(header)) = header;
+    SymbolId* symbols = cache_cursor_take(&cursor, header.count * sizeof(SymbolId));
+    bool* nullable = cache_cursor_take(&cursor, header.count * sizeof(bool));
+    uint64_t* first = cache_cursor_take(&cursor, bits);
+    uint64_t* follow = cache_cursor_take(&cursor, bits);
+    for(uint32_t i = 0; i < header.count; i++){
+        symbols[i] = sets[i].symbol;
+        nullable[i] = sets[i].nullable;
+        memcpy(first + (size_t)i * header.words, sets[i].first, header.words * sizeof(uint64_t));
+        memcpy(follow + (size_t)i * header.words, sets[i].follow, header.words * sizeof(uint64_t));
+    }
+    return grammar_cache_writer_add(writer, CACHE_SECTION_SETS, data, size);
+}
+
+SymbolSet* cache_load_symbol_sets(const GrammarCache* cache, const Grammar* grammar, int* count, Arena* arena){
+    size_t size;
+    char* data = (char*)grammar_cache_section(cache, CACHE_SECTION_SETS, &size);
+    if(!data) return NULL;
+    CacheCursor cursor = { data, 0, size };
+    const CachedSetsHeader* header = cache_cursor_take(&cursor, sizeof(CachedSetsHeader));
+    if(!header || header->count != grammar->nonterminals_count || header->words != symbol_set_words(grammar)) return NULL;
+    size_t bits = (size_t)header->count * header->words * sizeof(uint64_t);
+    SymbolId* symbols = cache_cursor_take(&cursor, header->count * sizeof(SymbolId));
+    bool* nullable = cache_cursor_take(&cursor, header->count * sizeof(bool));
+    uint64_t* first = cache_cursor_take(&cursor, bits);
+    uint64_t* follow = cache_cursor_take(&cursor, bits);
+    SymbolSet* sets = arena_alloc(arena, (header->count + 1) * sizeof(SymbolSet));
+    if(!symbols || !nullable || !first || !follow || !sets) return NULL;
+    for(uint32_t i = 0; i < header->count; i++){
+        if(symbols[i] != grammar->nonterminals[i]) return NULL;
+        sets[i] = (SymbolSet){ symbols[i], first + (size_t)i * header->words, follow + (size_t)i * header->words, nullable[i] };
+    }
+    *count = (int)header->count;
+    return sets;
+}
+
+bool cache_put_parse_table(GrammarCacheWriter* writer, const Grammar* grammar, const ParseTable* table, Arena* arena){
+    CachedParseTableHeader header = { table->row_count, table->column_count, grammar->rule_count, (uint32_t)table->words,
+                                      table->conflict_count, 0 };
+    size_t cells = (size_t)header.row_count * header.column_count * sizeof(int16_t);
+    size_t rule_first = (size_t)header.rule_count * header.words * sizeof(uint64_t);
+    size_t size = cache_align(sizeof(header)) + cache_align(cells) + cache_align(rule_first) +
+                  cache_align(header.rule_count * sizeof(bool)) + cache_align(header.conflict_count * sizeof(TableConflict));
+    char* data = arena_alloc(arena, size);
+    if(!data){
+        fprintf(stderr, "Error: Failed to allocate memory for the cached parse table.\n");
+        return false;
+    }
+    memset(data, 0, size);
+    CacheCursor cursor = { data, 0, size };
+    *(CachedParseTableHeader*)cache_cursor_take(&cursor, sizeof(header)) = header;
+    memcpy(cache_cursor_take(&cursor, cells), table->cells, cells);
+    memcpy(cache_cursor_take(&cursor, rule_first), table->rule_first, rule_first);
+    memcpy(cache_cursor_take(&cursor, header.rule_count * sizeof(bool)), table->rule_nullable, header.rule_count * sizeof(bool));
+    if(header.conflict_count){
+        memcpy(cache_cursor_take(&cursor, header.conflict_count * sizeof(TableConflict)), table->conflicts,
+               header.conflict_count * sizeof(TableConflict));
+    }
+    return grammar_cache_writer_add(writer, CACHE_SECTION_PARSE_TABLE, data, size);
+}
+
+bool cache_load_parse_table(const GrammarCache* cache, const Grammar* grammar, ParseTable* table){
+    size_t size;
+    char* data = (char*)grammar_cache_section(cache, CACHE_SECTION_PARSE_TABLE, &size);
+    if(!data) return false;
+    CacheCursor cursor = { data, 0, size };
+    const CachedParseTableHeader* header = cache_cursor_take(&cursor, sizeof(CachedParseTableHeader));
+    if(!header || header->row_count != grammar->nonterminals_count || header->column_count != grammar->terminals_count + 1 ||
+       header->rule_count != grammar->rule_count || header->words != symbol_set_words(grammar)){
+        return false;
+    }
+    memset(table, 0, sizeof(ParseTable));
+    table->row_count = header->row_count;
+    table->column_count = header->column_count;
+    table->words = header->words;
+    table->cells = cache_cursor_take(&cursor, (size_t)header->row_count * header->column_count * sizeof(int16_t));
+    table->rule_first = cache_cursor_take(&cursor, (size_t)header->rule_count * header->words * sizeof(uint64_t));
+    table->rule_nullable = cache_cursor_take(&cursor, header->rule_count * sizeof(bool));
+    table->conflicts = cache_cursor_take(&cursor, header->conflict_count * sizeof(TableConflict));
+    table->conflict_count = header->conflict_count;
+    table->conflict_capacity = header->conflict_count;
+    return table->cells && table->rule_first && table->rule_nullable && table->conflicts;
+}
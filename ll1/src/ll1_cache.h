@@ -0,0 +1,18 @@
+#ifndef LL1_CACHE_H
+#define LL1_CACHE_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "first_follow.h"
+#include "grammar_cache.h"
+#include "parse_table.h"
+#include <stdbool.h>
+
+// nullable/First/Follow 与 LL(1) 预测分析表在缓存中的段。读出的位集与表格直接引用映射，
+// 只在 arena 中重建 SymbolSet 数组；段与文法的规模不符时视为失配，返回失败
+bool cache_put_symbol_sets(GrammarCacheWriter* writer, const Grammar* grammar, const SymbolSet* sets, int count, Arena* arena);
+SymbolSet* cache_load_symbol_sets(const GrammarCache* cache, const Grammar* grammar, int* count, Arena* arena);
+bool cache_put_parse_table(GrammarCacheWriter* writer, const Grammar* grammar, const ParseTable* table, Arena* arena);
+bool cache_load_parse_table(const GrammarCache* cache, const Grammar* grammar, ParseTable* table);
+
+#endif
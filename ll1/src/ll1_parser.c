@@ -0,0 +1,126 @@
+#include "ll1_parser.h"
+#include "parse_table.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int token_array_next(void* context){
+    TokenArray* input = context;
+    if(input->pos >= input->count) return input->end;
+    return input->tokens[input->pos++];
+}
+
+/// 把产生式右部逆序编码后连续存放，展开时整段 memcpy 入栈
+static bool encode_rules(LL1Parser* parser, Arena* arena){
+    const Grammar* grammar = parser->grammar;
+    int32_t columns = (int32_t)parser->table->column_count;
+    size_t total = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++) total += grammar->rules[r].right_hs_count;
+
+    parser->rhs_start = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(int32_t));
+    parser->rhs_codes = arena_alloc(arena, (total + 1) * sizeof(int32_t));
+    if(!parser->rhs_start || !parser->rhs_codes){
+        fprintf(stderr, "Error: Failed to allocate memory for parser rules.\n");
+        return false;
+    }
+    int32_t pos = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        parser->rhs_start[r] = pos;
+        for(uint32_t i = rule->right_hs_count; i-- > 0;){
+            SymbolId sym = rule->right_hs[i];
+            parser->rhs_codes[pos++] = grammar_symbol_is_terminal(grammar, sym)
+                                     ? grammar_terminal_id(grammar, sym)
+                                     : columns + grammar_nonterminal_id(grammar, sym);
+        }
+    }
+    parser->rhs_start[grammar->rule_count] = pos;
+    return true;
+}
+
+bool ll1_parser_init(LL1Parser* parser, const Grammar* grammar, const ParseTable* table,
+                     size_t stack_capacity, size_t event_capacity,
+                     ParseEventSink sink, void* sink_context, Arena* arena)
+{
+    memset(parser, 0, sizeof(LL1Parser));
+    if(!grammar || !table || grammar->start_symbol == GRAMMAR_NO_SYMBOL || stack_capacity < 2 || event_capacity == 0){
+        fprintf(stderr, "Error: Invalid arguments for LL(1) parser.\n");
+        return false;
+    }
+    parser->grammar = grammar;
+    parser->table = table;
+    parser->stack_capacity = stack_capacity;
+    parser->event_capacity = event_capacity;
+    parser->sink = sink;
+    parser->sink_context = sink_context;
+    parser->stack = arena_alloc(arena, stack_capacity * sizeof(int32_t));
+    parser->events = arena_alloc(arena, event_capacity * sizeof(ParseEvent));
+    if(!parser->stack || !parser->events){
+        fprintf(stderr, "Error: Failed to allocate memory for parser stack.\n");
+        return false;
+    }
+    return encode_rules(parser, arena);
+}
+
+/// 事件先写入定长缓冲，满了再整批交给 sink
+static inline void emit_event(LL1Parser* parser, size_t* count, ParseEvent event){
+    if(*count == parser->event_capacity){
+        if(parser->sink) parser->sink(parser->sink_context, parser->events, *count);
+        *count = 0;
+    }
+    parser->events[(*count)++] = event;
+}
+
+/// 预测分析主循环：栈顶为终结符时与当前 token 比较并读入下一个 token，
+/// 为非终结符 A 时查 M[A, a] 得到产生式，把其逆序右部整段压栈
+LL1ParseResult ll1_parse(LL1Parser* parser, TokenIterator* input){
+    const int32_t columns = (int32_t)parser->table->column_count;
+    const int32_t end = columns - 1;
+    const int16_t* cells = parser->table->cells;
+    const int32_t* rhs_start = parser->rhs_start;
+    const int32_t* rhs_codes = parser->rhs_codes;
+    int32_t* stack = parser->stack;
+    size_t capacity = parser->stack_capacity;
+    size_t top = 0;
+    size_t event_count = 0;
+    LL1ParseResult result = { LL1_PARSE_OK, 0, -1 };
+
+    stack[top++] = end;
+    stack[top++] = columns + grammar_nonterminal_id(parser->grammar, parser->grammar->start_symbol);
+    int token = input->next(input->context);
+    if(token < 0 || token > end) token = -1;
+
+    for(;;){
+        int32_t x = stack[--top];
+        if(x < columns){
+            if(x != token){
+                result.status = LL1_PARSE_SYNTAX_ERROR;
+                break;
+            }
+            if(x == end) break;
+            emit_event(parser, &event_count, ~x);
+            result.token_count++;
+            token = input->next(input->context);
+            if(token < 0 || token > end) token = -1;
+            continue;
+        }
+        int rule = token < 0 ? PARSE_TABLE_ERROR : cells[(size_t)(x - columns) * columns + token];
+        if(rule == PARSE_TABLE_ERROR){
+            result.status = LL1_PARSE_SYNTAX_ERROR;
+            break;
+        }
+        emit_event(parser, &event_count, rule);
+        size_t n = (size_t)(rhs_start[rule + 1] - rhs_start[rule]);
+        if(top + n > capacity){
+            result.status = LL1_PARSE_STACK_OVERFLOW;
+            break;
+        }
+        memcpy(stack + top, rhs_codes + rhs_start[rule], n * sizeof(int32_t));
+        top += n;
+    }
+
+    if(result.status != LL1_PARSE_OK) result.error_terminal = token;
+    if(event_count && parser->sink) parser->sink(parser->sink_context, parser->events, event_count);
+    return result;
+}
@@ -0,0 +1,74 @@
+#ifndef LL1_PARSER_H
+#define LL1_PARSER_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "parse_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 输入：每次返回下一个 token 的终结符编号（grammar->terminals 中的下标），
+// 输入结束时返回 grammar->terminals_count，即 '$'
+typedef int (*TokenNext)(void* context);
+
+typedef struct TokenIterator{
+    TokenNext next;
+    void* context;
+} TokenIterator;
+
+// 现成的数组输入
+typedef struct TokenArray{
+    const int32_t* tokens;
+    size_t count;
+    size_t pos;
+    int end;    //结束符编号，即 terminals_count
+} TokenArray;
+
+int token_array_next(void* context);
+
+// 输出为最左推导的事件流：非负值为展开所用的产生式下标，负值 ~t 为匹配了终结符 t
+typedef int32_t ParseEvent;
+
+static inline bool parse_event_is_rule(ParseEvent event){ return event >= 0; }
+static inline int parse_event_rule(ParseEvent event){ return event; }
+static inline int parse_event_terminal(ParseEvent event){ return ~event; }
+
+// 事件缓冲写满或分析结束时调用，sink 为 NULL 时事件被丢弃（只做识别）
+typedef void (*ParseEventSink)(void* context, const ParseEvent* events, size_t count);
+
+typedef enum {
+    LL1_PARSE_OK = 0,
+    LL1_PARSE_SYNTAX_ERROR,
+    LL1_PARSE_STACK_OVERFLOW
+} LL1ParseStatus;
+
+typedef struct LL1ParseResult{
+    LL1ParseStatus status;
+    size_t token_count;     //已匹配的 token 数；出错时即出错 token 的下标
+    int error_terminal;     //出错时读到的终结符编号
+} LL1ParseResult;
+
+// 非递归的表驱动预测分析器。分析栈、事件缓冲与每条产生式逆序展开后的右部都在初始化时一次分配好，
+// 分析过程中不再分配内存：栈深超过 stack_capacity 时报 LL1_PARSE_STACK_OVERFLOW。
+// 栈上的终结符用其编号（'$' 为 terminals_count）表示，非终结符 A 用 column_count + A 表示，
+// 弹栈后一次比较即可区分，不必再查符号表
+typedef struct LL1Parser{
+    const Grammar* grammar;
+    const ParseTable* table;
+    int32_t* rhs_start;     //产生式 r 的逆序右部为 rhs_codes[rhs_start[r] .. rhs_start[r+1])
+    int32_t* rhs_codes;
+    int32_t* stack;
+    size_t stack_capacity;
+    ParseEvent* events;
+    size_t event_capacity;
+    ParseEventSink sink;
+    void* sink_context;
+} LL1Parser;
+
+bool ll1_parser_init(LL1Parser* parser, const Grammar* grammar, const ParseTable* table,
+                     size_t stack_capacity, size_t event_capacity,
+                     ParseEventSink sink, void* sink_context, Arena* arena);
+LL1ParseResult ll1_parse(LL1Parser* parser, TokenIterator* input);
+
+#endif
@@ -0,0 +1,144 @@
+#include "parse_table.h"
+#include "first_follow.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// 产生式右部的 First 集：依次并入各符号的 First 集，遇到终结符或不可空的非终结符为止
+static bool compute_rule_first(const Grammar* grammar, const SymbolSet* sets, const Rule* rule, uint64_t* out, size_t words){
+    for(uint32_t i = 0; i < rule->right_hs_count; i++){
+        SymbolId sym = rule->right_hs[i];
+        if(grammar_symbol_is_terminal(grammar, sym)){
+            bitset_add(out, grammar_terminal_id(grammar, sym));
+            return false;
+        }
+        const SymbolSet* set = &sets[grammar_nonterminal_id(grammar, sym)];
+        bitset_union(out, set->first, words);
+        if(!set->nullable) return false;
+    }
+    return true;
+}
+
+static bool record_conflict(ParseTable* table, uint32_t nonterminal, uint32_t terminal, int chosen, int rejected, Arena* arena){
+    if(table->conflict_count >= table->conflict_capacity){
+        uint32_t capacity = table->conflict_capacity ? table->conflict_capacity * 2 : 16;
+        TableConflict* conflicts = arena_alloc(arena, capacity * sizeof(TableConflict));
+        if(!conflicts){
+            fprintf(stderr, "Error: Failed to allocate memory for table conflicts.\n");
+            return false;
+        }
+        if(table->conflict_count) memcpy(conflicts, table->conflicts, table->conflict_count * sizeof(TableConflict));
+        table->conflicts = conflicts;
+        table->conflict_capacity = capacity;
+    }
+    table->conflicts[table->conflict_count++] = (TableConflict){ nonterminal, terminal, chosen, rejected };
+    return true;
+}
+
+/// 把产生式 rule 填入行 row 中 set 所含的每一列；格已被其他产生式占用时记录冲突，保留先填入的产生式
+static bool fill_row(ParseTable* table, uint32_t row, const uint64_t* set, int rule, Arena* arena){
+    int16_t* cells = table->cells + (size_t)row * table->column_count;
+    for(size_t w = 0; w < table->words; w++){
+        uint64_t bits = set[w];
+        while(bits){
+            uint32_t column = (uint32_t)(w * SYMBOL_SET_WORD_BITS + __builtin_ctzll(bits));
+            bits &= bits - 1;
+            if(cells[column] == PARSE_TABLE_ERROR){
+                cells[column] = (int16_t)rule;
+            }else if(cells[column] != rule){
+                if(!record_conflict(table, row, column, cells[column], rule, arena)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// 由 First/Follow 集构造预测分析表：对 A -> α，First(α) 中每个终结符 a 置 M[A, a] = A -> α；
+/// α 可空时 Follow(A) 中每个终结符（含 '$'）也置入。所有冲突都记录在 table->conflicts 中，
+/// 有冲突说明文法不是 LL(1) 的，但表仍然完整构造（每格保留编号最小的产生式）
+bool build_parse_table(const Grammar* grammar, const SymbolSet* sets, ParseTable* table, Arena* arena){
+    memset(table, 0, sizeof(ParseTable));
+    if(grammar->rule_count > INT16_MAX){
+        fprintf(stderr, "Error: Too many rules for parse table (%u > %d).\n", grammar->rule_count, INT16_MAX);
+        return false;
+    }
+    table->row_count = grammar->nonterminals_count;
+    table->column_count = grammar->terminals_count + 1;
+    table->words = symbol_set_words(grammar);
+
+    size_t cell_count = (size_t)table->row_count * table->column_count;
+    table->cells = arena_alloc(arena, (cell_count ? cell_count : 1) * sizeof(int16_t));
+    table->rule_first = arena_alloc(arena, ((size_t)grammar->rule_count * table->words + 1) * sizeof(uint64_t));
+    table->rule_nullable = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(bool));
+    if(!table->cells || !table->rule_first || !table->rule_nullable){
+        fprintf(stderr, "Error: Failed to allocate memory for parse table.\n");
+        return false;
+    }
+    memset(table->cells, 0xff, cell_count * sizeof(int16_t));
+    memset(table->rule_first, 0, (size_t)grammar->rule_count * table->words * sizeof(uint64_t));
+
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        uint32_t row = (uint32_t)grammar_nonterminal_id(grammar, rule->left_hs);
+        uint64_t* first = table->rule_first + (size_t)r * table->words;
+        table->rule_nullable[r] = compute_rule_first(grammar, sets, rule, first, table->words);
+        if(!fill_row(table, row, first, (int)r, arena)) return false;
+        if(table->rule_nullable[r] && !fill_row(table, row, sets[row].follow, (int)r, arena)) return false;
+    }
+    return true;
+}
+
+bool compress_parse_table(const ParseTable* table, bool default_rules, CompressedTable* out, Arena* arena){
+    size_t cell_count = (size_t)table->row_count * table->column_count;
+    int32_t* cells = arena_alloc(arena, (cell_count ? cell_count : 1) * sizeof(int32_t));
+    if(!cells){
+        fprintf(stderr, "Error: Failed to allocate memory for parse table.\n");
+        return false;
+    }
+    for(size_t i = 0; i < cell_count; i++) cells[i] = table->cells[i];
+    return compress_table(cells, table->row_count, table->column_count, PARSE_TABLE_ERROR, default_rules, out, arena);
+}
+
+static void print_rule(const Grammar* grammar, int rule){
+    fprint_symbol(stdout, grammar, grammar->rules[rule].left_hs);
+    printf(" -> ");
+    fprint_rule_rhs(stdout, grammar, &grammar->rules[rule]);
+}
+
+static void print_column(const Grammar* grammar, uint32_t column){
+    if(column == grammar->terminals_count) printf("$");
+    else fprint_symbol(stdout, grammar, grammar->terminals[column]);
+}
+
+/// 逐行打印表中的非空格：M[A, a] = A -> α
+void print_parse_table(const Grammar* grammar, const ParseTable* table){
+    for(uint32_t row = 0; row < table->row_count; row++){
+        for(uint32_t column = 0; column < table->column_count; column++){
+            int rule = parse_table_lookup(table, (int)row, (int)column);
+            if(rule == PARSE_TABLE_ERROR) continue;
+            printf("M[");
+            fprint_symbol(stdout, grammar, grammar->nonterminals[row]);
+            printf(", ");
+            print_column(grammar, column);
+            printf("] = ");
+            print_rule(grammar, rule);
+            printf("\n");
+        }
+    }
+}
+
+void print_table_conflicts(const Grammar* grammar, const ParseTable* table){
+    for(uint32_t i = 0; i < table->conflict_count; i++){
+        const TableConflict* c = &table->conflicts[i];
+        printf("Conflict at M[");
+        fprint_symbol(stdout, grammar, grammar->nonterminals[c->nonterminal]);
+        printf(", ");
+        print_column(grammar, c->terminal);
+        printf("]: ");
+        print_rule(grammar, c->chosen);
+        printf("  vs  ");
+        print_rule(grammar, c->rejected);
+        printf("\n");
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef PARSE_TABLE_H
+#define PARSE_TABLE_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "first_follow.h"
+#include "table_compress.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PARSE_TABLE_ERROR (-1)
+
+// 同一格中出现两条产生式：chosen 为先填入并保留在表中的产生式，rejected 为冲突的产生式
+typedef struct TableConflict{
+    uint32_t nonterminal;   //非终结符编号
+    uint32_t terminal;      //终结符编号，terminals_count 为 '$'
+    int32_t chosen;
+    int32_t rejected;
+} TableConflict;
+
+// LL(1) 预测分析表 M[A, a]：按行主序存放在一块连续内存中，每行对应一个非终结符，
+// 每列对应一个终结符（最后一列为 '$'），格中为产生式下标，PARSE_TABLE_ERROR 表示出错
+typedef struct ParseTable{
+    int16_t* cells;
+    uint32_t row_count;
+    uint32_t column_count;
+    uint64_t* rule_first;   //产生式 r 右部的 First 集位于 rule_first + r * words
+    bool* rule_nullable;    //产生式 r 的右部能否推出空串
+    size_t words;
+    TableConflict* conflicts;
+    uint32_t conflict_count;
+    uint32_t conflict_capacity;
+} ParseTable;
+
+static inline int parse_table_lookup(const ParseTable* table, int nonterminal, int terminal){
+    return table->cells[(size_t)nonterminal * table->column_count + terminal];
+}
+
+static inline const uint64_t* parse_table_rule_first(const ParseTable* table, uint32_t rule){
+    return table->rule_first + (size_t)rule * table->words;
+}
+
+bool build_parse_table(const Grammar* grammar, const SymbolSet* sets, ParseTable* table, Arena* arena);
+// 压缩预测分析表（等价列 + 行默认值 + 行位移），查表用 compressed_table_lookup，出错格为 PARSE_TABLE_ERROR。
+// default_rules 为 true 时每行出现最多的产生式同时充当该行出错格的取值：分析器会先按它展开，
+// 在匹配下一个终结符前报错，不会多读入 token
+bool compress_parse_table(const ParseTable* table, bool default_rules, CompressedTable* out, Arena* arena);
+void print_parse_table(const Grammar* grammar, const ParseTable* table);
+void print_table_conflicts(const Grammar* grammar, const ParseTable* table);
+
+#endif
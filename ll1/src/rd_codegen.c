@@ -0,0 +1,239 @@
+#include "rd_codegen.h"
+#include "parse_table.h"
+#include "grammar.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+/// 在注释中写出符号，拆开其中的 "*/"
+static void emit_comment_symbol(FILE* out, const Grammar* grammar, SymbolId symbol){
+    char buffer[256];
+    size_t len = format_symbol(grammar, symbol, buffer, sizeof(buffer));
+    if(len >= sizeof(buffer)) len = sizeof(buffer) - 1;
+    for(size_t i = 0; i < len; i++){
+        fputc(buffer[i], out);
+        if(buffer[i] == '*' && buffer[i + 1] == '/') fputc(' ', out);
+    }
+}
+
+static void emit_comment_column(FILE* out, const Grammar* grammar, uint32_t column){
+    if(column == grammar->terminals_count) fputs("$", out);
+    else emit_comment_symbol(out, grammar, grammar->terminals[column]);
+}
+
+static void emit_comment_rule(FILE* out, const Grammar* grammar, uint32_t rule){
+    const Rule* r = &grammar->rules[rule];
+    emit_comment_symbol(out, grammar, r->left_hs);
+    fputs(" ->", out);
+    if(r->right_hs_count == 0) fputs(" #", out);
+    for(uint32_t i = 0; i < r->right_hs_count; i++){
+        fputc(' ', out);
+        emit_comment_symbol(out, grammar, r->right_hs[i]);
+    }
+}
+
+#define RD_MAX_PREFIX 48
+
+/// 前缀的大写形式，用于生成的宏名
+static void upper_prefix(const char* p, char* out){
+    size_t n = 0;
+    for(; p[n] && n < RD_MAX_PREFIX; n++) out[n] = (char)toupper((unsigned char)p[n]);
+    out[n] = '\0';
+}
+
+/// 固定部分：分析器状态、读入 token、事件缓冲
+static void emit_prologue(FILE* out, const char* p, const char* header, uint32_t end){
+    char upper[RD_MAX_PREFIX + 1];
+    upper_prefix(p, upper);
+    fprintf(out,
+        "// 由 rd_codegen 生成的递归下降分析器，请勿手工修改\n"
+        "#include <stdbool.h>\n"
+        "#include <stddef.h>\n"
+        "#include <string.h>\n"
+        "#include \"%s\"\n"
+        "\n"
+        "#define %s_END %u\n"
+        "\n"
+        "typedef struct %s_parser{\n"
+        "    TokenIterator* input;\n"
+        "    int token;\n"
+        "    size_t token_count;\n"
+        "    ParseEvent* events;\n"
+        "    size_t event_count;\n"
+        "    size_t event_capacity;\n"
+        "    ParseEventSink sink;\n"
+        "    void* sink_context;\n"
+        "    size_t depth;\n"
+        "    size_t max_depth;\n"
+        "    LL1ParseStatus status;\n"
+        "} %s_parser;\n"
+        "\n"
+        "static inline void %s_advance(%s_parser* p){\n"
+        "    int token = p->input->next(p->input->context);\n"
+        "    p->token = (token < 0 || token > %s_END) ? -1 : token;\n"
+        "}\n"
+        "\n"
+        "static inline void %s_emit(%s_parser* p, ParseEvent event){\n"
+        "    if(p->event_count == p->event_capacity){\n"
+        "        if(p->sink) p->sink(p->sink_context, p->events, p->event_count);\n"
+        "        p->event_count = 0;\n"
+        "    }\n"
+        "    p->events[p->event_count++] = event;\n"
+        "}\n"
+        "\n"
+        "static inline bool %s_expect(%s_parser* p, int terminal){\n"
+        "    if(p->token != terminal){\n"
+        "        p->status = LL1_PARSE_SYNTAX_ERROR;\n"
+        "        return false;\n"
+        "    }\n"
+        "    %s_emit(p, ~terminal);\n"
+        "    p->token_count++;\n"
+        "    %s_advance(p);\n"
+        "    return true;\n"
+        "}\n"
+        "\n",
+        header, upper, end, p, p, p, p, upper, p, p, p, p, p, p);
+}
+
+/// 产生式右部：终结符逐个匹配（case 已经确认过的首个终结符直接接受），非终结符调用对应函数；
+/// 最后一个符号为自身时回到循环开头，为其他非终结符时尾调用
+static void emit_rule_body(FILE* out, const Grammar* grammar, const char* p, uint32_t row, uint32_t rule){
+    const Rule* r = &grammar->rules[rule];
+    fprintf(out, "            %s_emit(p, %u);\n", p, rule);
+    for(uint32_t i = 0; i < r->right_hs_count; i++){
+        SymbolId sym = r->right_hs[i];
+        bool last = (i + 1 == r->right_hs_count);
+        if(grammar_symbol_is_terminal(grammar, sym)){
+            int t = grammar_terminal_id(grammar, sym);
+            if(i == 0){
+                fprintf(out, "            %s_emit(p, ~%d);\n", p, t);
+                fprintf(out, "            p->token_count++;\n");
+                fprintf(out, "            %s_advance(p);\n", p);
+            }else{
+                fprintf(out, "            if(!%s_expect(p, %d)) return false;\n", p, t);
+            }
+            continue;
+        }
+        int nt = grammar_nonterminal_id(grammar, sym);
+        if(last && (uint32_t)nt == row){
+            fprintf(out, "            continue;\n");
+            return;
+        }
+        if(last){
+            fprintf(out, "            p->depth--;\n");
+            fprintf(out, "            return %s_parse_%d(p);\n", p, nt);
+            return;
+        }
+        fprintf(out, "            if(!%s_parse_%d(p)) return false;\n", p, nt);
+    }
+    fprintf(out, "            p->depth--;\n");
+    fprintf(out, "            return true;\n");
+}
+
+static bool rule_is_self_tail(const Grammar* grammar, uint32_t rule){
+    const Rule* r = &grammar->rules[rule];
+    return r->right_hs_count > 0 && r->right_hs[r->right_hs_count - 1] == r->left_hs;
+}
+
+static void emit_nonterminal(FILE* out, const Grammar* grammar, const ParseTable* table, const char* p, uint32_t row){
+    bool loop = false;
+    fprintf(out, "/*\n");
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        if(grammar_nonterminal_id(grammar, grammar->rules[r].left_hs) != (int)row) continue;
+        fprintf(out, " * %u: ", r);
+        emit_comment_rule(out, grammar, r);
+        fputc('\n', out);
+        loop = loop || rule_is_self_tail(grammar, r);
+    }
+    fprintf(out, " */\n");
+    fprintf(out, "static bool %s_parse_%u(%s_parser* p){\n", p, row, p);
+    fprintf(out, "    if(++p->depth > p->max_depth){\n");
+    fprintf(out, "        p->status = LL1_PARSE_STACK_OVERFLOW;\n");
+    fprintf(out, "        return false;\n");
+    fprintf(out, "    }\n");
+    if(loop) fprintf(out, "    for(;;){\n");
+    else fprintf(out, "    {\n");
+    fprintf(out, "        switch(p->token){\n");
+
+    // 同一产生式的所有列合并为一组 case
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        bool any = false;
+        for(uint32_t c = 0; c < table->column_count; c++){
+            if(parse_table_lookup(table, (int)row, (int)c) != (int)r) continue;
+            fprintf(out, "        case %u: /* ", c);
+            emit_comment_column(out, grammar, c);
+            fprintf(out, " */\n");
+            any = true;
+        }
+        if(any) emit_rule_body(out, grammar, p, row, r);
+    }
+    fprintf(out, "        default:\n");
+    fprintf(out, "            p->status = LL1_PARSE_SYNTAX_ERROR;\n");
+    fprintf(out, "            return false;\n");
+    fprintf(out, "        }\n");
+    fprintf(out, "    }\n");
+    fprintf(out, "}\n\n");
+}
+
+static void emit_entry(FILE* out, const char* p, int start){
+    char upper[RD_MAX_PREFIX + 1];
+    upper_prefix(p, upper);
+    fprintf(out,
+        "LL1ParseResult %s_parse(TokenIterator* input, ParseEvent* events, size_t event_capacity,\n"
+        "                        ParseEventSink sink, void* sink_context, size_t max_depth){\n"
+        "    %s_parser p;\n"
+        "    memset(&p, 0, sizeof(p));\n"
+        "    p.input = input;\n"
+        "    p.events = events;\n"
+        "    p.event_capacity = event_capacity;\n"
+        "    p.sink = sink;\n"
+        "    p.sink_context = sink_context;\n"
+        "    p.max_depth = max_depth;\n"
+        "    p.status = LL1_PARSE_OK;\n"
+        "    %s_advance(&p);\n"
+        "    if(%s_parse_%d(&p) && p.token != %s_END) p.status = LL1_PARSE_SYNTAX_ERROR;\n"
+        "    if(p.event_count && p.sink) p.sink(p.sink_context, p.events, p.event_count);\n"
+        "    LL1ParseResult result = { p.status, p.token_count, p.status == LL1_PARSE_OK ? -1 : p.token };\n"
+        "    return result;\n"
+        "}\n",
+        p, p, p, p, start, upper);
+}
+
+static bool valid_prefix(const char* prefix){
+    if(!prefix || !(isalpha((unsigned char)prefix[0]) || prefix[0] == '_')) return false;
+    if(strlen(prefix) > RD_MAX_PREFIX) return false;
+    for(const char* c = prefix; *c; c++){
+        if(!isalnum((unsigned char)*c) && *c != '_') return false;
+    }
+    return true;
+}
+
+bool generate_rd_parser(const Grammar* grammar, const ParseTable* table,
+                        const char* prefix, const char* header, FILE* out)
+{
+    if(!grammar || !table || !out || !header || grammar->start_symbol == GRAMMAR_NO_SYMBOL){
+        fprintf(stderr, "Error: Invalid arguments for parser generation.\n");
+        return false;
+    }
+    if(!valid_prefix(prefix)){
+        fprintf(stderr, "Error: Prefix '%s' is not a C identifier.\n", prefix ? prefix : "");
+        return false;
+    }
+    if(table->conflict_count){
+        fprintf(stderr, "Error: Grammar is not LL(1) (%u conflicts), no parser generated.\n", table->conflict_count);
+        return false;
+    }
+
+    emit_prologue(out, prefix, header, grammar->terminals_count);
+    // 先声明全部函数，互相递归的非终结符不受定义顺序影响
+    for(uint32_t row = 0; row < table->row_count; row++){
+        fprintf(out, "static bool %s_parse_%u(%s_parser* p);\n", prefix, row, prefix);
+    }
+    fputc('\n', out);
+    for(uint32_t row = 0; row < table->row_count; row++){
+        emit_nonterminal(out, grammar, table, prefix, row);
+    }
+    emit_entry(out, prefix, grammar_nonterminal_id(grammar, grammar->start_symbol));
+    return !ferror(out);
+}
@@ -0,0 +1,17 @@
+#ifndef RD_CODEGEN_H
+#define RD_CODEGEN_H
+
+#include "grammar.h"
+#include "parse_table.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// 由 LL(1) 预测分析表生成递归下降分析器的 C 源码：每个非终结符一个函数，按向前看的终结符 switch 选择产生式，
+// 产生式以自身结尾（A -> α A）时改写为循环，以其他非终结符结尾时改写为尾调用。
+// 生成的 <prefix>_parse 与 ll1_parse 约定相同：输入为 TokenIterator，输出同样的 ParseEvent 事件流，
+// max_depth 限制递归深度。header 为生成文件中 #include 的 ll1_parser.h 路径。
+// 表中有冲突时不生成，返回 false
+bool generate_rd_parser(const Grammar* grammar, const ParseTable* table,
+                        const char* prefix, const char* header, FILE* out);
+
+#endif
@@ -0,0 +1,216 @@
+#include "table_compress.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t column_hash(const int32_t* cells, uint32_t row_count, uint32_t column_count, uint32_t column){
+    uint64_t hash = 1469598103934665603ULL;
+    for(uint32_t r = 0; r < row_count; r++){
+        hash ^= (uint32_t)cells[(size_t)r * column_count + column];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool column_equal(const int32_t* cells, uint32_t row_count, uint32_t column_count, uint32_t a, uint32_t b){
+    for(uint32_t r = 0; r < row_count; r++){
+        const int32_t* row = cells + (size_t)r * column_count;
+        if(row[a] != row[b]) return false;
+    }
+    return true;
+}
+
+/// 合并取值完全相同的列：以列内容的哈希为键的开放寻址表，返回等价列数，representative[k] 为等价列 k 的首列
+static uint32_t merge_columns(const int32_t* cells, uint32_t row_count, uint32_t column_count,
+                              uint32_t* column_class, uint32_t* representative, Arena* arena){
+    uint32_t capacity = 16;
+    while(capacity < column_count * 2) capacity *= 2;
+    int32_t* slots = arena_alloc(arena, capacity * sizeof(int32_t));
+    uint64_t* hashes = arena_alloc(arena, column_count * sizeof(uint64_t));
+    if(!slots || !hashes) return 0;
+    memset(slots, 0xff, capacity * sizeof(int32_t));
+
+    uint32_t class_count = 0;
+    for(uint32_t c = 0; c < column_count; c++){
+        hashes[c] = column_hash(cells, row_count, column_count, c);
+        uint32_t i = (uint32_t)hashes[c] & (capacity - 1);
+        while(slots[i] >= 0){
+            uint32_t k = (uint32_t)slots[i];
+            uint32_t other = representative[k];
+            if(hashes[other] == hashes[c] && column_equal(cells, row_count, column_count, other, c)) break;
+            i = (i + 1) & (capacity - 1);
+        }
+        if(slots[i] < 0){
+            slots[i] = (int32_t)class_count;
+            representative[class_count++] = c;
+        }
+        column_class[c] = (uint32_t)slots[i];
+    }
+    return class_count;
+}
+
+static int compare_int32(const void* a, const void* b){
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/// 行中出现次数最多的值；fill_errors 时不计出错格，整行出错时仍返回 error
+static int32_t row_mode(int32_t* values, uint32_t count, int32_t error, bool fill_errors){
+    qsort(values, count, sizeof(int32_t), compare_int32);
+    int32_t best = error;
+    uint32_t best_run = 0;
+    for(uint32_t i = 0; i < count;){
+        uint32_t j = i;
+        while(j < count && values[j] == values[i]) j++;
+        if(!(fill_errors && values[i] == error) && j - i > best_run){
+            best = values[i];
+            best_run = j - i;
+        }
+        i = j;
+    }
+    return best;
+}
+
+typedef struct RowOrder{
+    uint32_t row;
+    uint32_t entries;
+} RowOrder;
+
+static int compare_row_order(const void* a, const void* b){
+    const RowOrder* x = a;
+    const RowOrder* y = b;
+    if(x->entries != y->entries) return x->entries < y->entries ? 1 : -1;
+    return (x->row > y->row) - (x->row < y->row);
+}
+
+/// 按需扩展 check/value，新槽置空
+static bool reserve_slots(int32_t** check, int32_t** value, uint32_t* capacity, uint32_t needed, Arena* arena){
+    if(needed <= *capacity) return true;
+    uint32_t new_capacity = *capacity ? *capacity : 64;
+    while(new_capacity < needed) new_capacity *= 2;
+    int32_t* new_check = arena_alloc(arena, new_capacity * sizeof(int32_t));
+    int32_t* new_value = arena_alloc(arena, new_capacity * sizeof(int32_t));
+    if(!new_check || !new_value) return false;
+    if(*capacity){
+        memcpy(new_check, *check, *capacity * sizeof(int32_t));
+        memcpy(new_value, *value, *capacity * sizeof(int32_t));
+    }
+    memset(new_check + *capacity, 0xff, (new_capacity - *capacity) * sizeof(int32_t));
+    memset(new_value + *capacity, 0, (new_capacity - *capacity) * sizeof(int32_t));
+    *check = new_check;
+    *value = new_value;
+    *capacity = new_capacity;
+    return true;
+}
+
+bool compress_table(const int32_t* cells, uint32_t row_count, uint32_t column_count,
+                    int32_t error, bool fill_errors, CompressedTable* table, Arena* arena){
+    memset(table, 0, sizeof(CompressedTable));
+    table->row_count = row_count;
+    table->column_count = column_count;
+    table->column_class = arena_alloc(arena, (column_count + 1) * sizeof(uint32_t));
+    table->row_default = arena_alloc(arena, (row_count + 1) * sizeof(int32_t));
+    table->row_base = arena_alloc(arena, (row_count + 1) * sizeof(uint32_t));
+    uint32_t* representative = arena_alloc(arena, (column_count + 1) * sizeof(uint32_t));
+    if(!table->column_class || !table->row_default || !table->row_base || !representative){
+        fprintf(stderr, "Error: Failed to allocate memory for compressed table.\n");
+        return false;
+    }
+    table->class_count = merge_columns(cells, row_count, column_count, table->column_class, representative, arena);
+    if(column_count && !table->class_count){
+        fprintf(stderr, "Error: Failed to allocate memory for compressed table.\n");
+        return false;
+    }
+    uint32_t classes = table->class_count;
+
+    // 每行的非默认格按 CSR 存放：行 r 的格为 entry_class/entry_value[entry_start[r] .. entry_start[r+1])
+    int32_t* scratch = arena_alloc(arena, (classes + 1) * sizeof(int32_t));
+    uint32_t* entry_start = arena_alloc(arena, (row_count + 1) * sizeof(uint32_t));
+    RowOrder* order = arena_alloc(arena, (row_count + 1) * sizeof(RowOrder));
+    size_t entry_capacity = 64;
+    size_t entry_count = 0;
+    uint32_t* entry_class = arena_alloc(arena, entry_capacity * sizeof(uint32_t));
+    int32_t* entry_value = arena_alloc(arena, entry_capacity * sizeof(int32_t));
+    if(!scratch || !entry_start || !order || !entry_class || !entry_value){
+        fprintf(stderr, "Error: Failed to allocate memory for compressed table.\n");
+        return false;
+    }
+    for(uint32_t r = 0; r < row_count; r++){
+        const int32_t* row = cells + (size_t)r * column_count;
+        for(uint32_t k = 0; k < classes; k++) scratch[k] = row[representative[k]];
+        int32_t fallback = row_mode(scratch, classes, error, fill_errors);
+        table->row_default[r] = fallback;
+        entry_start[r] = (uint32_t)entry_count;
+        for(uint32_t k = 0; k < classes; k++){
+            int32_t v = row[representative[k]];
+            if(v == fallback || (fill_errors && v == error)) continue;
+            if(entry_count >= entry_capacity){
+                size_t new_capacity = entry_capacity * 2;
+                uint32_t* new_class = arena_alloc(arena, new_capacity * sizeof(uint32_t));
+                int32_t* new_value = arena_alloc(arena, new_capacity * sizeof(int32_t));
+                if(!new_class || !new_value){
+                    fprintf(stderr, "Error: Failed to allocate memory for compressed table.\n");
+                    return false;
+                }
+                memcpy(new_class, entry_class, entry_count * sizeof(uint32_t));
+                memcpy(new_value, entry_value, entry_count * sizeof(int32_t));
+                entry_class = new_class;
+                entry_value = new_value;
+                entry_capacity = new_capacity;
+            }
+            entry_class[entry_count] = k;
+            entry_value[entry_count++] = v;
+        }
+        order[r] = (RowOrder){ r, (uint32_t)entry_count - entry_start[r] };
+    }
+    entry_start[row_count] = (uint32_t)entry_count;
+
+    // 先放格多的行（first fit）：找最小的 base，使本行每个格落在空槽上
+    qsort(order, row_count, sizeof(RowOrder), compare_row_order);
+    uint32_t capacity = 0;
+    int32_t* check = NULL;
+    int32_t* value = NULL;
+    uint32_t first_free = 0;  //first_free 之前的槽全部占用
+    uint32_t max_base = 0;
+    for(uint32_t i = 0; i < row_count; i++){
+        uint32_t r = order[i].row;
+        uint32_t begin = entry_start[r], end = entry_start[r + 1];
+        table->row_base[r] = 0;
+        if(begin == end) continue;
+        uint32_t base = first_free > entry_class[begin] ? first_free - entry_class[begin] : 0;
+        for(;; base++){
+            if(!reserve_slots(&check, &value, &capacity, base + classes, arena)){
+                fprintf(stderr, "Error: Failed to allocate memory for compressed table.\n");
+                return false;
+            }
+            uint32_t e = begin;
+            while(e < end && check[base + entry_class[e]] == COMPRESSED_TABLE_EMPTY) e++;
+            if(e == end) break;
+        }
+        for(uint32_t e = begin; e < end; e++){
+            check[base + entry_class[e]] = (int32_t)r;
+            value[base + entry_class[e]] = entry_value[e];
+        }
+        table->row_base[r] = base;
+        if(base > max_base) max_base = base;
+        while(first_free < capacity && check[first_free] != COMPRESSED_TABLE_EMPTY) first_free++;
+    }
+
+    // 任意行的 row_base + class 都必须落在数组内
+    table->slot_count = max_base + classes;
+    if(!reserve_slots(&check, &value, &capacity, table->slot_count + 1, arena)){
+        fprintf(stderr, "Error: Failed to allocate memory for compressed table.\n");
+        return false;
+    }
+    table->check = check;
+    table->value = value;
+    return true;
+}
+
+size_t compressed_table_bytes(const CompressedTable* table){
+    return sizeof(CompressedTable)
+         + (size_t)table->column_count * sizeof(uint32_t)
+         + (size_t)table->row_count * (sizeof(int32_t) + sizeof(uint32_t))
+         + (size_t)table->slot_count * 2 * sizeof(int32_t);
+}
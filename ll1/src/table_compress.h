@@ -0,0 +1,38 @@
+#ifndef TABLE_COMPRESS_H
+#define TABLE_COMPRESS_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMPRESSED_TABLE_EMPTY (-1)
+
+// 压缩后的二维分析表。取值完全相同的列合并为一个等价列；每行取出现最多的值作为默认值，
+// 其余格按行位移（comb vector）叠放在 value/check 中：行 r 的等价列 k 位于 row_base[r] + k，
+// check 中记录该槽属于哪一行，不属于本行时取默认值。查表始终是两次下标访问
+typedef struct CompressedTable{
+    uint32_t row_count;
+    uint32_t column_count;      //原表列数
+    uint32_t class_count;       //等价列数
+    uint32_t* column_class;     //原列 c 所属的等价列
+    int32_t* row_default;
+    uint32_t* row_base;
+    int32_t* value;
+    int32_t* check;             //COMPRESSED_TABLE_EMPTY 表示空槽
+    uint32_t slot_count;
+} CompressedTable;
+
+static inline int32_t compressed_table_lookup(const CompressedTable* table, uint32_t row, uint32_t column){
+    uint32_t slot = table->row_base[row] + table->column_class[column];
+    return table->check[slot] == (int32_t)row ? table->value[slot] : table->row_default[row];
+}
+
+// 压缩按行主序存放的 row_count × column_count 表，error 为出错格的取值。
+// fill_errors 为 false 时压缩是无损的；为 true 时出错格视为“任意值”，可以被行默认值覆盖
+// （LR 的默认归约、LL 的默认产生式：出错会推迟到下一次匹配终结符之前发现，但不会读入错误的 token）
+bool compress_table(const int32_t* cells, uint32_t row_count, uint32_t column_count,
+                    int32_t error, bool fill_errors, CompressedTable* table, Arena* arena);
+size_t compressed_table_bytes(const CompressedTable* table);
+
+#endif
@@ -0,0 +1,130 @@
+// bench_cache.c
+// 分析结果缓存的基准：同一个大文法，比较完整分析（读入、First/Follow、预测分析表）与从缓存映射恢复的启动耗时。
+// clang -std=c11 -O2 bench_cache.c -o bench_cache -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+#include "../src/grammar_cache.h"
+#include "../src/grammar_cache.c"
+
+#include "../src/ll1_cache.h"
+#include "../src/ll1_cache.c"
+
+#define GRAMMAR_FILE "bench_cache_grammar.txt"
+#define CACHE_FILE "bench_cache_grammar.cache"
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+/// 与 bench_parser 相同的语句文法：每种语句以自己的关键字开头，带若干可选的子句
+static bool write_statement_grammar(const char* filename, int kinds) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "<program> -> <stmt> <program> | #\n");
+    for (int i = 0; i < kinds; i++) fprintf(f, "<stmt> -> 'kw%d' <body%d> ';'\n", i, i);
+    for (int i = 0; i < kinds; i++) {
+        fprintf(f, "<body%d> -> 'id' <tail%d>\n", i, i);
+        fprintf(f, "<tail%d> -> 'op%d' 'id' <tail%d> | ',' 'id' <tail%d> | #\n", i, i % 16, i, i);
+    }
+    fclose(f);
+    return true;
+}
+
+/// 完整分析一次并返回预测分析表的行数，失败返回 0
+static uint32_t analyse(uint64_t* key, bool save) {
+    Arena* arena = arena_create(256 * 1024 * 1024);
+    uint32_t rows = 0;
+    GrammarResultGrammar res = read_grammar(GRAMMAR_FILE, arena);
+    if (res.status == GRAMMAR_OK && grammar_cache_key(GRAMMAR_FILE, "bench", key)) {
+        Grammar* g = res.value;
+        SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+        int count = 0;
+        ParseTable table;
+        compute_first_sets(g, sets, &count, arena);
+        compute_follow_sets(g, sets, &count, arena);
+        if (build_parse_table(g, sets, &table, arena)) {
+            rows = table.row_count;
+            GrammarCacheWriter writer;
+            grammar_cache_writer_init(&writer);
+            if (save && !(grammar_cache_put_grammar(&writer, g, arena) && cache_put_symbol_sets(&writer, g, sets, count, arena) &&
+                          cache_put_parse_table(&writer, g, &table, arena) && grammar_cache_write(CACHE_FILE, *key, &writer))) {
+                rows = 0;
+            }
+        }
+    }
+    arena_free(arena);
+    return rows;
+}
+
+/// 从缓存恢复一次，与启动时的路径相同：计算文法文件的键、映射缓存、恢复文法/集合/表
+static uint32_t load(void) {
+    Arena* arena = arena_create(256 * 1024 * 1024);
+    uint32_t rows = 0;
+    uint64_t key;
+    GrammarCache cache;
+    if (grammar_cache_key(GRAMMAR_FILE, "bench", &key) && grammar_cache_open(CACHE_FILE, key, &cache)) {
+        Grammar* g = grammar_cache_load_grammar(&cache, arena);
+        int count = 0;
+        ParseTable table;
+        if (g && cache_load_symbol_sets(&cache, g, &count, arena) && cache_load_parse_table(&cache, g, &table)) {
+            rows = table.row_count;
+        }
+        grammar_cache_close(&cache);
+    }
+    arena_free(arena);
+    return rows;
+}
+
+int main(void) {
+    if (!write_statement_grammar(GRAMMAR_FILE, 3000)) return 1;
+    uint64_t key;
+    if (!analyse(&key, true)) return 1;
+    FILE* f = fopen(CACHE_FILE, "rb");
+    fseek(f, 0, SEEK_END);
+    long cache_size = ftell(f);
+    fclose(f);
+
+    int rounds = 5;
+    uint32_t rows = 0;
+    clock_t begin = clock();
+    for (int i = 0; i < rounds; i++) rows = analyse(&key, false);
+    double full = seconds_since(begin) / rounds;
+    begin = clock();
+    for (int i = 0; i < rounds; i++) rows = load() ? rows : 0;
+    double cached = seconds_since(begin) / rounds;
+    remove(GRAMMAR_FILE);
+    remove(CACHE_FILE);
+    if (!rows) return 1;
+
+    printf("grammar: %u nonterminals, cache file %.1f MB\n", rows, cache_size / 1e6);
+    printf("full analysis %.2f ms, from cache %.2f ms (%.0fx)\n", full * 1e3, cached * 1e3, full / cached);
+    return 0;
+}
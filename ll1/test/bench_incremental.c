@@ -0,0 +1,101 @@
+// bench_incremental.c
+// 增量维护 First/Follow 的基准：在大文法上逐条增删产生式，比较每次编辑的增量更新与从头计算的耗时。
+// clang -std=c11 -O2 bench_incremental.c -o bench_incremental -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/incremental_sets.h"
+#include "../src/incremental_sets.c"
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+/// 分层的语句文法：每层若干非终结符，右部引用下一层，部分产生式可空
+static bool write_layered_grammar(const char* filename, int layers, int width) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "<start> -> <n0_0> 'end'\n");
+    for (int l = 0; l < layers; l++) {
+        for (int w = 0; w < width; w++) {
+            int next = l + 1 < layers ? l + 1 : l;
+            fprintf(f, "<n%d_%d> -> 't%d' <n%d_%d> <n%d_%d> | <n%d_%d> 'u%d'", l, w, (l * 7 + w) % 200, next, (w + 1) % width,
+                    next, (w + 3) % width, next, w, w % 50);
+            if (w % 5 == 0) fprintf(f, " | #");
+            fprintf(f, "\n");
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+int main(void) {
+    Arena* arena = arena_create(512 * 1024 * 1024);
+    if (!write_layered_grammar("bench_incremental_grammar.txt", 40, 50)) return 1;
+    GrammarResultGrammar res = read_grammar("bench_incremental_grammar.txt", arena);
+    remove("bench_incremental_grammar.txt");
+    if (res.status != GRAMMAR_OK) return 1;
+    Grammar* g = res.value;
+
+    IncrementalSets inc;
+    if (!incremental_sets_init(&inc, g, arena)) return 1;
+    printf("grammar: %u nonterminals, %u terminals, %u rules\n", g->nonterminals_count, g->terminals_count, g->rule_count);
+
+    // 从头计算一次的耗时
+    int rounds = 20;
+    clock_t begin = clock();
+    for (int i = 0; i < rounds; i++) {
+        Arena* scratch = arena_create(64 * 1024 * 1024);
+        SymbolSet* sets = arena_alloc(scratch, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+        int count = 0;
+        compute_first_sets(g, sets, &count, scratch);
+        compute_follow_sets(g, sets, &count, scratch);
+        arena_free(scratch);
+    }
+    double full = seconds_since(begin) / rounds;
+
+    // 随机加入一条产生式再删掉，文法保持原样
+    int edits = 2000;
+    srand(9);
+    double add_time = 0, remove_time = 0;
+    for (int i = 0; i < edits; i++) {
+        SymbolId rhs[3];
+        uint32_t count = (uint32_t)(rand() % 4);
+        for (uint32_t k = 0; k < count; k++) {
+            rhs[k] = rand() % 3 ? g->nonterminals[rand() % g->nonterminals_count] : g->terminals[rand() % g->terminals_count];
+        }
+        SymbolId lhs = g->nonterminals[rand() % g->nonterminals_count];
+        begin = clock();
+        if (!incremental_add_rule(&inc, lhs, rhs, count)) return 1;
+        add_time += seconds_since(begin);
+        begin = clock();
+        if (!incremental_remove_rule(&inc, g->rule_count - 1)) return 1;
+        remove_time += seconds_since(begin);
+    }
+    printf("full recompute: %10.1f us\n", full * 1e6);
+    printf("add rule:       %10.1f us\n", add_time / edits * 1e6);
+    printf("remove rule:    %10.1f us\n", remove_time / edits * 1e6);
+    arena_free(arena);
+    return 0;
+}
@@ -0,0 +1,225 @@
+// bench_parser.c
+// 预测分析的吞吐量基准：在随机生成的表达式 token 流上，对比表驱动 LL(1) 分析器与
+// 由同一张表生成的递归下降分析器（bench_rd_parser.c）每秒处理的 token 数；
+// 并在一个较大的合成文法上比较稠密预测分析表与压缩表的大小和查表速度。
+// clang -std=c11 -O2 bench_parser.c -o bench_parser -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+#include "../src/ll1_parser.h"
+#include "../src/ll1_parser.c"
+
+// gen_parser bench_grammar.txt bench_rd_parser.c bench ../src/ll1_parser.h
+#include "bench_rd_parser.c"
+
+typedef struct {
+    int32_t* tokens;
+    size_t count;
+    size_t capacity;
+    int id, num, plus, minus, star, slash, lparen, rparen;
+} TokenBuffer;
+
+static void push(TokenBuffer* b, int token) {
+    if (b->count < b->capacity) b->tokens[b->count++] = token;
+}
+
+static void gen_expr(TokenBuffer* b, int depth);
+
+static void gen_factor(TokenBuffer* b, int depth) {
+    int r = rand() % 8;
+    if (depth > 0 && r == 0) {
+        push(b, b->lparen);
+        gen_expr(b, depth - 1);
+        push(b, b->rparen);
+    } else {
+        push(b, r & 1 ? b->id : b->num);
+    }
+}
+
+static void gen_term(TokenBuffer* b, int depth) {
+    gen_factor(b, depth);
+    while (rand() % 3 == 0) {
+        push(b, rand() & 1 ? b->star : b->slash);
+        gen_factor(b, depth);
+    }
+}
+
+static void gen_expr(TokenBuffer* b, int depth) {
+    gen_term(b, depth);
+    while (rand() % 2 == 0) {
+        push(b, rand() & 1 ? b->plus : b->minus);
+        gen_term(b, depth);
+    }
+}
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+static void count_events(void* context, const ParseEvent* events, size_t count) {
+    (void)events;
+    *(size_t*)context += count;
+}
+
+static int terminal(Grammar* g, const char* name) {
+    return grammar_terminal_id(g, grammar_lookup_symbol(g, name, strlen(name)));
+}
+
+/// 合成的语句文法：每种语句以自己的关键字开头，带若干可选的子句，行多列多而表很稀疏
+static bool write_statement_grammar(const char* filename, int kinds) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "<program> -> <stmt> <program> | #\n");
+    for (int i = 0; i < kinds; i++) fprintf(f, "<stmt> -> 'kw%d' <body%d> ';'\n", i, i);
+    for (int i = 0; i < kinds; i++) {
+        fprintf(f, "<body%d> -> 'id' <tail%d>\n", i, i);
+        fprintf(f, "<tail%d> -> 'op%d' 'id' <tail%d> | ',' 'id' <tail%d> | #\n", i, i % 16, i, i);
+    }
+    fclose(f);
+    return true;
+}
+
+static void bench_table_size(void) {
+    Arena* arena = arena_create(64 * 1024 * 1024);
+    if (!write_statement_grammar("bench_large_grammar.txt", 600)) return;
+    GrammarResultGrammar res = read_grammar("bench_large_grammar.txt", arena);
+    remove("bench_large_grammar.txt");
+    if (res.status != GRAMMAR_OK) return;
+    Grammar* g = res.value;
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int set_count = 0;
+    ParseTable table;
+    CompressedTable compressed;
+    compute_first_sets(g, sets, &set_count, arena);
+    compute_follow_sets(g, sets, &set_count, arena);
+    if (!build_parse_table(g, sets, &table, arena) || !compress_parse_table(&table, false, &compressed, arena)) return;
+
+    size_t dense = (size_t)table.row_count * table.column_count * sizeof(int16_t);
+    printf("table %u x %u: dense %zu bytes, compressed %zu bytes (%.1f%%), %u column classes\n",
+           table.row_count, table.column_count, dense, compressed_table_bytes(&compressed),
+           100.0 * compressed_table_bytes(&compressed) / dense, compressed.class_count);
+
+    // 随机查表，两种表的结果必须一致
+    size_t lookups = 20000000;
+    uint32_t* keys = malloc(1024 * 2 * sizeof(uint32_t));
+    srand(2);
+    for (int i = 0; i < 1024; i++) {
+        keys[2 * i] = (uint32_t)rand() % table.row_count;
+        keys[2 * i + 1] = (uint32_t)rand() % table.column_count;
+    }
+    long dense_sum = 0, compressed_sum = 0;
+    clock_t begin = clock();
+    for (size_t i = 0; i < lookups; i++) {
+        const uint32_t* k = keys + 2 * (i & 1023);
+        dense_sum += parse_table_lookup(&table, (int)k[0], (int)k[1]);
+    }
+    double dense_time = seconds_since(begin);
+    begin = clock();
+    for (size_t i = 0; i < lookups; i++) {
+        const uint32_t* k = keys + 2 * (i & 1023);
+        compressed_sum += compressed_table_lookup(&compressed, k[0], k[1]);
+    }
+    double compressed_time = seconds_since(begin);
+    printf("lookups: dense %.2f ns, compressed %.2f ns%s\n\n", dense_time * 1e9 / lookups,
+           compressed_time * 1e9 / lookups, dense_sum == compressed_sum ? "" : "  MISMATCH");
+    free(keys);
+    arena_free(arena);
+}
+
+int main(void) {
+    bench_table_size();
+
+    Arena* arena = arena_create(1024 * 1024);
+    GrammarResultGrammar res = read_grammar("bench_grammar.txt", arena);
+    if (res.status != GRAMMAR_OK) return 1;
+    Grammar* g = res.value;
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int set_count = 0;
+    ParseTable table;
+    compute_first_sets(g, sets, &set_count, arena);
+    compute_follow_sets(g, sets, &set_count, arena);
+    if (!build_parse_table(g, sets, &table, arena) || table.conflict_count) return 1;
+
+    size_t table_events = 0, rd_events = 0;
+    LL1Parser parser;
+    if (!ll1_parser_init(&parser, g, &table, 4096, 1024, count_events, &table_events, arena)) return 1;
+    ParseEvent* rd_buffer = arena_alloc(arena, 1024 * sizeof(ParseEvent));
+
+    size_t sizes[] = { 100000, 1000000, 10000000 };
+    int failed = 0;
+    printf("%12s %12s %14s %12s %14s %8s\n", "tokens", "table s", "table tok/s", "rd s", "rd tok/s", "speedup");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        TokenBuffer b = { malloc(sizes[s] * sizeof(int32_t)), 0, sizes[s],
+                          terminal(g, "id"), terminal(g, "num"), terminal(g, "+"), terminal(g, "-"),
+                          terminal(g, "*"), terminal(g, "/"), terminal(g, "("), terminal(g, ")") };
+        int semicolon = terminal(g, ";");
+        srand(1);
+        // 留出余量，保证最后一个表达式完整
+        b.capacity = sizes[s] - 2048;
+        while (b.count + 1024 < b.capacity) {
+            gen_expr(&b, 20);
+            b.tokens[b.count++] = semicolon;
+        }
+
+        int rounds = (int)(20000000 / b.count) + 1;
+        clock_t begin = clock();
+        LL1ParseResult r = { LL1_PARSE_OK, 0, -1 };
+        for (int i = 0; i < rounds && r.status == LL1_PARSE_OK; i++) {
+            TokenArray array = { b.tokens, b.count, 0, (int)g->terminals_count };
+            TokenIterator input = { token_array_next, &array };
+            r = ll1_parse(&parser, &input);
+        }
+        double table_time = seconds_since(begin);
+        if (r.status != LL1_PARSE_OK || r.token_count != b.count) failed = 1;
+
+        begin = clock();
+        for (int i = 0; i < rounds && r.status == LL1_PARSE_OK; i++) {
+            TokenArray array = { b.tokens, b.count, 0, (int)g->terminals_count };
+            TokenIterator input = { token_array_next, &array };
+            r = bench_parse(&input, rd_buffer, 1024, count_events, &rd_events, 4096);
+        }
+        double rd_time = seconds_since(begin);
+        if (r.status != LL1_PARSE_OK || r.token_count != b.count) failed = 1;
+
+        double total = (double)b.count * rounds;
+        printf("%12zu %12.4f %14.0f %12.4f %14.0f %7.2fx\n", b.count,
+               table_time / rounds, table_time > 0 ? total / table_time : 0.0,
+               rd_time / rounds, rd_time > 0 ? total / rd_time : 0.0,
+               rd_time > 0 ? table_time / rd_time : 0.0);
+        free(b.tokens);
+    }
+    // 两种分析器输出同样的事件流，事件总数必须相同
+    printf("events: table %zu, rd %zu\n", table_events, rd_events);
+    if (table_events != rd_events) failed = 1;
+
+    arena_free(arena);
+    if (failed) printf("FAIL: parse error or event mismatch on generated input\n");
+    return failed;
+}
@@ -0,0 +1,292 @@
+// 由 rd_codegen 生成的递归下降分析器，请勿手工修改
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "../src/ll1_parser.h"
+
+#define BENCH_END 9
+
+typedef struct bench_parser{
+    TokenIterator* input;
+    int token;
+    size_t token_count;
+    ParseEvent* events;
+    size_t event_count;
+    size_t event_capacity;
+    ParseEventSink sink;
+    void* sink_context;
+    size_t depth;
+    size_t max_depth;
+    LL1ParseStatus status;
+} bench_parser;
+
+static inline void bench_advance(bench_parser* p){
+    int token = p->input->next(p->input->context);
+    p->token = (token < 0 || token > BENCH_END) ? -1 : token;
+}
+
+static inline void bench_emit(bench_parser* p, ParseEvent event){
+    if(p->event_count == p->event_capacity){
+        if(p->sink) p->sink(p->sink_context, p->events, p->event_count);
+        p->event_count = 0;
+    }
+    p->events[p->event_count++] = event;
+}
+
+static inline bool bench_expect(bench_parser* p, int terminal){
+    if(p->token != terminal){
+        p->status = LL1_PARSE_SYNTAX_ERROR;
+        return false;
+    }
+    bench_emit(p, ~terminal);
+    p->token_count++;
+    bench_advance(p);
+    return true;
+}
+
+static bool bench_parse_0(bench_parser* p);
+static bool bench_parse_1(bench_parser* p);
+static bool bench_parse_2(bench_parser* p);
+static bool bench_parse_3(bench_parser* p);
+static bool bench_parse_4(bench_parser* p);
+static bool bench_parse_5(bench_parser* p);
+static bool bench_parse_6(bench_parser* p);
+
+/*
+ * 0: <program> -> <expr_list>
+ */
+static bool bench_parse_0(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    {
+        switch(p->token){
+        case 5: /* 'id' */
+        case 6: /* 'num' */
+        case 7: /* ( */
+        case 9: /* $ */
+            bench_emit(p, 0);
+            p->depth--;
+            return bench_parse_1(p);
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+/*
+ * 1: <expr_list> -> <expr> ; <expr_list>
+ * 2: <expr_list> -> #
+ */
+static bool bench_parse_1(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    for(;;){
+        switch(p->token){
+        case 5: /* 'id' */
+        case 6: /* 'num' */
+        case 7: /* ( */
+            bench_emit(p, 1);
+            if(!bench_parse_2(p)) return false;
+            if(!bench_expect(p, 0)) return false;
+            continue;
+        case 9: /* $ */
+            bench_emit(p, 2);
+            p->depth--;
+            return true;
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+/*
+ * 3: <expr> -> <term> <expr_rest>
+ */
+static bool bench_parse_2(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    {
+        switch(p->token){
+        case 5: /* 'id' */
+        case 6: /* 'num' */
+        case 7: /* ( */
+            bench_emit(p, 3);
+            if(!bench_parse_3(p)) return false;
+            p->depth--;
+            return bench_parse_4(p);
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+/*
+ * 7: <term> -> <factor> <term_rest>
+ */
+static bool bench_parse_3(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    {
+        switch(p->token){
+        case 5: /* 'id' */
+        case 6: /* 'num' */
+        case 7: /* ( */
+            bench_emit(p, 7);
+            if(!bench_parse_5(p)) return false;
+            p->depth--;
+            return bench_parse_6(p);
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+/*
+ * 4: <expr_rest> -> + <term> <expr_rest>
+ * 5: <expr_rest> -> - <term> <expr_rest>
+ * 6: <expr_rest> -> #
+ */
+static bool bench_parse_4(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    for(;;){
+        switch(p->token){
+        case 1: /* + */
+            bench_emit(p, 4);
+            bench_emit(p, ~1);
+            p->token_count++;
+            bench_advance(p);
+            if(!bench_parse_3(p)) return false;
+            continue;
+        case 2: /* - */
+            bench_emit(p, 5);
+            bench_emit(p, ~2);
+            p->token_count++;
+            bench_advance(p);
+            if(!bench_parse_3(p)) return false;
+            continue;
+        case 0: /* ; */
+        case 8: /* ) */
+            bench_emit(p, 6);
+            p->depth--;
+            return true;
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+/*
+ * 11: <factor> -> 'id'
+ * 12: <factor> -> 'num'
+ * 13: <factor> -> ( <expr> )
+ */
+static bool bench_parse_5(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    {
+        switch(p->token){
+        case 5: /* 'id' */
+            bench_emit(p, 11);
+            bench_emit(p, ~5);
+            p->token_count++;
+            bench_advance(p);
+            p->depth--;
+            return true;
+        case 6: /* 'num' */
+            bench_emit(p, 12);
+            bench_emit(p, ~6);
+            p->token_count++;
+            bench_advance(p);
+            p->depth--;
+            return true;
+        case 7: /* ( */
+            bench_emit(p, 13);
+            bench_emit(p, ~7);
+            p->token_count++;
+            bench_advance(p);
+            if(!bench_parse_2(p)) return false;
+            if(!bench_expect(p, 8)) return false;
+            p->depth--;
+            return true;
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+/*
+ * 8: <term_rest> -> * <factor> <term_rest>
+ * 9: <term_rest> -> / <factor> <term_rest>
+ * 10: <term_rest> -> #
+ */
+static bool bench_parse_6(bench_parser* p){
+    if(++p->depth > p->max_depth){
+        p->status = LL1_PARSE_STACK_OVERFLOW;
+        return false;
+    }
+    for(;;){
+        switch(p->token){
+        case 3: /* * */
+            bench_emit(p, 8);
+            bench_emit(p, ~3);
+            p->token_count++;
+            bench_advance(p);
+            if(!bench_parse_5(p)) return false;
+            continue;
+        case 4: /* / */
+            bench_emit(p, 9);
+            bench_emit(p, ~4);
+            p->token_count++;
+            bench_advance(p);
+            if(!bench_parse_5(p)) return false;
+            continue;
+        case 0: /* ; */
+        case 1: /* + */
+        case 2: /* - */
+        case 8: /* ) */
+            bench_emit(p, 10);
+            p->depth--;
+            return true;
+        default:
+            p->status = LL1_PARSE_SYNTAX_ERROR;
+            return false;
+        }
+    }
+}
+
+LL1ParseResult bench_parse(TokenIterator* input, ParseEvent* events, size_t event_capacity,
+                        ParseEventSink sink, void* sink_context, size_t max_depth){
+    bench_parser p;
+    memset(&p, 0, sizeof(p));
+    p.input = input;
+    p.events = events;
+    p.event_capacity = event_capacity;
+    p.sink = sink;
+    p.sink_context = sink_context;
+    p.max_depth = max_depth;
+    p.status = LL1_PARSE_OK;
+    bench_advance(&p);
+    if(bench_parse_0(&p) && p.token != BENCH_END) p.status = LL1_PARSE_SYNTAX_ERROR;
+    if(p.event_count && p.sink) p.sink(p.sink_context, p.events, p.event_count);
+    LL1ParseResult result = { p.status, p.token_count, p.status == LL1_PARSE_OK ? -1 : p.token };
+    return result;
+}
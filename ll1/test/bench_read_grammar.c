@@ -0,0 +1,66 @@
+// bench_read_grammar.c
+// 文法读入的基准：生成一个机器生成风格的大文法（数万个非终结符、数十万个候选式），测量 read_grammar 的耗时。
+// clang -std=c11 -O2 bench_read_grammar.c -o bench_read_grammar -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+/// 每个非终结符一行，alternatives 个候选式，每个候选式 2~5 个具名符号
+static long write_generated_grammar(const char* filename, int nonterminals, int alternatives) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return -1;
+    srand(5);
+    for (int n = 0; n < nonterminals; n++) {
+        fprintf(f, "<rule_%d> ->", n);
+        for (int a = 0; a < alternatives; a++) {
+            if (a) fprintf(f, " |");
+            int length = 2 + rand() % 4;
+            for (int i = 0; i < length; i++) {
+                if (rand() % 3) fprintf(f, " 'tok_%d'", rand() % 500);
+                else fprintf(f, " <rule_%d>", rand() % nonterminals);
+            }
+        }
+        fprintf(f, "\n");
+    }
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+int main(void) {
+    const char* filename = "bench_read_grammar.txt";
+    long size = write_generated_grammar(filename, 20000, 10);
+    if (size < 0) return 1;
+
+    int rounds = 10;
+    uint32_t rules = 0;
+    clock_t begin = clock();
+    for (int i = 0; i < rounds; i++) {
+        Arena* arena = arena_create(256 * 1024 * 1024);
+        GrammarResultGrammar res = read_grammar(filename, arena);
+        if (res.status != GRAMMAR_OK) {
+            remove(filename);
+            return 1;
+        }
+        rules = res.value->rule_count;
+        arena_free(arena);
+    }
+    double elapsed = seconds_since(begin) / rounds;
+    remove(filename);
+
+    printf("grammar: %.1f MB, %u rules\n", size / 1e6, rules);
+    printf("read_grammar: %.2f ms (%.1f MB/s, %.0f rules/ms)\n", elapsed * 1e3, size / 1e6 / elapsed, rules / (elapsed * 1e3));
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"      
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "test_helpers.h"
+
+// 经典的 LL(1) 表达式文法（X 即 E'，Y 即 T'）
+static Grammar* load_expression_grammar(Arena* arena) {
+    return load_grammar("S -> TX\nX -> +TX | #\nT -> FY\nY -> *FY | #\nF -> (S) | i\n", arena);
+}
+
+static SymbolSet* find_set(Grammar* g, SymbolSet* sets, const char* name) {
+    SymbolId symbol = grammar_lookup_symbol(g, name, strlen(name));
+    if (symbol == GRAMMAR_NO_SYMBOL || grammar_nonterminal_id(g, symbol) < 0) return NULL;
+    return &sets[grammar_nonterminal_id(g, symbol)];
+}
+
+static const char* first_of(Grammar* g, SymbolSet* sets, const char* name) {
+    static char buffer[256];
+    SymbolSet* set = find_set(g, sets, name);
+    if (!set) return "(none)";
+    format_symbol_set(g, set->first, set->nullable, buffer, sizeof(buffer));
+    return buffer;
+}
+
+static const char* follow_of(Grammar* g, SymbolSet* sets, const char* name) {
+    static char buffer[256];
+    SymbolSet* set = find_set(g, sets, name);
+    if (!set) return "(none)";
+    format_symbol_set(g, set->follow, false, buffer, sizeof(buffer));
+    return buffer;
+}
+
+static SymbolSet* alloc_sets(Grammar* g, Arena* arena) {
+    return arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+}
+
+// --- Test functions ---
+TEST(test_bitset_union_reports_change) {
+    uint64_t a[2] = {0, 0};
+    uint64_t b[2] = {0, 0};
+    ASSERT(bitset_add(b, 3));
+    ASSERT(!bitset_add(b, 3));
+    ASSERT(bitset_add(b, 70));
+    ASSERT(bitset_union(a, b, 2));
+    ASSERT(!bitset_union(a, b, 2));
+    ASSERT(bitset_contains(a, 3) && bitset_contains(a, 70) && !bitset_contains(a, 4));
+}
+
+TEST(test_sets_indexed_by_nonterminal_id) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_expression_grammar(arena);
+    ASSERT(g != NULL);
+    SymbolSet* sets = alloc_sets(g, arena);
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+    ASSERT(count == (int)g->nonterminals_count);
+    ASSERT_STR_EQ(grammar_symbol_name(g, g->start_symbol), "S");
+    SymbolId y = grammar_lookup_symbol(g, "Y", 1);
+    ASSERT(sets[grammar_nonterminal_id(g, y)].symbol == y);
+    SymbolId plus = grammar_lookup_symbol(g, "+", 1);
+    ASSERT(grammar_nonterminal_id(g, plus) == -1);
+    ASSERT(g->terminals[grammar_terminal_id(g, plus)] == plus);
+    arena_free(arena);
+}
+
+TEST(test_first_sets) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_expression_grammar(arena);
+    ASSERT(g != NULL);
+    SymbolSet* sets = alloc_sets(g, arena);
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+
+    ASSERT_STR_EQ(first_of(g, sets, "S"), "(i");
+    ASSERT_STR_EQ(first_of(g, sets, "X"), "#+");
+    ASSERT_STR_EQ(first_of(g, sets, "T"), "(i");
+    ASSERT_STR_EQ(first_of(g, sets, "Y"), "#*");
+    ASSERT_STR_EQ(first_of(g, sets, "F"), "(i");
+    arena_free(arena);
+}
+
+TEST(test_follow_sets) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_expression_grammar(arena);
+    ASSERT(g != NULL);
+    SymbolSet* sets = alloc_sets(g, arena);
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+    compute_follow_sets(g, sets, &count, arena);
+
+    ASSERT_STR_EQ(follow_of(g, sets, "S"), ")$");
+    ASSERT_STR_EQ(follow_of(g, sets, "X"), ")$");
+    ASSERT_STR_EQ(follow_of(g, sets, "T"), "+)$");
+    ASSERT_STR_EQ(follow_of(g, sets, "Y"), "+)$");
+    ASSERT_STR_EQ(follow_of(g, sets, "F"), "+*)$");
+    arena_free(arena);
+}
+
+TEST(test_named_symbols) {
+    FILE* f = fopen("temp_grammar.txt", "w");
+    fprintf(f, "<expr> -> <term> <expr_rest>\n<expr_rest> -> '+' <term> <expr_rest> | #\n");
+    fprintf(f, "<term> -> 'id' | 'num' | '(' <expr> ')'\n");
+    fclose(f);
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = read_grammar("temp_grammar.txt", arena).value;
+    remove("temp_grammar.txt");
+    ASSERT(g != NULL);
+    SymbolSet* sets = alloc_sets(g, arena);
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+    compute_follow_sets(g, sets, &count, arena);
+
+    ASSERT_STR_EQ(first_of(g, sets, "expr"), "id num (");
+    ASSERT_STR_EQ(first_of(g, sets, "expr_rest"), "#+");
+    ASSERT_STR_EQ(follow_of(g, sets, "expr_rest"), ")$");
+    ASSERT_STR_EQ(follow_of(g, sets, "term"), "+)$");
+    arena_free(arena);
+}
+
+// 参考实现：对全部产生式反复扫描直到不动点，用来核对 digraph 求解的结果
+static void reference_first_follow(Grammar* g, SymbolSet* sets, int count) {
+    size_t words = symbol_set_words(g);
+    for (int i = 0; i < count; i++) {
+        memset(sets[i].first, 0, words * sizeof(uint64_t));
+        memset(sets[i].follow, 0, words * sizeof(uint64_t));
+        sets[i].nullable = false;
+    }
+    bitset_add(sets[grammar_nonterminal_id(g, g->start_symbol)].follow, grammar_end_marker_id(g));
+    bool changed;
+    do {
+        changed = false;
+        for (uint32_t r = 0; r < g->rule_count; r++) {
+            const Rule* rule = &g->rules[r];
+            SymbolSet* lhs = &sets[grammar_nonterminal_id(g, rule->left_hs)];
+            bool all_nullable = true;
+            for (uint32_t j = 0; j < rule->right_hs_count && all_nullable; j++) {
+                SymbolId p = rule->right_hs[j];
+                if (grammar_symbol_is_terminal(g, p)) {
+                    changed |= bitset_add(lhs->first, grammar_terminal_id(g, p));
+                    all_nullable = false;
+                } else {
+                    SymbolSet* x = &sets[grammar_nonterminal_id(g, p)];
+                    changed |= bitset_union(lhs->first, x->first, words);
+                    all_nullable = x->nullable;
+                }
+            }
+            if (all_nullable && !lhs->nullable) { lhs->nullable = true; changed = true; }
+
+            for (uint32_t j = 0; j < rule->right_hs_count; j++) {
+                if (grammar_symbol_is_terminal(g, rule->right_hs[j])) continue;
+                SymbolSet* b = &sets[grammar_nonterminal_id(g, rule->right_hs[j])];
+                bool chain = true;
+                for (uint32_t k = j + 1; k < rule->right_hs_count && chain; k++) {
+                    SymbolId q = rule->right_hs[k];
+                    if (grammar_symbol_is_terminal(g, q)) {
+                        changed |= bitset_add(b->follow, grammar_terminal_id(g, q));
+                        chain = false;
+                    } else {
+                        SymbolSet* x = &sets[grammar_nonterminal_id(g, q)];
+                        changed |= bitset_union(b->follow, x->first, words);
+                        chain = x->nullable;
+                    }
+                }
+                if (chain) changed |= bitset_union(b->follow, lhs->follow, words);
+            }
+        }
+    } while (changed);
+}
+
+TEST(test_matches_fixed_point_on_random_grammars) {
+    srand(7);
+    int mismatches = 0;
+    for (int round = 0; round < 50; round++) {
+        FILE* f = fopen("temp_grammar.txt", "w");
+        for (int r = 0; r < 100; r++) {
+            char lhs = (r < 26) ? 'A' + r : 'A' + rand() % 26;
+            if (r == 0) lhs = 'S';
+            fprintf(f, "%c -> ", lhs);
+            int len = rand() % 4;
+            if (len == 0) fprintf(f, "#");
+            for (int k = 0; k < len; k++) {
+                fputc(rand() % 3 ? 'A' + rand() % 26 : 'a' + rand() % 20, f);
+            }
+            fputc('\n', f);
+        }
+        fclose(f);
+
+        Arena* arena = arena_create(1024 * 256);
+        Grammar* g = read_grammar("temp_grammar.txt", arena).value;
+        SymbolSet* sets = alloc_sets(g, arena);
+        SymbolSet* expected = alloc_sets(g, arena);
+        int count = 0;
+        compute_first_sets(g, sets, &count, arena);
+        compute_follow_sets(g, sets, &count, arena);
+
+        size_t words = symbol_set_words(g);
+        for (int i = 0; i < count; i++) {
+            expected[i] = sets[i];
+            expected[i].first = arena_alloc(arena, words * sizeof(uint64_t));
+            expected[i].follow = arena_alloc(arena, words * sizeof(uint64_t));
+        }
+        reference_first_follow(g, expected, count);
+        for (int i = 0; i < count; i++) {
+            if (expected[i].nullable != sets[i].nullable ||
+                memcmp(expected[i].first, sets[i].first, words * sizeof(uint64_t)) != 0 ||
+                memcmp(expected[i].follow, sets[i].follow, words * sizeof(uint64_t)) != 0) {
+                mismatches++;
+            }
+        }
+        arena_free(arena);
+    }
+    remove("temp_grammar.txt");
+    ASSERT(mismatches == 0);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_bitset_union_reports_change);
+    RUN_TEST(test_sets_indexed_by_nonterminal_id);
+    RUN_TEST(test_first_sets);
+    RUN_TEST(test_follow_sets);
+    RUN_TEST(test_named_symbols);
+    RUN_TEST(test_matches_fixed_point_on_random_grammars);
+
+    return failed;
+}
@@ -13,4 +13,4 @@ int failed = 0;
   printf("\033[0;31mFAIL: %s != %s\n\033[0m", str1, str2); \
 } else { \
   printf("\033[0;32mPASS: %s == %s\n\033[0m", str1, str2); \
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <stdlib.h>
 
 #include "test_framework.h"
 
@@ -15,6 +16,16 @@
 
 
 
+static const char* rhs_of(Grammar* g, uint32_t r) {
+    static char buffer[256];
+    format_rule_rhs(g, &g->rules[r], buffer, sizeof(buffer));
+    return buffer;
+}
+
+static const char* name_of(Grammar* g, SymbolId s) {
+    return grammar_symbol_name(g, s);
+}
+
 // --- Test functions ---
 TEST(test_is_terminal_nonterminal) {
     ASSERT(grammar_is_terminal('a'));
@@ -24,133 +35,265 @@ TEST(test_is_terminal_nonterminal) {
     ASSERT(!grammar_is_nonterminal('a'));
 }
 
-TEST(test_add_unique_symbol) {
-    char list[10];
-    uint8_t count = 0;
+TEST(test_intern_symbol) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = init_grammar(arena).value;
 
-    GrammarResultVoid rv_1 = grammar_add_unique_symbol(list, &count, 'a');
-    GrammarResultVoid rv_2 = grammar_add_unique_symbol(list, &count, 'b');
-    GrammarResultVoid rv_3 = grammar_add_unique_symbol(list, &count, 'a');  // duplicate
+    GrammarResultSymbol rv_1 = grammar_intern_symbol(g, "a", 1, true);
+    GrammarResultSymbol rv_2 = grammar_intern_symbol(g, "expr", 4, false);
+    GrammarResultSymbol rv_3 = grammar_intern_symbol(g, "a", 1, true);  // duplicate
+    GrammarResultSymbol rv_4 = grammar_intern_symbol(g, "expr", 4, true);  // kind conflict
     ASSERT(rv_1.status==GRAMMAR_OK);
     ASSERT(rv_2.status==GRAMMAR_OK);
     ASSERT(rv_3.status==GRAMMAR_OK);
-    ASSERT(count == 2);
-    ASSERT(list[0] == 'a');
-    ASSERT(list[1] == 'b');
+    ASSERT(rv_4.status==GRAMMAR_ERROR_SYMBOL_CONFLICT);
+    ASSERT(rv_1.value == rv_3.value);
+    ASSERT(g->symbol_count == 2);
+    ASSERT(g->terminals_count == 1 && g->terminals[0] == rv_1.value);
+    ASSERT(g->nonterminals_count == 1 && g->nonterminals[0] == rv_2.value);
+    ASSERT(grammar_terminal_id(g, rv_1.value) == 0);
+    ASSERT(grammar_nonterminal_id(g, rv_1.value) == -1);
+    ASSERT(grammar_lookup_symbol(g, "expr", 4) == rv_2.value);
+    ASSERT(grammar_lookup_symbol(g, "exp", 3) == GRAMMAR_NO_SYMBOL);
+    arena_free(arena);
+}
+
+TEST(test_intern_many_symbols) {
+    Arena* arena = arena_create(1024 * 1024);
+    Grammar* g = init_grammar(arena).value;
+    char name[16];
+    bool ok = true;
+    for (int i = 0; i < 5000; i++) {
+        int n = snprintf(name, sizeof(name), "sym%d", i);
+        GrammarResultSymbol r = grammar_intern_symbol(g, name, (size_t)n, i % 2 == 0);
+        ok = ok && r.status == GRAMMAR_OK && r.value == i;
+    }
+    for (int i = 0; i < 5000; i++) {
+        int n = snprintf(name, sizeof(name), "sym%d", i);
+        ok = ok && grammar_lookup_symbol(g, name, (size_t)n) == i;
+    }
+    ASSERT(ok);
+    ASSERT(g->symbol_count == 5000);
+    ASSERT(g->terminals_count == 2500 && g->nonterminals_count == 2500);
+    arena_free(arena);
 }
 
-TEST(test_remove_spaces) {
-    char input[] = "  A  ->  a B  ";
-    line_remove_spaces(input);
-    ASSERT_STR_EQ(input, "A->aB");
+static GrammarResultGrammar parse_text(const char* text, Arena* arena) {
+    return parse_grammar(text, strlen(text), "test", arena);
 }
 
-TEST(test_extract_lhs) {
-    GrammarResultChar res = grammar_extract_lhs("S->aB");
+TEST(test_parse_spacing) {
+    Arena* arena = arena_create(1024 * 64);
+    GrammarResultGrammar res = parse_text("  A  ->  a B  \r\n\n\t\nB->'else if'|#", arena);
     ASSERT(res.status == GRAMMAR_OK);
-    ASSERT(res.value == 'S');
+    Grammar* g = res.value;
+    ASSERT(g->rule_count == 3);
+    ASSERT_STR_EQ(rhs_of(g, 0), "aB");
+    ASSERT_STR_EQ(name_of(g, g->rules[1].right_hs[0]), "else if");
+    ASSERT(g->rules[2].right_hs_count == 0);
+    arena_free(arena);
+}
 
-    res = grammar_extract_lhs("->aB");
-    ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
+TEST(test_parse_lhs) {
+    Arena* arena = arena_create(1024 * 64);
+    GrammarResultGrammar res = parse_text("<stmt_list> -> aB\n", arena);
+    ASSERT(res.status == GRAMMAR_OK);
+    ASSERT_STR_EQ(name_of(res.value, res.value->start_symbol), "stmt_list");
 
-    res = grammar_extract_lhs("SS->aB");
+    res = parse_text("-> aB", arena);
     ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
-
-    res = grammar_extract_lhs("s->aB");
+    res = parse_text("SS -> aB", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
+    res = parse_text("s -> aB", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_NONTERMINAL);
+    res = parse_text("'id' -> aB", arena);
     ASSERT(res.status == GRAMMAR_ERROR_INVALID_NONTERMINAL);
+    res = parse_text("S ->   \nA -> a", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
+    arena_free(arena);
 }
 
-TEST(test_extract_rhs) {
-    GrammarResultString res = grammar_extract_rhs("S->aB");
+TEST(test_parse_alternatives) {
+    Arena* arena = arena_create(1024 * 64);
+    // 空候选式被跳过，'#' 是空串，不是符号
+    GrammarResultGrammar res = parse_text("S -> aB | | # |b", arena);
     ASSERT(res.status == GRAMMAR_OK);
-    ASSERT_STR_EQ(res.value, "aB");
+    Grammar* g = res.value;
+    ASSERT(g->rule_count == 3);
+    ASSERT(g->terminals_count == 2);     // a b
+    ASSERT(g->nonterminals_count == 2);  // S, B
+    ASSERT_STR_EQ(rhs_of(g, 0), "aB");
+    ASSERT_STR_EQ(rhs_of(g, 1), "#");
+    ASSERT_STR_EQ(rhs_of(g, 2), "b");
+    arena_free(arena);
+}
 
-    res = grammar_extract_rhs("S->   a|b");
-    ASSERT(res.status == GRAMMAR_OK);
-    ASSERT_STR_EQ(res.value, "a|b");
+TEST(test_parse_error_positions) {
+    Arena* arena = arena_create(1024 * 64);
+    GrammarResultGrammar res = parse_text("S -> a\nA -> 'b c\nB -> b\n", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
+    ASSERT(res.line == 2 && res.column == 6);
+
+    res = parse_text("S -> a\n\n  a -> b\n", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_NONTERMINAL);
+    ASSERT(res.line == 3 && res.column == 3);
 
-    res = grammar_extract_rhs("S->");
+    res = parse_text("S -> a\nA b\n", arena);
     ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
-}
+    ASSERT(res.line == 2 && res.column == 3);
 
-TEST(test_collect_rhs_symbols) {
-    Arena* arena = arena_create(1024 * 10);
-    GrammarResultGrammar r = init_grammar(arena);
-    ASSERT(r.status == GRAMMAR_OK);
-    Grammar* g = r.value;
+    res = parse_text("<if stmt> -> a", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
+    ASSERT(res.line == 1 && res.column == 4);
 
-    GrammarResultVoid res = grammar_collect_rhs_symbols("aB#", g);
-    ASSERT(res.status == GRAMMAR_OK);
+    res = parse_text("S -> a <> b", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_INVALID_FORMAT);
+    ASSERT(res.line == 1 && res.column == 8);
 
-    ASSERT(g->terminals_count == 2);     // a, #
-    ASSERT(g->nonterminals_count == 1);  // B
+    // 符号类别冲突定位到名字本身
+    res = parse_text("<x> -> a\nS -> 'x'", arena);
+    ASSERT(res.status == GRAMMAR_ERROR_SYMBOL_CONFLICT);
+    ASSERT(res.line == 2 && res.column == 7);
 
+    res = parse_text("S -> a", arena);
+    ASSERT(res.status == GRAMMAR_OK && res.line == 0 && res.column == 0);
     arena_free(arena);
 }
 
-TEST(test_parse_rhs) {
-    Arena* arena = arena_create(1024 * 1024);
-    GrammarResultGrammar r = init_grammar(arena);
-    ASSERT(r.status == GRAMMAR_OK);
-    Grammar* g = r.value;
+TEST(test_parse_long_line) {
+    // 一行中的候选式数目不受行长限制，右部跨过存储块的边界时整段移到新块
+    size_t count = 20000;
+    char* text = malloc(count * 12 + 16);
+    size_t n = (size_t)sprintf(text, "S -> ");
+    for (size_t i = 0; i < count; i++) n += (size_t)sprintf(text + n, "%s'a%zu' S", i ? " | " : "", i % 100);
+    Arena* arena = arena_create(4 * 1024 * 1024);
+    GrammarResultGrammar res = parse_grammar(text, n, "long", arena);
+    free(text);
+    ASSERT(res.status == GRAMMAR_OK);
+    Grammar* g = res.value;
+    ASSERT(g->rule_count == count);
+    ASSERT(g->terminals_count == 100);
+    bool ok = true;
+    for (uint32_t i = 0; i < g->rule_count; i++) {
+        ok = ok && g->rules[i].right_hs_count == 2 && g->rules[i].right_hs[1] == g->start_symbol &&
+             strtoul(name_of(g, g->rules[i].right_hs[0]) + 1, NULL, 10) == i % 100;
+    }
+    ASSERT(ok);
+    arena_free(arena);
+}
 
-    char rhs_buf[] = "aB|#";
-    GrammarResultVoid res = grammar_parse_rhs(g, 'S', rhs_buf, arena);
+TEST(test_read_grammar) {
+    FILE* f = fopen("temp_grammar.txt", "w");
+    fprintf(f, "S -> aB\nB -> b\n");
+    fclose(f);
+
+    Arena* arena = arena_create(1024 * 1024);
+    GrammarResultGrammar res = read_grammar("temp_grammar.txt", arena);
     ASSERT(res.status == GRAMMAR_OK);
+    Grammar* g = res.value;
 
+    ASSERT(g != NULL);
     ASSERT(g->rule_count == 2);
-    ASSERT(g->rules[0].left_hs == 'S');
-    ASSERT_STR_EQ(g->rules[0].right_hs, "aB");
-    ASSERT_STR_EQ(g->rules[1].right_hs, "#");
+    ASSERT_STR_EQ(name_of(g, g->rules[0].left_hs), "S");
+    ASSERT(g->start_symbol == g->rules[0].left_hs);
+    ASSERT_STR_EQ(rhs_of(g, 0), "aB");
+    ASSERT_STR_EQ(rhs_of(g, 1), "b");
 
+    remove("temp_grammar.txt");
     arena_free(arena);
 }
 
-TEST(test_process_line) {
-    Arena* arena = arena_create(1024 * 10);
-    GrammarResultGrammar r = init_grammar(arena);
-    ASSERT(r.status == GRAMMAR_OK);
-    Grammar* g = r.value;
+TEST(test_read_named_symbols) {
+    FILE* f = fopen("temp_grammar.txt", "w");
+    fprintf(f, "<expr> -> <expr> '+' <term> | <term>\n");
+    fprintf(f, "<term> -> 'id' | \"(\" <expr> ')' | T\n");
+    fprintf(f, "T -> 'a b' | #\n");
+    fclose(f);
 
-    char line[] = "S -> aB | b";
-    GrammarResultVoid res = grammar_process_line(line, g, arena);
+    Arena* arena = arena_create(1024 * 1024);
+    GrammarResultGrammar res = read_grammar("temp_grammar.txt", arena);
     ASSERT(res.status == GRAMMAR_OK);
-    ASSERT(g->rule_count == 2);
+    Grammar* g = res.value;
+
+    ASSERT(g->rule_count == 7);
+    ASSERT(g->nonterminals_count == 3);   // expr, term, T
+    ASSERT(g->terminals_count == 5);      // + id ( ) 'a b'
+    ASSERT_STR_EQ(name_of(g, g->start_symbol), "expr");
+    ASSERT(g->rules[0].right_hs_count == 3);
+    ASSERT_STR_EQ(name_of(g, g->rules[0].right_hs[1]), "+");
+    ASSERT_STR_EQ(rhs_of(g, 0), "<expr> + <term>");
+    ASSERT_STR_EQ(rhs_of(g, 3), "( <expr> )");
+    ASSERT_STR_EQ(rhs_of(g, 5), "'a b'");
+    ASSERT(g->rules[6].right_hs_count == 0);
+    ASSERT(grammar_lookup_symbol(g, "(", 1) != GRAMMAR_NO_SYMBOL);
+    ASSERT(grammar_symbol_is_terminal(g, grammar_lookup_symbol(g, "id", 2)));
 
+    remove("temp_grammar.txt");
     arena_free(arena);
 }
 
-TEST(test_read_grammar) {
+TEST(test_read_large_grammar) {
+    // 超过原先 64 个符号、128 条产生式、uint8_t 计数的上限
     FILE* f = fopen("temp_grammar.txt", "w");
-    fprintf(f, "S -> aB\nB -> b\n");
+    for (int i = 0; i < 600; i++) {
+        fprintf(f, "<n%d> -> 't%d' <n%d> | 'u%d' | 't%d'\n", i, i, (i + 1) % 600, i, (i + 7) % 600);
+    }
     fclose(f);
 
     Arena* arena = arena_create(1024 * 1024);
     GrammarResultGrammar res = read_grammar("temp_grammar.txt", arena);
     ASSERT(res.status == GRAMMAR_OK);
     Grammar* g = res.value;
+    ASSERT(g->rule_count == 1800);
+    ASSERT(g->nonterminals_count == 600);
+    ASSERT(g->terminals_count == 1200);
+    ASSERT_STR_EQ(rhs_of(g, 1797), "'t599' <n0>");
 
-    ASSERT(g != NULL);
-    ASSERT(g->rule_count == 2);
-    ASSERT(g->rules[0].left_hs == 'S');
-    ASSERT_STR_EQ(g->rules[0].right_hs, "aB");
-    ASSERT_STR_EQ(g->rules[1].right_hs, "b");
+    remove("temp_grammar.txt");
+    arena_free(arena);
+}
 
+TEST(test_append_and_remove_rule) {
+    FILE* f = fopen("temp_grammar.txt", "w");
+    fprintf(f, "S -> aA\nA -> b | #\n");
+    fclose(f);
+    Arena* arena = arena_create(1024 * 64);
+    GrammarResultGrammar res = read_grammar("temp_grammar.txt", arena);
     remove("temp_grammar.txt");
+    ASSERT(res.status == GRAMMAR_OK);
+    Grammar* g = res.value;
+
+    SymbolId c = grammar_intern_symbol(g, "c", 1, true).value;
+    SymbolId rhs[] = { c, grammar_lookup_symbol(g, "S", 1) };
+    ASSERT(grammar_append_rule(g, grammar_lookup_symbol(g, "A", 1), rhs, 2).status == GRAMMAR_OK);
+    ASSERT(g->rule_count == 4);
+    ASSERT_STR_EQ(rhs_of(g, 3), "cS");
+    ASSERT(grammar_append_rule(g, c, rhs, 2).status == GRAMMAR_ERROR_INVALID_ARGUMENT);
+    rhs[1] = 99;
+    ASSERT(grammar_append_rule(g, g->start_symbol, rhs, 2).status == GRAMMAR_ERROR_INVALID_ARGUMENT);
+
+    // 删除第 1 条，最后一条移入
+    ASSERT(grammar_remove_rule(g, 1).status == GRAMMAR_OK);
+    ASSERT(g->rule_count == 3);
+    ASSERT_STR_EQ(rhs_of(g, 1), "cS");
+    ASSERT(grammar_remove_rule(g, 3).status == GRAMMAR_ERROR_INVALID_ARGUMENT);
     arena_free(arena);
 }
 
 // --- Main ---
 int main() {
     RUN_TEST(test_is_terminal_nonterminal);
-    RUN_TEST(test_add_unique_symbol);
-    RUN_TEST(test_remove_spaces);
-    RUN_TEST(test_extract_lhs);
-    RUN_TEST(test_extract_rhs);
-    RUN_TEST(test_collect_rhs_symbols);
-    RUN_TEST(test_parse_rhs);
-    RUN_TEST(test_process_line);
+    RUN_TEST(test_intern_symbol);
+    RUN_TEST(test_intern_many_symbols);
+    RUN_TEST(test_parse_spacing);
+    RUN_TEST(test_parse_lhs);
+    RUN_TEST(test_parse_alternatives);
+    RUN_TEST(test_parse_error_positions);
+    RUN_TEST(test_parse_long_line);
     RUN_TEST(test_read_grammar);
+    RUN_TEST(test_read_named_symbols);
+    RUN_TEST(test_read_large_grammar);
+    RUN_TEST(test_append_and_remove_rule);
 
     return failed;
 }
\ No newline at end of file
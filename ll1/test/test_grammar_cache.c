@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+#include "../src/grammar_cache.h"
+#include "../src/grammar_cache.c"
+
+#include "../src/ll1_cache.h"
+#include "../src/ll1_cache.c"
+
+#define GRAMMAR_FILE "temp_grammar.txt"
+#define CACHE_FILE "temp_grammar.cache"
+
+static void write_file(const char* path, const char* text) {
+    FILE* f = fopen(path, "w");
+    fputs(text, f);
+    fclose(f);
+}
+
+typedef struct Analysis {
+    Grammar* grammar;
+    SymbolSet* sets;
+    int set_count;
+    ParseTable table;
+} Analysis;
+
+static bool analyse(Analysis* a, Arena* arena) {
+    GrammarResultGrammar res = read_grammar(GRAMMAR_FILE, arena);
+    if (res.status != GRAMMAR_OK) return false;
+    a->grammar = res.value;
+    a->sets = arena_alloc(arena, (a->grammar->nonterminals_count + 1) * sizeof(SymbolSet));
+    compute_first_sets(a->grammar, a->sets, &a->set_count, arena);
+    compute_follow_sets(a->grammar, a->sets, &a->set_count, arena);
+    return build_parse_table(a->grammar, a->sets, &a->table, arena);
+}
+
+static bool save(const Analysis* a, uint64_t key, Arena* arena) {
+    GrammarCacheWriter writer;
+    grammar_cache_writer_init(&writer);
+    return grammar_cache_put_grammar(&writer, a->grammar, arena) &&
+           cache_put_symbol_sets(&writer, a->grammar, a->sets, a->set_count, arena) &&
+           cache_put_parse_table(&writer, a->grammar, &a->table, arena) && grammar_cache_write(CACHE_FILE, key, &writer);
+}
+
+static bool load(GrammarCache* cache, uint64_t key, Analysis* a, Arena* arena) {
+    if (!grammar_cache_open(CACHE_FILE, key, cache)) return false;
+    a->grammar = grammar_cache_load_grammar(cache, arena);
+    if (!a->grammar) return false;
+    a->sets = cache_load_symbol_sets(cache, a->grammar, &a->set_count, arena);
+    return a->sets && cache_load_parse_table(cache, a->grammar, &a->table);
+}
+
+/// 两次分析的文法、集合与表逐项相同
+static bool same_analysis(const Analysis* x, const Analysis* y) {
+    const Grammar* g = x->grammar;
+    const Grammar* h = y->grammar;
+    if (g->symbol_count != h->symbol_count || g->rule_count != h->rule_count || g->start_symbol != h->start_symbol ||
+        g->terminals_count != h->terminals_count || g->nonterminals_count != h->nonterminals_count) {
+        return false;
+    }
+    for (uint32_t s = 0; s < g->symbol_count; s++) {
+        if (strcmp(g->symbols[s].name, h->symbols[s].name) != 0 || g->symbols[s].terminal != h->symbols[s].terminal ||
+            g->symbols[s].index != h->symbols[s].index || grammar_lookup_symbol(h, g->symbols[s].name, g->symbols[s].length) != (SymbolId)s) {
+            return false;
+        }
+    }
+    for (uint32_t r = 0; r < g->rule_count; r++) {
+        const Rule* a = &g->rules[r];
+        const Rule* b = &h->rules[r];
+        if (a->left_hs != b->left_hs || a->right_hs_count != b->right_hs_count ||
+            (a->right_hs_count && memcmp(a->right_hs, b->right_hs, a->right_hs_count * sizeof(SymbolId)) != 0)) {
+            return false;
+        }
+    }
+    size_t words = symbol_set_words(g);
+    if (x->set_count != y->set_count) return false;
+    for (int i = 0; i < x->set_count; i++) {
+        if (x->sets[i].symbol != y->sets[i].symbol || x->sets[i].nullable != y->sets[i].nullable ||
+            memcmp(x->sets[i].first, y->sets[i].first, words * sizeof(uint64_t)) != 0 ||
+            memcmp(x->sets[i].follow, y->sets[i].follow, words * sizeof(uint64_t)) != 0) {
+            return false;
+        }
+    }
+    const ParseTable* t = &x->table;
+    const ParseTable* u = &y->table;
+    return t->row_count == u->row_count && t->column_count == u->column_count &&
+           memcmp(t->cells, u->cells, (size_t)t->row_count * t->column_count * sizeof(int16_t)) == 0 &&
+           memcmp(t->rule_first, u->rule_first, g->rule_count * words * sizeof(uint64_t)) == 0 &&
+           memcmp(t->rule_nullable, u->rule_nullable, g->rule_count * sizeof(bool)) == 0 &&
+           t->conflict_count == u->conflict_count &&
+           memcmp(t->conflicts, u->conflicts, t->conflict_count * sizeof(TableConflict)) == 0;
+}
+
+// --- Test functions ---
+TEST(test_round_trip) {
+    write_file(GRAMMAR_FILE, "<expr> -> <term> <rest>\n<rest> -> '+' <term> <rest> | #\n"
+                             "<term> -> 'id' | '(' <expr> ')' | 'id' '[' <expr> ']'\n");
+    Arena* arena = arena_create(1024 * 1024);
+    Analysis fresh, cached;
+    uint64_t key;
+    ASSERT(analyse(&fresh, arena));
+    ASSERT(fresh.table.conflict_count == 1);
+    ASSERT(grammar_cache_key(GRAMMAR_FILE, "test", &key));
+    ASSERT(save(&fresh, key, arena));
+
+    GrammarCache cache;
+    ASSERT(load(&cache, key, &cached, arena));
+    ASSERT(same_analysis(&fresh, &cached));
+    ASSERT(parse_table_lookup(&cached.table, 0, grammar_terminal_id(cached.grammar, grammar_lookup_symbol(cached.grammar, "(", 1))) == 0);
+
+    // 映射是写时复制的：由缓存恢复的文法可以继续登记符号、追加产生式
+    SymbolId star = grammar_intern_symbol(cached.grammar, "*", 1, true).value;
+    SymbolId rest = grammar_lookup_symbol(cached.grammar, "rest", 4);
+    SymbolId rhs[] = { star, rest };
+    ASSERT(grammar_append_rule(cached.grammar, rest, rhs, 2).status == GRAMMAR_OK);
+    ASSERT(cached.grammar->rule_count == 7 && cached.grammar->terminals_count == 7);
+    ASSERT(grammar_lookup_symbol(cached.grammar, "*", 1) == star);
+    grammar_cache_close(&cache);
+
+    // 文件本身没有被改动，再次载入仍与原分析一致
+    ASSERT(load(&cache, key, &cached, arena));
+    ASSERT(same_analysis(&fresh, &cached));
+    grammar_cache_close(&cache);
+    remove(CACHE_FILE);
+    remove(GRAMMAR_FILE);
+    arena_free(arena);
+}
+
+TEST(test_key_tracks_content) {
+    uint64_t a, b, c, d;
+    write_file(GRAMMAR_FILE, "S -> aS | b\n");
+    ASSERT(grammar_cache_key(GRAMMAR_FILE, "ll1", &a));
+    ASSERT(grammar_cache_key(GRAMMAR_FILE, "ll1 -r", &b));
+    write_file(GRAMMAR_FILE, "S -> aS | c\n");
+    ASSERT(grammar_cache_key(GRAMMAR_FILE, "ll1", &c));
+    write_file(GRAMMAR_FILE, "S -> aS | b\n");
+    ASSERT(grammar_cache_key(GRAMMAR_FILE, "ll1", &d));
+    ASSERT(a != b && a != c && a == d);
+    remove(GRAMMAR_FILE);
+    ASSERT(!grammar_cache_key(GRAMMAR_FILE, "ll1", &a));
+}
+
+TEST(test_reject_stale_or_damaged) {
+    write_file(GRAMMAR_FILE, "S -> aA\nA -> b | #\n");
+    Arena* arena = arena_create(1024 * 1024);
+    Analysis fresh, cached;
+    uint64_t key;
+    ASSERT(analyse(&fresh, arena));
+    ASSERT(grammar_cache_key(GRAMMAR_FILE, NULL, &key));
+    ASSERT(save(&fresh, key, arena));
+
+    GrammarCache cache;
+    ASSERT(!grammar_cache_open(CACHE_FILE, key + 1, &cache));
+    ASSERT(!grammar_cache_open("no_such_file.cache", key, &cache));
+
+    // 截断的文件：长度与头部记录不符
+    FILE* f = fopen(CACHE_FILE, "rb");
+    char buffer[4096];
+    size_t size = fread(buffer, 1, sizeof(buffer), f);
+    fclose(f);
+    f = fopen(CACHE_FILE, "wb");
+    fwrite(buffer, 1, size - 8, f);
+    fclose(f);
+    ASSERT(!grammar_cache_open(CACHE_FILE, key, &cache));
+
+    // 长度正确但文法段中的符号编号被改坏
+    GrammarCacheHeader* header = (GrammarCacheHeader*)buffer;
+    CacheSection* sections = (CacheSection*)(buffer + sizeof(GrammarCacheHeader));
+    ASSERT(header->section_count == 3 && sections[0].tag == CACHE_SECTION_GRAMMAR);
+    CachedGrammarHeader* g = (CachedGrammarHeader*)(buffer + sections[0].offset);
+    g->start_symbol = (int32_t)g->symbol_count;
+    f = fopen(CACHE_FILE, "wb");
+    fwrite(buffer, 1, size, f);
+    fclose(f);
+    ASSERT(grammar_cache_open(CACHE_FILE, key, &cache));
+    ASSERT(grammar_cache_load_grammar(&cache, arena) == NULL);
+    grammar_cache_close(&cache);
+
+    // 表段与文法的规模不符
+    g->start_symbol = 0;
+    CachedParseTableHeader* t = (CachedParseTableHeader*)(buffer + sections[2].offset);
+    t->column_count++;
+    f = fopen(CACHE_FILE, "wb");
+    fwrite(buffer, 1, size, f);
+    fclose(f);
+    ASSERT(!load(&cache, key, &cached, arena));
+    grammar_cache_close(&cache);
+
+    remove(CACHE_FILE);
+    remove(GRAMMAR_FILE);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_key_tracks_content);
+    RUN_TEST(test_reject_stale_or_damaged);
+
+    return failed;
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/grammar_reduce.h"
+#include "../src/grammar_reduce.c"
+
+#include "test_helpers.h"
+
+static const char* rule_text(Grammar* g, const Rule* rule) {
+    static char buffer[256];
+    size_t n = format_symbol(g, rule->left_hs, buffer, sizeof(buffer));
+    n += (size_t)snprintf(buffer + n, sizeof(buffer) - n, "->");
+    format_rule_rhs(g, rule, buffer + n, sizeof(buffer) - n);
+    return buffer;
+}
+
+// --- Test functions ---
+TEST(test_drop_unproductive) {
+    Arena* arena = arena_create(1024 * 64);
+    // B 只能推出含 B 的串，B -> bB 与 A -> aB 一并删去；C 仍经由 S -> C 可达
+    Grammar* g = load_grammar("S -> A | C\nA -> aB | a\nB -> bB\nC -> c\n", arena);
+    GrammarReduction report;
+    ASSERT(grammar_reduce(g, &report).status == GRAMMAR_OK);
+    ASSERT(g->rule_count == 4);
+    ASSERT(report.rule_count == 2);
+    ASSERT(report.rules[0].reason == REDUCE_UNPRODUCTIVE);
+    ASSERT_STR_EQ(rule_text(g, &report.rules[0].rule), "A->aB");
+    ASSERT_STR_EQ(rule_text(g, &report.rules[1].rule), "B->bB");
+    ASSERT(report.removed_nonterminals == 1 && report.removed_terminals == 1);
+    ASSERT(grammar_nonterminal_id(g, symbol(g, "B")) == -1);
+    ASSERT(grammar_terminal_id(g, symbol(g, "b")) == -1);
+    ASSERT(grammar_nonterminal_id(g, symbol(g, "C")) == 2);
+    ASSERT(g->nonterminals_count == 3 && g->terminals_count == 2);
+    arena_free(arena);
+}
+
+TEST(test_unproductive_before_unreachable) {
+    Arena* arena = arena_create(1024 * 64);
+    // D 只经由不可终止的 B 可达：先删不可终止的产生式后 D 变得不可达
+    Grammar* g = load_grammar("S -> a | BD\nB -> bB\nD -> d\n", arena);
+    GrammarReduction report;
+    ASSERT(grammar_reduce(g, &report).status == GRAMMAR_OK);
+    ASSERT(g->rule_count == 1);
+    ASSERT(report.rule_count == 3);
+    ASSERT(report.rules[0].reason == REDUCE_UNPRODUCTIVE);
+    ASSERT(report.rules[1].reason == REDUCE_UNPRODUCTIVE);
+    ASSERT(report.rules[2].reason == REDUCE_UNREACHABLE);
+    ASSERT_STR_EQ(rule_text(g, &report.rules[2].rule), "D->d");
+    ASSERT(g->nonterminals_count == 1 && g->terminals_count == 1);
+    ASSERT(report.symbol_count == 4);
+    arena_free(arena);
+}
+
+TEST(test_drop_duplicates_keep_order) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_grammar("S -> aS | b | aS\nS -> #\nS -> # | b\n", arena);
+    GrammarReduction report;
+    ASSERT(grammar_reduce(g, &report).status == GRAMMAR_OK);
+    ASSERT(g->rule_count == 3);
+    ASSERT_STR_EQ(rule_text(g, &g->rules[0]), "S->aS");
+    ASSERT_STR_EQ(rule_text(g, &g->rules[1]), "S->b");
+    ASSERT_STR_EQ(rule_text(g, &g->rules[2]), "S->#");
+    ASSERT(report.rule_count == 3);
+    for (uint32_t i = 0; i < report.rule_count; i++) ASSERT(report.rules[i].reason == REDUCE_DUPLICATE);
+    ASSERT(report.symbol_count == 0);
+    arena_free(arena);
+}
+
+TEST(test_unproductive_start_keeps_start) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_grammar("S -> aS\n", arena);
+    GrammarReduction report;
+    ASSERT(grammar_reduce(g, &report).status == GRAMMAR_OK);
+    ASSERT(g->rule_count == 0);
+    ASSERT(g->nonterminals_count == 1);
+    ASSERT(grammar_nonterminal_id(g, g->start_symbol) == 0);
+    arena_free(arena);
+}
+
+TEST(test_sets_after_reduce) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S -> TX | Z\nX -> +TX | #\nT -> FY\nY -> *FY | #\nF -> i | (S)\n"
+                              "Z -> zZ\nU -> u\nF -> i\n", arena);
+    GrammarReduction report;
+    ASSERT(grammar_reduce(g, &report).status == GRAMMAR_OK);
+    ASSERT(report.rule_count == 4);
+    ASSERT(g->nonterminals_count == 5);
+    // 删去 z、u 之后终结符按原顺序重新编号，位集中不再留空位
+    ASSERT(g->terminals_count == 5);
+    ASSERT(grammar_terminal_id(g, symbol(g, "(")) == 3);
+
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+    compute_follow_sets(g, sets, &count, arena);
+    ASSERT(count == 5);
+    char buffer[64];
+    format_symbol_set(g, sets[0].first, sets[0].nullable, buffer, sizeof(buffer));
+    ASSERT_STR_EQ(buffer, "i(");
+    int f = grammar_nonterminal_id(g, symbol(g, "F"));
+    format_symbol_set(g, sets[f].follow, false, buffer, sizeof(buffer));
+    ASSERT_STR_EQ(buffer, "+*)$");
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_drop_unproductive);
+    RUN_TEST(test_unproductive_before_unreachable);
+    RUN_TEST(test_drop_duplicates_keep_order);
+    RUN_TEST(test_unproductive_start_keeps_start);
+    RUN_TEST(test_sets_after_reduce);
+
+    return failed;
+}
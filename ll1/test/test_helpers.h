@@ -0,0 +1,66 @@
+// 各测试共用的夹具，在被测源文件之后包含。lr0 的测试经 lr0/test/test_helpers.h 一并使用
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+/// 由文本直接解析文法，失败时返回 NULL
+static inline Grammar* load_grammar(const char* text, Arena* arena) {
+    GrammarResultGrammar res = parse_grammar(text, strlen(text), "test", arena);
+    return res.status == GRAMMAR_OK ? res.value : NULL;
+}
+
+static inline SymbolId symbol(Grammar* g, const char* name) {
+    return grammar_lookup_symbol(g, name, strlen(name));
+}
+
+#if defined(FIRST_SET_H) && defined(FOLLOW_SET_H)
+/// 求全部非终结符的 nullable/First/Follow
+static inline SymbolSet* grammar_sets(Grammar* g, Arena* arena) {
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int set_count = 0;
+    compute_first_sets(g, sets, &set_count, arena);
+    compute_follow_sets(g, sets, &set_count, arena);
+    return sets;
+}
+#endif
+
+/// 把单字符 token 串转换为终结符编号
+static inline size_t tokenize(Grammar* g, const char* text, int32_t* out) {
+    size_t n = 0;
+    for (const char* p = text; *p; p++) {
+        out[n++] = grammar_terminal_id(g, grammar_lookup_symbol(g, p, 1));
+    }
+    return n;
+}
+
+// ll1 与 lr0 的分析器输出同样格式的事件流，包含了其中之一时才有事件相关的夹具
+#if defined(LL1_PARSER_H) || defined(LR_PARSER_H)
+typedef struct {
+    char text[512];
+    size_t length;
+    int batches;
+    Grammar* grammar;
+} EventLog;
+
+/// 把事件流写成文本：产生式写成 "A>rhs "，终结符写成自身
+static inline void log_events(void* context, const ParseEvent* events, size_t count) {
+    EventLog* log = context;
+    log->batches++;
+    for (size_t i = 0; i < count; i++) {
+        char* out = log->text + log->length;
+        size_t room = sizeof(log->text) - log->length;
+        if (parse_event_is_rule(events[i])) {
+            const Rule* rule = &log->grammar->rules[parse_event_rule(events[i])];
+            size_t n = format_symbol(log->grammar, rule->left_hs, out, room);
+            out[n++] = '>';
+            n += format_rule_rhs(log->grammar, rule, out + n, room - n);
+            out[n++] = ' ';
+            out[n] = '\0';
+            log->length += n;
+        } else {
+            log->length += format_symbol(log->grammar, log->grammar->terminals[parse_event_terminal(events[i])], out, room);
+        }
+    }
+}
+#endif
+
+#endif
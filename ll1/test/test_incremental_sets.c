@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/incremental_sets.h"
+#include "../src/incremental_sets.c"
+
+#include "test_helpers.h"
+
+/// 与从头计算的结果逐个比较，返回不一致的非终结符个数
+static int count_differences(IncrementalSets* inc) {
+    Grammar* g = inc->grammar;
+    Arena* arena = arena_create(1024 * 1024);
+    SymbolSet* expected = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int count = 0;
+    compute_first_sets(g, expected, &count, arena);
+    compute_follow_sets(g, expected, &count, arena);
+    size_t words = symbol_set_words(g);
+    int differences = 0;
+    for (int i = 0; i < count; i++) {
+        const SymbolSet* actual = &inc->sets[i];
+        if (actual->nullable != expected[i].nullable ||
+            memcmp(actual->first, expected[i].first, words * sizeof(uint64_t)) != 0 ||
+            memcmp(actual->follow, expected[i].follow, words * sizeof(uint64_t)) != 0) {
+            differences++;
+        }
+    }
+    if ((uint32_t)count != inc->set_count) differences++;
+    arena_free(arena);
+    return differences;
+}
+
+static const char* first_of(IncrementalSets* inc, const char* name) {
+    static char buffer[256];
+    const SymbolSet* set = &inc->sets[grammar_nonterminal_id(inc->grammar, symbol(inc->grammar, name))];
+    format_symbol_set(inc->grammar, set->first, set->nullable, buffer, sizeof(buffer));
+    return buffer;
+}
+
+static const char* follow_of(IncrementalSets* inc, const char* name) {
+    static char buffer[256];
+    const SymbolSet* set = &inc->sets[grammar_nonterminal_id(inc->grammar, symbol(inc->grammar, name))];
+    format_symbol_set(inc->grammar, set->follow, false, buffer, sizeof(buffer));
+    return buffer;
+}
+
+// --- Test functions ---
+TEST(test_add_rule_propagates) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S -> TX\nX -> +TX | #\nT -> FY\nY -> *FY | #\nF -> i\n", arena);
+    IncrementalSets inc;
+    ASSERT(incremental_sets_init(&inc, g, arena));
+    ASSERT_STR_EQ(first_of(&inc, "S"), "i");
+
+    // F -> (S) 让 '(' 进入 F、T、S 的 First 集，')' 进入 S、X 的 Follow 集
+    SymbolId rhs[] = { symbol(g, "("), symbol(g, "S"), symbol(g, ")") };
+    ASSERT(rhs[0] == GRAMMAR_NO_SYMBOL);
+    rhs[0] = grammar_intern_symbol(g, "(", 1, true).value;
+    rhs[2] = grammar_intern_symbol(g, ")", 1, true).value;
+    ASSERT(incremental_add_rule(&inc, symbol(g, "F"), rhs, 3));
+    ASSERT_STR_EQ(first_of(&inc, "S"), "i(");
+    ASSERT_STR_EQ(follow_of(&inc, "X"), ")$");
+    ASSERT_STR_EQ(follow_of(&inc, "F"), "+*)$");
+    ASSERT(count_differences(&inc) == 0);
+
+    // T -> # 使 T 可空，S 随之可空
+    ASSERT(incremental_add_rule(&inc, symbol(g, "T"), NULL, 0));
+    ASSERT_STR_EQ(first_of(&inc, "S"), "#+i(");
+    ASSERT(count_differences(&inc) == 0);
+    arena_free(arena);
+}
+
+TEST(test_remove_rule_shrinks) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S -> AB\nA -> a | #\nB -> b | A\n", arena);
+    IncrementalSets inc;
+    ASSERT(incremental_sets_init(&inc, g, arena));
+    ASSERT_STR_EQ(first_of(&inc, "S"), "#ab");
+
+    // 删除 A -> #：A、B、S 都不再可空
+    ASSERT(incremental_remove_rule(&inc, 2));
+    ASSERT_STR_EQ(first_of(&inc, "S"), "a");
+    ASSERT_STR_EQ(first_of(&inc, "B"), "ab");
+    ASSERT_STR_EQ(follow_of(&inc, "A"), "ab$");
+    ASSERT(count_differences(&inc) == 0);
+
+    // 最后一条产生式 B -> A 已移到下标 2，B -> b 现在是最后一条
+    ASSERT(g->rule_count == 4);
+    ASSERT(g->rules[2].left_hs == symbol(g, "B") && g->rules[2].right_hs[0] == symbol(g, "A"));
+    ASSERT(incremental_remove_rule(&inc, 3));
+    ASSERT(g->rule_count == 3);
+    ASSERT_STR_EQ(first_of(&inc, "B"), "a");
+    ASSERT(count_differences(&inc) == 0);
+    ASSERT(!incremental_remove_rule(&inc, 7));
+    arena_free(arena);
+}
+
+TEST(test_new_terminals_move_end_marker) {
+    Arena* arena = arena_create(1024 * 1024);
+    Grammar* g = load_grammar("S -> Aa\nA -> b | #\n", arena);
+    IncrementalSets inc;
+    ASSERT(incremental_sets_init(&inc, g, arena));
+    // 逐个加入 100 个新终结符，位集跨过 64 位的字边界
+    for (int i = 0; i < 100; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "t%d", i);
+        SymbolId rhs[] = { grammar_intern_symbol(g, name, strlen(name), true).value, symbol(g, "S") };
+        ASSERT(rhs[0] >= 0);
+        if (!incremental_add_rule(&inc, symbol(g, "A"), rhs, i % 2 ? 2 : 1)) break;
+    }
+    ASSERT(g->terminals_count == 102);
+    ASSERT(bitset_contains(inc.sets[0].follow, grammar_end_marker_id(g)));
+    ASSERT(count_differences(&inc) == 0);
+    arena_free(arena);
+}
+
+TEST(test_random_edits_match_full_recompute) {
+    Arena* arena = arena_create(16 * 1024 * 1024);
+    Grammar* g = load_grammar("S -> AB | c\nA -> aA | #\nB -> bC | D\nC -> c | SD\nD -> d | #\n", arena);
+    IncrementalSets inc;
+    ASSERT(incremental_sets_init(&inc, g, arena));
+    const char* nonterminals = "SABCDEFG";
+    const char* terminals = "abcdefg";
+    srand(17);
+    int mismatches = 0;
+    for (int round = 0; round < 3000; round++) {
+        if (g->rule_count > 3 && rand() % 100 < 45) {
+            if (!incremental_remove_rule(&inc, (uint32_t)rand() % g->rule_count)) mismatches++;
+        } else {
+            SymbolId rhs[4];
+            uint32_t count = (uint32_t)(rand() % 5);
+            for (uint32_t i = 0; i < count; i++) {
+                bool terminal = rand() % 3 == 0;
+                char c = terminal ? terminals[rand() % 7] : nonterminals[rand() % 8];
+                rhs[i] = grammar_intern_symbol(g, &c, 1, terminal).value;
+            }
+            char lhs = nonterminals[rand() % 8];
+            if (!incremental_add_rule(&inc, grammar_intern_symbol(g, &lhs, 1, false).value, rhs, count)) mismatches++;
+        }
+        if (count_differences(&inc) != 0) mismatches++;
+    }
+    ASSERT(mismatches == 0);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_add_rule_propagates);
+    RUN_TEST(test_remove_rule_shrinks);
+    RUN_TEST(test_new_terminals_move_end_marker);
+    RUN_TEST(test_random_edits_match_full_recompute);
+
+    return failed;
+}
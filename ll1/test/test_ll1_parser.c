@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+#include "../src/ll1_parser.h"
+#include "../src/ll1_parser.c"
+
+#include "test_helpers.h"
+
+// 经典的 LL(1) 表达式文法（X 即 E'，Y 即 T'）
+static Grammar* load_expression_grammar(Arena* arena, ParseTable* table) {
+    Grammar* g = load_grammar("S -> TX\nX -> +TX | #\nT -> FY\nY -> *FY | #\nF -> (S) | i\n", arena);
+    return g && build_parse_table(g, grammar_sets(g, arena), table, arena) ? g : NULL;
+}
+
+static LL1ParseResult parse_text(Grammar* g, LL1Parser* parser, const char* text) {
+    int32_t tokens[256];
+    TokenArray array = { tokens, tokenize(g, text, tokens), 0, (int)g->terminals_count };
+    TokenIterator input = { token_array_next, &array };
+    return ll1_parse(parser, &input);
+}
+
+// --- Test functions ---
+TEST(test_leftmost_derivation_events) {
+    Arena* arena = arena_create(1024 * 64);
+    ParseTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    ASSERT(g != NULL);
+    EventLog log = { .grammar = g };
+    LL1Parser parser;
+    ASSERT(ll1_parser_init(&parser, g, &table, 64, 64, log_events, &log, arena));
+
+    LL1ParseResult r = parse_text(g, &parser, "i+i*i");
+    ASSERT(r.status == LL1_PARSE_OK);
+    ASSERT(r.token_count == 5);
+    ASSERT_STR_EQ(log.text, "S>TX T>FY F>i iY># X>+TX +T>FY F>i iY>*FY *F>i iY># X># ");
+    ASSERT(log.batches == 1);
+    arena_free(arena);
+}
+
+TEST(test_events_flushed_in_batches) {
+    Arena* arena = arena_create(1024 * 64);
+    ParseTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    EventLog small = { .grammar = g };
+    EventLog large = { .grammar = g };
+    LL1Parser p1, p2;
+    ASSERT(ll1_parser_init(&p1, g, &table, 64, 3, log_events, &small, arena));
+    ASSERT(ll1_parser_init(&p2, g, &table, 64, 256, log_events, &large, arena));
+
+    ASSERT(parse_text(g, &p1, "(i*(i+i))").status == LL1_PARSE_OK);
+    ASSERT(parse_text(g, &p2, "(i*(i+i))").status == LL1_PARSE_OK);
+    ASSERT_STR_EQ(small.text, large.text);
+    ASSERT(small.batches > 1);
+    arena_free(arena);
+}
+
+TEST(test_syntax_errors) {
+    Arena* arena = arena_create(1024 * 64);
+    ParseTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    LL1Parser parser;
+    ASSERT(ll1_parser_init(&parser, g, &table, 64, 64, NULL, NULL, arena));
+
+    LL1ParseResult r = parse_text(g, &parser, "i+*i");
+    ASSERT(r.status == LL1_PARSE_SYNTAX_ERROR);
+    ASSERT(r.token_count == 2);
+    ASSERT(r.error_terminal == grammar_terminal_id(g, grammar_lookup_symbol(g, "*", 1)));
+
+    r = parse_text(g, &parser, "(i");
+    ASSERT(r.status == LL1_PARSE_SYNTAX_ERROR);
+    ASSERT(r.error_terminal == (int)g->terminals_count);
+
+    r = parse_text(g, &parser, "i)");
+    ASSERT(r.status == LL1_PARSE_SYNTAX_ERROR);
+    ASSERT(r.token_count == 1);
+
+    r = parse_text(g, &parser, "");
+    ASSERT(r.status == LL1_PARSE_SYNTAX_ERROR);
+    arena_free(arena);
+}
+
+TEST(test_stack_is_bounded) {
+    Arena* arena = arena_create(1024 * 64);
+    ParseTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    LL1Parser parser;
+    ASSERT(ll1_parser_init(&parser, g, &table, 16, 64, NULL, NULL, arena));
+
+    ASSERT(parse_text(g, &parser, "(i)").status == LL1_PARSE_OK);
+    LL1ParseResult r = parse_text(g, &parser, "((((((((i))))))))");
+    ASSERT(r.status == LL1_PARSE_STACK_OVERFLOW);
+    // 溢出后分析器可以继续使用
+    ASSERT(parse_text(g, &parser, "i*i").status == LL1_PARSE_OK);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_leftmost_derivation_events);
+    RUN_TEST(test_events_flushed_in_batches);
+    RUN_TEST(test_syntax_errors);
+    RUN_TEST(test_stack_is_bounded);
+
+    return failed;
+}
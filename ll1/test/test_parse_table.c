@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+#include "test_helpers.h"
+
+static bool analyse(Grammar* g, ParseTable* table, Arena* arena) {
+    return build_parse_table(g, grammar_sets(g, arena), table, arena);
+}
+
+/// 表项 M[A, a] 对应产生式的右部，出错格返回 "-"
+static const char* entry(Grammar* g, ParseTable* table, const char* nonterminal, const char* terminal) {
+    static char buffer[256];
+    int row = grammar_nonterminal_id(g, grammar_lookup_symbol(g, nonterminal, strlen(nonterminal)));
+    int column = strcmp(terminal, "$") == 0 ? (int)g->terminals_count
+                                             : grammar_terminal_id(g, grammar_lookup_symbol(g, terminal, strlen(terminal)));
+    int rule = parse_table_lookup(table, row, column);
+    if (rule == PARSE_TABLE_ERROR) return "-";
+    format_rule_rhs(g, &g->rules[rule], buffer, sizeof(buffer));
+    return buffer;
+}
+
+// --- Test functions ---
+TEST(test_expression_table) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_grammar("S -> TX\nX -> +TX | #\nT -> FY\nY -> *FY | #\nF -> (S) | i\n", arena);
+    ASSERT(g != NULL);
+    ParseTable table;
+    ASSERT(analyse(g, &table, arena));
+
+    ASSERT(table.conflict_count == 0);
+    ASSERT(table.row_count == 5);
+    ASSERT(table.column_count == g->terminals_count + 1);
+    ASSERT_STR_EQ(entry(g, &table, "S", "i"), "TX");
+    ASSERT_STR_EQ(entry(g, &table, "S", "("), "TX");
+    ASSERT_STR_EQ(entry(g, &table, "S", "+"), "-");
+    ASSERT_STR_EQ(entry(g, &table, "X", "+"), "+TX");
+    ASSERT_STR_EQ(entry(g, &table, "X", ")"), "#");
+    ASSERT_STR_EQ(entry(g, &table, "X", "$"), "#");
+    ASSERT_STR_EQ(entry(g, &table, "Y", "+"), "#");
+    ASSERT_STR_EQ(entry(g, &table, "Y", "*"), "*FY");
+    ASSERT_STR_EQ(entry(g, &table, "F", "("), "(S)");
+    ASSERT_STR_EQ(entry(g, &table, "F", "$"), "-");
+    arena_free(arena);
+}
+
+TEST(test_rule_first) {
+    Arena* arena = arena_create(1024 * 64);
+    Grammar* g = load_grammar("S -> AB | c\nA -> a | #\nB -> b | #\n", arena);
+    ASSERT(g != NULL);
+    ParseTable table;
+    ASSERT(analyse(g, &table, arena));
+
+    char buffer[64];
+    format_symbol_set(g, parse_table_rule_first(&table, 0), table.rule_nullable[0], buffer, sizeof(buffer));
+    ASSERT_STR_EQ(buffer, "#ab");
+    format_symbol_set(g, parse_table_rule_first(&table, 1), table.rule_nullable[1], buffer, sizeof(buffer));
+    ASSERT_STR_EQ(buffer, "c");
+    ASSERT_STR_EQ(entry(g, &table, "S", "$"), "AB");
+    ASSERT_STR_EQ(entry(g, &table, "A", "b"), "#");
+    arena_free(arena);
+}
+
+TEST(test_reports_all_conflicts) {
+    Arena* arena = arena_create(1024 * 64);
+    // 左递归与公共前缀各产生冲突
+    Grammar* g = load_grammar("<e> -> <e> '+' 'id' | 'id'\n<s> -> 'if' <e> | 'if' <e> 'else'\n", arena);
+    ASSERT(g != NULL);
+    ParseTable table;
+    ASSERT(analyse(g, &table, arena));
+
+    ASSERT(table.conflict_count == 2);
+    ASSERT(table.conflicts[0].chosen == 0 && table.conflicts[0].rejected == 1);
+    ASSERT(table.conflicts[1].chosen == 2 && table.conflicts[1].rejected == 3);
+    ASSERT(table.conflicts[0].terminal == (uint32_t)grammar_terminal_id(g, grammar_lookup_symbol(g, "id", 2)));
+    ASSERT_STR_EQ(entry(g, &table, "e", "id"), "<e> + 'id'");
+    arena_free(arena);
+}
+
+TEST(test_large_grammar) {
+    // 数百个非终结符、上千条产生式的 LL(1) 文法：n_i -> t_i n_{i+1} | u_i | #
+    FILE* f = fopen("temp_grammar.txt", "w");
+    for (int i = 0; i < 400; i++) {
+        fprintf(f, "<n%d> -> 't%d' <n%d> | 'u%d' | #\n", i, i, (i + 1) % 400, i);
+    }
+    fclose(f);
+    Arena* arena = arena_create(8 * 1024 * 1024);
+    Grammar* g = read_grammar("temp_grammar.txt", arena).value;
+    remove("temp_grammar.txt");
+    ASSERT(g != NULL);
+    ParseTable table;
+    ASSERT(analyse(g, &table, arena));
+
+    ASSERT(g->rule_count == 1200);
+    ASSERT(table.conflict_count == 0);
+    int filled = 0;
+    for (uint32_t i = 0; i < table.row_count * table.column_count; i++) {
+        if (table.cells[i] != PARSE_TABLE_ERROR) filled++;
+    }
+    // 每行恰好三格：t_i、u_i，以及空产生式的 Follow = { '$' }
+    ASSERT(filled == 400 * 3);
+    ASSERT_STR_EQ(entry(g, &table, "n7", "t7"), "'t7' <n8>");
+    ASSERT_STR_EQ(entry(g, &table, "n7", "u8"), "-");
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_expression_table);
+    RUN_TEST(test_rule_first);
+    RUN_TEST(test_reports_all_conflicts);
+    RUN_TEST(test_large_grammar);
+
+    return failed;
+}
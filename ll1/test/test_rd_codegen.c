@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+#include "../src/ll1_parser.h"
+#include "../src/ll1_parser.c"
+
+#include "../src/rd_codegen.h"
+#include "../src/rd_codegen.c"
+
+// 由 bench_grammar.txt 生成并提交的分析器
+#include "bench_rd_parser.c"
+
+static Grammar* analyse_file(const char* filename, ParseTable* table, Arena* arena) {
+    GrammarResultGrammar res = read_grammar(filename, arena);
+    if (res.status != GRAMMAR_OK) return NULL;
+    Grammar* g = res.value;
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+    compute_follow_sets(g, sets, &count, arena);
+    return build_parse_table(g, sets, table, arena) ? g : NULL;
+}
+
+static char* read_file(const char* filename, size_t* length) {
+    FILE* f = fopen(filename, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = malloc((size_t)size + 1);
+    *length = fread(text, 1, (size_t)size, f);
+    text[*length] = '\0';
+    fclose(f);
+    return text;
+}
+
+typedef struct {
+    ParseEvent events[4096];
+    size_t count;
+} EventBuffer;
+
+static void collect_events(void* context, const ParseEvent* events, size_t count) {
+    EventBuffer* buffer = context;
+    for (size_t i = 0; i < count && buffer->count < 4096; i++) buffer->events[buffer->count++] = events[i];
+}
+
+// --- Test functions ---
+TEST(test_checked_in_parser_is_up_to_date) {
+    Arena* arena = arena_create(1024 * 256);
+    ParseTable table;
+    Grammar* g = analyse_file("bench_grammar.txt", &table, arena);
+    ASSERT(g != NULL);
+    FILE* out = fopen("temp_rd_parser.c", "w");
+    ASSERT(generate_rd_parser(g, &table, "bench", "../src/ll1_parser.h", out));
+    fclose(out);
+
+    size_t expected_length = 0, actual_length = 0;
+    char* expected = read_file("bench_rd_parser.c", &expected_length);
+    char* actual = read_file("temp_rd_parser.c", &actual_length);
+    ASSERT(expected != NULL && actual != NULL);
+    ASSERT(expected_length == actual_length && memcmp(expected, actual, expected_length) == 0);
+    remove("temp_rd_parser.c");
+    free(expected);
+    free(actual);
+    arena_free(arena);
+}
+
+TEST(test_tail_recursion_becomes_loop) {
+    size_t length = 0;
+    char* text = read_file("bench_rd_parser.c", &length);
+    ASSERT(text != NULL);
+    // <expr_rest> -> '+' <term> <expr_rest>：循环而不是递归调用自身
+    ASSERT(strstr(text, "for(;;){") != NULL);
+    ASSERT(strstr(text, "            continue;\n") != NULL);
+    free(text);
+}
+
+TEST(test_matches_table_parser) {
+    Arena* arena = arena_create(1024 * 256);
+    ParseTable table;
+    Grammar* g = analyse_file("bench_grammar.txt", &table, arena);
+    ASSERT(g != NULL);
+    static EventBuffer table_events, rd_events;
+    LL1Parser parser;
+    ASSERT(ll1_parser_init(&parser, g, &table, 256, 64, collect_events, &table_events, arena));
+
+    // 随机 token 串：大多数有语法错误，两种分析器的结果与事件流必须完全一致
+    srand(11);
+    int mismatches = 0;
+    int accepted = 0;
+    for (int round = 0; round < 2000; round++) {
+        int32_t tokens[64];
+        size_t n = (size_t)(rand() % 12);
+        for (size_t i = 0; i < n; i++) {
+            // 偏向 id 与运算符交替，提高合法输入的比例
+            tokens[i] = (i % 2 == 0 && rand() % 4) ? grammar_terminal_id(g, grammar_lookup_symbol(g, "id", 2))
+                                                    : rand() % (int)g->terminals_count;
+        }
+        if (n && rand() % 2) tokens[n - 1] = grammar_terminal_id(g, grammar_lookup_symbol(g, ";", 1));
+        table_events.count = rd_events.count = 0;
+
+        TokenArray a1 = { tokens, n, 0, (int)g->terminals_count };
+        TokenIterator i1 = { token_array_next, &a1 };
+        LL1ParseResult r1 = ll1_parse(&parser, &i1);
+
+        ParseEvent buffer[16];
+        TokenArray a2 = { tokens, n, 0, (int)g->terminals_count };
+        TokenIterator i2 = { token_array_next, &a2 };
+        LL1ParseResult r2 = bench_parse(&i2, buffer, 16, collect_events, &rd_events, 256);
+
+        if (r1.status == LL1_PARSE_OK) accepted++;
+        if (r1.status != r2.status || r1.token_count != r2.token_count || r1.error_terminal != r2.error_terminal ||
+            table_events.count != rd_events.count ||
+            memcmp(table_events.events, rd_events.events, table_events.count * sizeof(ParseEvent)) != 0) {
+            mismatches++;
+        }
+    }
+    ASSERT(mismatches == 0);
+    ASSERT(accepted > 50);
+    arena_free(arena);
+}
+
+TEST(test_depth_limit) {
+    Arena* arena = arena_create(1024 * 256);
+    ParseTable table;
+    Grammar* g = analyse_file("bench_grammar.txt", &table, arena);
+    ASSERT(g != NULL);
+    int lp = grammar_terminal_id(g, grammar_lookup_symbol(g, "(", 1));
+    int rp = grammar_terminal_id(g, grammar_lookup_symbol(g, ")", 1));
+    int id = grammar_terminal_id(g, grammar_lookup_symbol(g, "id", 2));
+    int semi = grammar_terminal_id(g, grammar_lookup_symbol(g, ";", 1));
+    int32_t tokens[] = { lp, lp, lp, lp, lp, lp, id, rp, rp, rp, rp, rp, rp, semi };
+    ParseEvent buffer[16];
+
+    TokenArray a = { tokens, 14, 0, (int)g->terminals_count };
+    TokenIterator input = { token_array_next, &a };
+    ASSERT(bench_parse(&input, buffer, 16, NULL, NULL, 64).status == LL1_PARSE_OK);
+    a.pos = 0;
+    ASSERT(bench_parse(&input, buffer, 16, NULL, NULL, 8).status == LL1_PARSE_STACK_OVERFLOW);
+    arena_free(arena);
+}
+
+TEST(test_rejects_conflicts) {
+    FILE* f = fopen("temp_grammar.txt", "w");
+    fprintf(f, "<e> -> <e> '+' 'id' | 'id'\n");
+    fclose(f);
+    Arena* arena = arena_create(1024 * 64);
+    ParseTable table;
+    Grammar* g = analyse_file("temp_grammar.txt", &table, arena);
+    remove("temp_grammar.txt");
+    ASSERT(g != NULL);
+    FILE* out = fopen("temp_rd_parser.c", "w");
+    ASSERT(!generate_rd_parser(g, &table, "bad", "ll1_parser.h", out));
+    ASSERT(!generate_rd_parser(g, &table, "1bad", "ll1_parser.h", out));
+    fclose(out);
+    remove("temp_rd_parser.c");
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_checked_in_parser_is_up_to_date);
+    RUN_TEST(test_tail_recursion_becomes_loop);
+    RUN_TEST(test_matches_table_parser);
+    RUN_TEST(test_depth_limit);
+    RUN_TEST(test_rejects_conflicts);
+
+    return failed;
+}
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/first_follow.h"
+#include "../src/first_follow.c"
+
+#include "../src/digraph.h"
+#include "../src/digraph.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/first_set.h"
+#include "../src/first_set.c"
+
+#include "../src/follow_set.h"
+#include "../src/follow_set.c"
+
+#include "../src/table_compress.h"
+#include "../src/table_compress.c"
+
+#include "../src/parse_table.h"
+#include "../src/parse_table.c"
+
+/// 随机稀疏表：约 density% 的格非空，取值落在 [0, values)
+static int32_t* random_table(uint32_t rows, uint32_t columns, int density, int values) {
+    int32_t* cells = malloc((size_t)rows * columns * sizeof(int32_t));
+    for (size_t i = 0; i < (size_t)rows * columns; i++) {
+        cells[i] = rand() % 100 < density ? rand() % values : -1;
+    }
+    return cells;
+}
+
+static int count_mismatches(const int32_t* cells, uint32_t rows, uint32_t columns, const CompressedTable* t, bool fill_errors) {
+    int mismatches = 0;
+    for (uint32_t r = 0; r < rows; r++) {
+        for (uint32_t c = 0; c < columns; c++) {
+            int32_t expected = cells[(size_t)r * columns + c];
+            if (fill_errors && expected == -1) continue;
+            if (compressed_table_lookup(t, r, c) != expected) mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// --- Test functions ---
+TEST(test_lossless_random_tables) {
+    srand(7);
+    uint32_t shapes[][2] = { { 1, 1 }, { 5, 3 }, { 40, 25 }, { 200, 120 }, { 7, 300 } };
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        Arena* arena = arena_create(1024 * 1024 * 4);
+        uint32_t rows = shapes[s][0], columns = shapes[s][1];
+        int32_t* cells = random_table(rows, columns, 10, 30);
+        CompressedTable t;
+        ASSERT(compress_table(cells, rows, columns, -1, false, &t, arena));
+        ASSERT(count_mismatches(cells, rows, columns, &t, false) == 0);
+        free(cells);
+        arena_free(arena);
+    }
+}
+
+TEST(test_sparse_table_shrinks) {
+    srand(3);
+    Arena* arena = arena_create(1024 * 1024 * 4);
+    uint32_t rows = 300, columns = 200;
+    int32_t* cells = random_table(rows, columns, 3, 50);
+    CompressedTable t;
+    ASSERT(compress_table(cells, rows, columns, -1, false, &t, arena));
+    ASSERT(count_mismatches(cells, rows, columns, &t, false) == 0);
+    // 约 3% 的格非空，叠放后槽数应远小于原表格数
+    ASSERT(t.slot_count < rows * columns / 10);
+    ASSERT(compressed_table_bytes(&t) < (size_t)rows * columns * sizeof(int32_t) / 4);
+    free(cells);
+    arena_free(arena);
+}
+
+TEST(test_identical_columns_merge) {
+    Arena* arena = arena_create(1024 * 64);
+    // 列 0、2、3 相同，列 1、4 相同
+    int32_t cells[] = {
+        1, -1, 1, 1, -1,
+        -1, 2, -1, -1, 2,
+        3, 3, 3, 3, 3,
+    };
+    CompressedTable t;
+    ASSERT(compress_table(cells, 3, 5, -1, false, &t, arena));
+    ASSERT(t.class_count == 2);
+    ASSERT(t.column_class[0] == t.column_class[2] && t.column_class[2] == t.column_class[3]);
+    ASSERT(t.column_class[1] == t.column_class[4]);
+    ASSERT(t.row_default[2] == 3);
+    ASSERT(count_mismatches(cells, 3, 5, &t, false) == 0);
+    arena_free(arena);
+}
+
+TEST(test_fill_errors_keeps_entries) {
+    srand(5);
+    Arena* arena = arena_create(1024 * 1024 * 4);
+    uint32_t rows = 120, columns = 80;
+    int32_t* cells = random_table(rows, columns, 20, 4);
+    CompressedTable exact, filled;
+    ASSERT(compress_table(cells, rows, columns, -1, false, &exact, arena));
+    ASSERT(compress_table(cells, rows, columns, -1, true, &filled, arena));
+    ASSERT(count_mismatches(cells, rows, columns, &filled, true) == 0);
+    ASSERT(filled.slot_count <= exact.slot_count);
+    // 全部出错的行默认值仍为出错
+    for (uint32_t c = 0; c < columns; c++) cells[c] = -1;
+    ASSERT(compress_table(cells, rows, columns, -1, true, &filled, arena));
+    ASSERT(filled.row_default[0] == -1);
+    ASSERT(compressed_table_lookup(&filled, 0, 5) == -1);
+    free(cells);
+    arena_free(arena);
+}
+
+TEST(test_compress_parse_table) {
+    FILE* f = fopen("temp_grammar.txt", "w");
+    fprintf(f, "S -> TX\nX -> +TX | -TX | #\nT -> FY\nY -> *FY | /FY | #\nF -> (S) | i | n\n");
+    fclose(f);
+    Arena* arena = arena_create(1024 * 256);
+    GrammarResultGrammar res = read_grammar("temp_grammar.txt", arena);
+    remove("temp_grammar.txt");
+    ASSERT(res.status == GRAMMAR_OK);
+    Grammar* g = res.value;
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int count = 0;
+    compute_first_sets(g, sets, &count, arena);
+    compute_follow_sets(g, sets, &count, arena);
+    ParseTable table;
+    ASSERT(build_parse_table(g, sets, &table, arena));
+
+    CompressedTable exact, defaults;
+    ASSERT(compress_parse_table(&table, false, &exact, arena));
+    ASSERT(compress_parse_table(&table, true, &defaults, arena));
+    int mismatches = 0;
+    for (uint32_t r = 0; r < table.row_count; r++) {
+        for (uint32_t c = 0; c < table.column_count; c++) {
+            int expected = parse_table_lookup(&table, (int)r, (int)c);
+            if (compressed_table_lookup(&exact, r, c) != expected) mismatches++;
+            if (expected != PARSE_TABLE_ERROR && compressed_table_lookup(&defaults, r, c) != expected) mismatches++;
+        }
+    }
+    ASSERT(mismatches == 0);
+    // ')' 与 '$' 只出现在 X、Y 的 Follow 集中，两列完全相同；'i' 与 'n' 选择的产生式不同
+    int rparen = grammar_terminal_id(g, grammar_lookup_symbol(g, ")", 1));
+    int i = grammar_terminal_id(g, grammar_lookup_symbol(g, "i", 1));
+    int n = grammar_terminal_id(g, grammar_lookup_symbol(g, "n", 1));
+    ASSERT(exact.class_count == table.column_count - 1);
+    ASSERT(exact.column_class[rparen] == exact.column_class[g->terminals_count]);
+    ASSERT(exact.column_class[i] != exact.column_class[n]);
+    // Y 行中 Follow(Y) = {+, -, ), $} 都取 Y -> #，成为默认值
+    int y = grammar_nonterminal_id(g, grammar_lookup_symbol(g, "Y", 1));
+    ASSERT(defaults.row_default[y] == parse_table_lookup(&table, y, (int)g->terminals_count));
+    arena_free(arena);
+}
+
+TEST(test_empty_table) {
+    Arena* arena = arena_create(1024 * 64);
+    CompressedTable t;
+    ASSERT(compress_table(NULL, 0, 0, -1, false, &t, arena));
+    ASSERT(t.class_count == 0 && t.slot_count == 0);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_lossless_random_tables);
+    RUN_TEST(test_sparse_table_shrinks);
+    RUN_TEST(test_identical_columns_merge);
+    RUN_TEST(test_fill_errors_keeps_entries);
+    RUN_TEST(test_compress_parse_table);
+    RUN_TEST(test_empty_table);
+
+    return failed;
+}
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h> 
+#include <string.h>
 
 // Arena
 #include "src/arena.h"      
@@ -10,10 +11,111 @@
 #include "src/grammar.h"
 #include "src/grammar.c"
 
+#include "../ll1/src/grammar_reduce.h"
+#include "../ll1/src/grammar_reduce.c"
+
+#include "../ll1/src/first_follow.h"
+#include "../ll1/src/first_follow.c"
+
+#include "../ll1/src/digraph.h"
+#include "../ll1/src/digraph.c"
+
+#include "../ll1/src/first_set.h"
+#include "../ll1/src/first_set.c"
+
+#include "../ll1/src/follow_set.h"
+#include "../ll1/src/follow_set.c"
+
 #include "src/viable_prefix_dfa.h"
 #include "src/viable_prefix_dfa.c"
 
-int main(){
+#include "../ll1/src/table_compress.h"
+#include "../ll1/src/table_compress.c"
+
+#include "src/lr_table.h"
+#include "src/lr_table.c"
+
+#include "src/slr_table.h"
+#include "src/slr_table.c"
+
+#include "src/lalr_table.h"
+#include "src/lalr_table.c"
+
+#include "src/lr1_table.h"
+#include "src/lr1_table.c"
+
+#include "src/lr_unit_rules.h"
+#include "src/lr_unit_rules.c"
+
+#include "../ll1/src/grammar_cache.h"
+#include "../ll1/src/grammar_cache.c"
+
+#include "src/lr_cache.h"
+#include "src/lr_cache.c"
+
+#define CACHE_PATH "grammar.lr0.cache"
+
+// 由自动机生成分析表的方法；名字同时用作命令行参数与缓存键的一部分
+typedef enum TableMethod{
+    METHOD_LR0,
+    METHOD_SLR1,
+    METHOD_LALR1,
+    METHOD_LR1,
+    METHOD_COUNT
+} TableMethod;
+
+static const char* const method_options[METHOD_COUNT] = { "lr0", "slr1", "lalr1", "lr1" };
+static const char* const method_titles[METHOD_COUNT] = { "LR(0)", "SLR(1)", "LALR(1)", "LR(1)" };
+
+// 构造自动机与分析表。LR(1) 用 Pager 合并后的 LR(1) 自动机，其余方法都用 LR(0) 自动机
+static bool build_table(TableMethod method, Grammar* grammar, DFA* dfa, LRTable* table, Arena* arena) {
+    if (method != METHOD_LR1) build_viable_prefix_dfa(grammar, dfa, arena);
+    if (method == METHOD_LR0) return build_lr0_table(dfa, table, arena);
+    SymbolSet* sets = arena_alloc(arena, (grammar->nonterminals_count + 1) * sizeof(SymbolSet));
+    if (!sets) {
+        fprintf(stderr, "Error: Failed to allocate memory for First/Follow sets.\n");
+        return false;
+    }
+    int set_count = 0;
+    compute_first_sets(grammar, sets, &set_count, arena);
+    compute_follow_sets(grammar, sets, &set_count, arena);
+    if (method == METHOD_SLR1) return build_slr1_table(dfa, sets, table, arena);
+    if (method == METHOD_LALR1) return build_lalr1_table(dfa, sets, table, arena);
+    LR1Automaton lr1;
+    if (!build_lr1_automaton(grammar, sets, LR1_PAGER, &lr1, arena)) return false;
+    *dfa = lr1.dfa;
+    return build_lr1_table(&lr1, table, arena);
+}
+
+static bool save_analysis(uint64_t key, const Grammar* grammar, const LRTable* table, Arena* arena) {
+    GrammarCacheWriter writer;
+    grammar_cache_writer_init(&writer);
+    return grammar_cache_put_grammar(&writer, grammar, arena) && cache_put_lr_table(&writer, table, arena) &&
+           grammar_cache_write(CACHE_PATH, key, &writer);
+}
+
+// 用法：main [-r] [-n] [-u] [-m lr0|slr1|lalr1|lr1]，-r 表示构造 DFA 前先化简文法，-n 表示不读写缓存，
+// -u 表示在分析表中绕过单产生式的归约，-m 选择分析表（默认 lr0）。
+// 文法与分析表按文法内容的散列缓存在 grammar.lr0.cache 中，命中时不再构造自动机，也不打印 DFA
+int main(int argc, char** argv){
+    bool reduce = false, use_cache = true, bypass_units = false;
+    TableMethod method = METHOD_LR0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0) reduce = true;
+        else if (strcmp(argv[i], "-n") == 0) use_cache = false;
+        else if (strcmp(argv[i], "-u") == 0) bypass_units = true;
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (method = 0; method < METHOD_COUNT && strcmp(name, method_options[method]) != 0; method++) {}
+            if (method == METHOD_COUNT) {
+                fprintf(stderr, "Unknown table method: %s\n", name);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [-r] [-n] [-u] [-m lr0|slr1|lalr1|lr1]\n", argv[0]);
+            return 1;
+        }
+    }
     Arena* grammar_arena = arena_create(1024*1024);
     Arena* dfa_arena = arena_create(1024 * 1024);
     if (!grammar_arena || !dfa_arena) {
@@ -24,36 +126,77 @@ int main(){
     }
 
     char filename[] = "grammar.txt";
-    // Grammar* grammar = read_grammar(filename, grammar_arena);
-    GrammarResultGrammar result =  read_grammar(filename, grammar_arena);
-    if (result.status != GRAMMAR_OK) {
-        fprintf(stderr, "Error: Failed to read grammar from file. Status code: %d\n", result.status);
-        arena_free(grammar_arena);
-        return 1;
+    uint64_t key = 0;
+    char variant[32];
+    snprintf(variant, sizeof(variant), "%s%s%s", method_options[method], reduce ? " -r" : "", bypass_units ? " -u" : "");
+    use_cache = use_cache && grammar_cache_key(filename, variant, &key);
+    GrammarCache cache = {0};
+    Grammar* grammar = NULL;
+    LRTable table;
+    bool cached = use_cache && grammar_cache_open(CACHE_PATH, key, &cache);
+    if (cached) {
+        grammar = grammar_cache_load_grammar(&cache, grammar_arena);
+        if (!grammar || !cache_load_lr_table(&cache, grammar, &table)) {
+            grammar_cache_close(&cache);
+            cached = false;
+        }
     }
 
-    Grammar* grammar = result.value;
-    print_grammar(grammar);
-    // printf("---文法的非终结符---\n");
-    // for(int i = 0; i < grammar->nonterminals_count; i++){
-    //     printf("Nondermials[%d], %c\n", i, grammar->nonterminals[i]);
-    // }
-    // printf("---文法的终结符---\n");
-    // for(int i = 0; i < grammar->terminals_count; i++){
-    //     printf("Dermials[%d], %c\n", i, grammar->terminals[i]);
-    // }
-    // printf("---文法的产生式---\n");
-    // for (int i = 0; i < grammar->rule_count; i++) {
-    //     printf("Rule[%d]: %c -> %s\n", i, grammar->rules[i].left_hs, grammar->rules[i].right_hs);
-    // }
-    // 构建 DFA
-    DFA dfa;
-    build_viable_prefix_dfa(grammar, &dfa, dfa_arena);
-    print_dfa(&dfa);
+    DFA dfa = {0};
+    if (cached) {
+        printf("---分析结果来自缓存 %s---\n", CACHE_PATH);
+        print_grammar(grammar);
+    } else {
+        GrammarResultGrammar result =  read_grammar(filename, grammar_arena);
+        if (result.status != GRAMMAR_OK) {
+            fprintf(stderr, "Error: Failed to read grammar from file. Status code: %d\n", result.status);
+            arena_free(grammar_arena);
+            arena_free(dfa_arena);
+            return 1;
+        }
+        grammar = result.value;
+        if (reduce) {
+            GrammarReduction reduction;
+            if (grammar_reduce(grammar, &reduction).status != GRAMMAR_OK) {
+                arena_free(grammar_arena);
+                arena_free(dfa_arena);
+                return 1;
+            }
+            printf("---文法化简---\n");
+            print_grammar_reduction(grammar, &reduction);
+        }
+        print_grammar(grammar);
+        // 构建 DFA 与分析表
+        if (!build_table(method, grammar, &dfa, &table, dfa_arena) ||
+            (bypass_units && !eliminate_unit_reductions(grammar, NULL, &table, dfa_arena))) {
+            dfa_free(&dfa);
+            arena_free(grammar_arena);
+            arena_free(dfa_arena);
+            return 1;
+        }
+        print_dfa(&dfa);
+        if (bypass_units) printf("\n---绕过单产生式的归约，新增 %u 个状态---\n", table.state_count - dfa.state_count);
+        if (use_cache) save_analysis(key, grammar, &table, dfa_arena);
+    }
+
+    CompressedTable action, goto_table;
+    if (compress_lr_table(&table, &action, &goto_table, dfa_arena)) {
+        printf("\n=== %s Table ===\n", method_titles[method]);
+        print_lr_table(grammar, &table);
+        if (table.conflict_count) {
+            printf("文法不是 %s 的，共 %u 处冲突：\n", method_titles[method], table.conflict_count);
+            if (cached) print_lr_conflicts(grammar, &table);
+            else print_lr_conflict_items(&dfa, &table);
+        }
+        size_t dense = (size_t)table.state_count * (table.action_columns + table.goto_columns) * sizeof(int32_t);
+        printf("表大小：稠密 %zu 字节，压缩后 %zu 字节\n", dense,
+               compressed_table_bytes(&action) + compressed_table_bytes(&goto_table));
+    }
 
     grammar_free(grammar);
-    dfa_free(&dfa);
+    if (!cached) dfa_free(&dfa);
+    grammar_cache_close(&cache);
     arena_free(grammar_arena);
     arena_free(dfa_arena);
     return 0;
-}
\ No newline at end of file
+}
@@ -25,12 +25,14 @@ void* arena_alloc(Arena* arena, size_t size) {
         fprintf(stderr, "Invalid Arena\n");
         return NULL;
     }
-    if (arena->offset + size > arena->size) {
+    // 按 8 字节对齐，位集等 uint64_t 数据要求对齐
+    size_t offset = (arena->offset + 7) & ~(size_t)7;
+    if (offset + size > arena->size) {
         fprintf(stderr, "Arena out of memory\n");
         return NULL;
     }
-    void* ptr = arena->buffer + arena->offset;
-    arena->offset += size;
+    void* ptr = arena->buffer + offset;
+    arena->offset = offset + size;
     return ptr;
 }
 
@@ -6,27 +6,92 @@
 #include <string.h>
 #include <stdarg.h>  // 用于可变参数处理
 
+#define GRAMMAR_INITIAL_SYMBOLS 64
+#define GRAMMAR_INITIAL_RULES 128
+
 void grammar_free(Grammar* grammar) {
     if (!grammar) return;
     memset(grammar, 0, sizeof(Grammar));
 }
 
+/// 单字符且按字符本身就能判断出类别的符号直接写出，其余非终结符写成 <name>，终结符写成 'name'
+static bool symbol_is_bare(const Grammar* grammar, SymbolId symbol) {
+    const Symbol* s = &grammar->symbols[symbol];
+    if (s->length != 1) return false;
+    char c = s->name[0];
+    if (c == '#' || c == '|' || c == '<' || c == '\'' || c == '"' || isspace((unsigned char)c)) return false;
+    return s->terminal ? grammar_is_terminal(c) : grammar_is_nonterminal(c);
+}
+
+/// 右部相邻两个符号之间只有在有一方不是单字符写法时才需要空格，单字符文法的输出与原来一致
+static bool symbol_needs_separator(const Grammar* grammar, SymbolId prev, SymbolId next) {
+    return !symbol_is_bare(grammar, prev) || !symbol_is_bare(grammar, next);
+}
+
+/// 与 snprintf 相同：返回完整写出所需的长度，out 总以 '\0' 结尾
+size_t format_symbol(const Grammar* grammar, SymbolId symbol, char* out, size_t out_size) {
+    const Symbol* s = &grammar->symbols[symbol];
+    int n;
+    if (symbol_is_bare(grammar, symbol)) n = snprintf(out, out_size, "%s", s->name);
+    else if (s->terminal) n = snprintf(out, out_size, "'%s'", s->name);
+    else n = snprintf(out, out_size, "<%s>", s->name);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+size_t format_rule_rhs(const Grammar* grammar, const Rule* rule, char* out, size_t out_size) {
+    if (rule->right_hs_count == 0) return (size_t)snprintf(out, out_size, "#");
+    size_t len = 0;
+    if (out_size) out[0] = '\0';
+    for (uint32_t i = 0; i < rule->right_hs_count; ++i) {
+        if (i > 0 && symbol_needs_separator(grammar, rule->right_hs[i - 1], rule->right_hs[i])) {
+            if (len + 1 < out_size) { out[len] = ' '; out[len + 1] = '\0'; }
+            len++;
+        }
+        size_t room = len < out_size ? out_size - len : 0;
+        len += format_symbol(grammar, rule->right_hs[i], room ? out + len : NULL, room);
+    }
+    return len;
+}
+
+void fprint_symbol(FILE* out, const Grammar* grammar, SymbolId symbol) {
+    const Symbol* s = &grammar->symbols[symbol];
+    if (symbol_is_bare(grammar, symbol)) fprintf(out, "%s", s->name);
+    else if (s->terminal) fprintf(out, "'%s'", s->name);
+    else fprintf(out, "<%s>", s->name);
+}
+
+void fprint_rule_rhs(FILE* out, const Grammar* grammar, const Rule* rule) {
+    if (rule->right_hs_count == 0) {
+        fprintf(out, "#");
+        return;
+    }
+    for (uint32_t i = 0; i < rule->right_hs_count; ++i) {
+        if (i > 0 && symbol_needs_separator(grammar, rule->right_hs[i - 1], rule->right_hs[i])) fputc(' ', out);
+        fprint_symbol(out, grammar, rule->right_hs[i]);
+    }
+}
+
 void print_grammar(const Grammar* grammar) {
     printf("=== Grammar ===\n");
 
-    for (size_t i = 0; i < grammar->rule_count; ++i) {
+    for (uint32_t i = 0; i < grammar->rule_count; ++i) {
         const Rule* rule = &grammar->rules[i];
-        printf("%c -> %s\n", rule->left_hs, rule->right_hs);
+        fprint_symbol(stdout, grammar, rule->left_hs);
+        printf(" -> ");
+        fprint_rule_rhs(stdout, grammar, rule);
+        printf("\n");
     }
 
-    printf("\nNonterminals (%d): ", grammar->nonterminals_count);
-    for (uint8_t i = 0; i < grammar->nonterminals_count; ++i) {
-        printf("%c ", grammar->nonterminals[i]);
+    printf("\nNonterminals (%u): ", grammar->nonterminals_count);
+    for (uint32_t i = 0; i < grammar->nonterminals_count; ++i) {
+        fprint_symbol(stdout, grammar, grammar->nonterminals[i]);
+        printf(" ");
     }
 
-    printf("\nTerminals (%d): ", grammar->terminals_count);
-    for (uint8_t i = 0; i < grammar->terminals_count; ++i) {
-        printf("%c ", grammar->terminals[i]);
+    printf("\nTerminals (%u): ", grammar->terminals_count);
+    for (uint32_t i = 0; i < grammar->terminals_count; ++i) {
+        fprint_symbol(stdout, grammar, grammar->terminals[i]);
+        printf(" ");
     }
     printf("\n================\n");
 }
@@ -49,22 +114,119 @@ bool grammar_is_nonterminal(char c) {
     return isupper(c);
 }
 
-/// 将符号 c 添加到符号列表中，避免重复，超出上限时报错
-static GrammarResultVoid grammar_add_unique_symbol(char* list, uint8_t* count, char c) {
-    if (!list || !count) {
-        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
+/// FNV-1a 散列，末尾再混合一次：只取低位作槽号时，"tok_1"、"tok_2" 这类顺序名字不会挤在一起
+static uint32_t symbol_hash(const char* name, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+/// 返回名字在散列表中的槽位：命中时槽中为该符号，否则为应插入的空槽
+static uint32_t symbol_table_slot(const Grammar* grammar, const char* name, size_t length) {
+    uint32_t mask = grammar->symbol_table_capacity - 1;
+    uint32_t slot = symbol_hash(name, length) & mask;
+    for (;;) {
+        SymbolId id = grammar->symbol_table[slot];
+        if (id == GRAMMAR_NO_SYMBOL) return slot;
+        const Symbol* s = &grammar->symbols[id];
+        if (s->length == length && memcmp(s->name, name, length) == 0) return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+SymbolId grammar_lookup_symbol(const Grammar* grammar, const char* name, size_t length) {
+    if (!grammar || !name || grammar->symbol_table_capacity == 0) return GRAMMAR_NO_SYMBOL;
+    return grammar->symbol_table[symbol_table_slot(grammar, name, length)];
+}
+
+/// 符号数组、终结符/非终结符列表与散列表按倍增扩容，散列表装载率保持在 1/2 以下
+static GrammarResultVoid grammar_reserve_symbols(Grammar* grammar, uint32_t count) {
+    if (count > INT32_MAX / 2) {
+        grammar_report_error("Exceeded maximum number of symbols (%d).", INT32_MAX / 2);
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_TOO_MANY_SYMBOLS };
+    }
+    if (count > grammar->symbol_capacity) {
+        uint32_t capacity = grammar->symbol_capacity ? grammar->symbol_capacity * 2 : GRAMMAR_INITIAL_SYMBOLS;
+        while (capacity < count) capacity *= 2;
+        Symbol* symbols = arena_alloc(grammar->arena, capacity * sizeof(Symbol));
+        SymbolId* nonterminals = arena_alloc(grammar->arena, capacity * sizeof(SymbolId));
+        SymbolId* terminals = arena_alloc(grammar->arena, capacity * sizeof(SymbolId));
+        if (!symbols || !nonterminals || !terminals) {
+            grammar_report_error("Failed to allocate memory for symbols.");
+            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+        }
+        if (grammar->symbol_count) memcpy(symbols, grammar->symbols, grammar->symbol_count * sizeof(Symbol));
+        if (grammar->nonterminals_count) memcpy(nonterminals, grammar->nonterminals, grammar->nonterminals_count * sizeof(SymbolId));
+        if (grammar->terminals_count) memcpy(terminals, grammar->terminals, grammar->terminals_count * sizeof(SymbolId));
+        grammar->symbols = symbols;
+        grammar->nonterminals = nonterminals;
+        grammar->terminals = terminals;
+        grammar->symbol_capacity = capacity;
+    }
+    if (count * 2 > grammar->symbol_table_capacity) {
+        uint32_t capacity = grammar->symbol_table_capacity ? grammar->symbol_table_capacity : GRAMMAR_INITIAL_SYMBOLS * 2;
+        while (count * 2 > capacity) capacity *= 2;
+        SymbolId* table = arena_alloc(grammar->arena, capacity * sizeof(SymbolId));
+        if (!table) {
+            grammar_report_error("Failed to allocate memory for symbol table.");
+            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+        }
+        memset(table, 0xff, capacity * sizeof(SymbolId));
+        grammar->symbol_table = table;
+        grammar->symbol_table_capacity = capacity;
+        for (uint32_t i = 0; i < grammar->symbol_count; ++i) {
+            const Symbol* s = &grammar->symbols[i];
+            table[symbol_table_slot(grammar, s->name, s->length)] = (SymbolId)i;
+        }
+    }
+    return (GrammarResultVoid){ .status = GRAMMAR_OK };
+}
+
+/// 取得名字对应的符号编号，首次出现时登记为新符号；同一名字不能既是终结符又是非终结符
+GrammarResultSymbol grammar_intern_symbol(Grammar* grammar, const char* name, size_t length, bool terminal) {
+    if (!grammar || !name || length == 0) {
+        return (GrammarResultSymbol){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT, .value = GRAMMAR_NO_SYMBOL };
     }
-    for (uint8_t i = 0; i < *count; i++) {
-        if (list[i] == c) {
-            return  (GrammarResultVoid){ .status = GRAMMAR_OK };
-        }    
+    SymbolId existing = grammar_lookup_symbol(grammar, name, length);
+    if (existing != GRAMMAR_NO_SYMBOL) {
+        if (grammar->symbols[existing].terminal != terminal) {
+            grammar_report_error("Symbol '%.*s' used both as terminal and nonterminal.", (int)length, name);
+            return (GrammarResultSymbol){ .status = GRAMMAR_ERROR_SYMBOL_CONFLICT, .value = GRAMMAR_NO_SYMBOL };
+        }
+        return (GrammarResultSymbol){ .status = GRAMMAR_OK, .value = existing };
     }
-    if (*count >= GRAMMAR_MAX_SYMBOLS) {
-        grammar_report_error("Exceeded maximum number of symbols (%d).", GRAMMAR_MAX_SYMBOLS);
-        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_TOO_MANY_SYMBOLS }; 
+
+    GrammarResultVoid res = grammar_reserve_symbols(grammar, grammar->symbol_count + 1);
+    if (res.status != GRAMMAR_OK) return (GrammarResultSymbol){ .status = res.status, .value = GRAMMAR_NO_SYMBOL };
+    char* copy = arena_alloc(grammar->arena, length + 1);
+    if (!copy) {
+        grammar_report_error("Failed to allocate memory for symbol name.");
+        return (GrammarResultSymbol){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED, .value = GRAMMAR_NO_SYMBOL };
     }
-    list[(*count)++] = c; // 添加新符号
-    return (GrammarResultVoid){ .status = GRAMMAR_OK};
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+
+    SymbolId id = (SymbolId)grammar->symbol_count++;
+    Symbol* s = &grammar->symbols[id];
+    s->name = copy;
+    s->length = (uint32_t)length;
+    s->terminal = terminal;
+    if (terminal) {
+        s->index = (int32_t)grammar->terminals_count;
+        grammar->terminals[grammar->terminals_count++] = id;
+    } else {
+        s->index = (int32_t)grammar->nonterminals_count;
+        grammar->nonterminals[grammar->nonterminals_count++] = id;
+    }
+    grammar->symbol_table[symbol_table_slot(grammar, copy, length)] = id;
+    GRAMMAR_DEBUG("Interned %s: %s", terminal ? "terminal" : "nonterminal", copy);
+    return (GrammarResultSymbol){ .status = GRAMMAR_OK, .value = id };
 }
 
 /// 初始化 Grammar 结构体，包括规则数组的分配
@@ -77,181 +239,323 @@ static GrammarResultGrammar init_grammar(Arena* arena) {
         grammar_report_error("Failed to allocate memory for Grammar struct.");
         return (GrammarResultGrammar){. status = GRAMMAR_ERROR_ALLOCATION_FAILED};
     }
-    Rule* rules = arena_alloc(arena, GRAMMAR_MAX_RULES * sizeof(Rule));
+    memset(grammar, 0, sizeof(Grammar));
+    grammar->arena = arena;
+    grammar->start_symbol = GRAMMAR_NO_SYMBOL;
+
+    Rule* rules = arena_alloc(arena, GRAMMAR_INITIAL_RULES * sizeof(Rule));
     if (!rules) {
         grammar_report_error("Failed to allocate memory for rule struct.");
         return (GrammarResultGrammar){. status = GRAMMAR_ERROR_ALLOCATION_FAILED};
     }
     grammar->rules = rules;
-    grammar->rule_count = 0;
-    grammar->nonterminals_count = 0;
-    grammar->terminals_count = 0;
+    grammar->rule_capacity = GRAMMAR_INITIAL_RULES;
+    GrammarResultVoid res = grammar_reserve_symbols(grammar, GRAMMAR_INITIAL_SYMBOLS);
+    if (res.status != GRAMMAR_OK) return (GrammarResultGrammar){ .status = res.status };
 
     GRAMMAR_DEBUG("Grammar structure initialized.");
     return (GrammarResultGrammar){. status = GRAMMAR_OK,
                                   . value = grammar};
 }
 
-/// 去除字符串中的所有空白字符（就地修改）
-static void line_remove_spaces(char* str) {
-    char* dst = str;
-    for (char* src = str; *src != '\0'; src++) {
-        if (!isspace((unsigned char)*src)) {
-            *dst++ = *src;
+/// 追加一条产生式，右部直接引用 rhs 而不拷贝，rhs 须在文法的生存期内有效
+static GrammarResultVoid grammar_push_rule(Grammar* grammar, SymbolId l_hs, SymbolId* rhs, uint32_t count, Arena* arena) {
+    if (grammar->rule_count >= grammar->rule_capacity) {
+        if (grammar->rule_capacity > UINT32_MAX / 2) {
+            grammar_report_error("Exceeded maximum number of rules (%u).", grammar->rule_capacity);
+            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_TOO_MANY_RULES };
         }
-    }
-    *dst = '\0';
-}
-
-/// 收集产生式右部出现的所有符号并添加到文法中（终结符、非终结符）
-static GrammarResultVoid grammar_collect_rhs_symbols(char* rhs, Grammar* grammar) {
-    for (char* p = rhs; *p; ++p) {
-        GrammarResultVoid res;
-        if (*p == '#') {
-            res = grammar_add_unique_symbol(grammar->terminals, &grammar->terminals_count, '#');
-            if (res.status != GRAMMAR_OK) return res;
-            GRAMMAR_DEBUG("Collected terminal: #");
-        } else if (grammar_is_nonterminal(*p)) {
-            res = grammar_add_unique_symbol(grammar->nonterminals, &grammar->nonterminals_count, *p);
-            if (res.status != GRAMMAR_OK) return res;
-            GRAMMAR_DEBUG("Collected nonterminal: %c", *p);
-        } else if (grammar_is_terminal(*p)) {
-            res = grammar_add_unique_symbol(grammar->terminals, &grammar->terminals_count, *p);
-            if (res.status != GRAMMAR_OK) return res;
-            GRAMMAR_DEBUG("Collected terminal: %c", *p);
+        uint32_t capacity = grammar->rule_capacity * 2;
+        Rule* rules = arena_alloc(arena, capacity * sizeof(Rule));
+        if (!rules) {
+            grammar_report_error("Failed to allocate memory for Grammar rules.");
+            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
         }
+        memcpy(rules, grammar->rules, grammar->rule_count * sizeof(Rule));
+        grammar->rules = rules;
+        grammar->rule_capacity = capacity;
     }
+
+    Rule* rule = &grammar->rules[grammar->rule_count++];
+    rule->left_hs = l_hs;
+    rule->right_hs = rhs;
+    rule->right_hs_count = count;
     return (GrammarResultVoid){ .status = GRAMMAR_OK };
 }
 
-/// 解析右部多个产生式（用 | 分隔），为每个产生式构建规则结构体
-static GrammarResultVoid grammar_parse_rhs(Grammar* grammar, char l_hs, char* r_hs, Arena* arena) {
-    if (!grammar || !r_hs || !arena)
-        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
-
-    char* rhs_copy = arena_alloc(arena, strlen(r_hs) + 1);
-    if (!rhs_copy) {
-        grammar_report_error("Failed to allocate memory for RHS copy.");
+static GrammarResultVoid grammar_add_rule(Grammar* grammar, SymbolId l_hs, const SymbolId* rhs, uint32_t count, Arena* arena) {
+    SymbolId* copy = arena_alloc(arena, (count ? count : 1) * sizeof(SymbolId));
+    if (!copy) {
+        grammar_report_error("Failed to allocate memory for Grammar rules.");
         return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
     }
-    strcpy(rhs_copy, r_hs);
-
-    char* saveptr;
-    char* token = strtok_r(rhs_copy, "|\n", &saveptr);
-    while (token) {
-        while (isspace(*token)) token++;
-
-        if (grammar->rule_count >= GRAMMAR_MAX_RULES) {
-            grammar_report_error("Exceeded maximum number of rules (%d).", GRAMMAR_MAX_RULES);
-            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_TOO_MANY_RULES };
-        }
-
-        Rule* rule = &grammar->rules[grammar->rule_count++];
-        rule->left_hs = l_hs;
-
-        size_t token_len = strnlen(token, GRAMMAR_MAX_SYMBOLS);
-        rule->right_hs = arena_alloc(arena, token_len + 1);
-        rule->right_hs_count = token_len;
-        if (!rule->right_hs) {
-            grammar_report_error("Failed to allocate memory for Grammar rules.");
-            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
-        }
-
-        strncpy(rule->right_hs, token, token_len);
-        rule->right_hs[token_len] = '\0';
-        GRAMMAR_DEBUG("Added rule: %c -> %s", l_hs, rule->right_hs);
-
-        GrammarResultVoid sym_res = grammar_collect_rhs_symbols(token, grammar);
-        if (sym_res.status != GRAMMAR_OK) return sym_res;
+    if (count) memcpy(copy, rhs, count * sizeof(SymbolId));
+    return grammar_push_rule(grammar, l_hs, copy, count, arena);
+}
 
-        token = strtok_r(NULL, "|\n", &saveptr);
+/// 在文法末尾追加产生式 lhs -> rhs，符号须已登记；文法中还没有产生式时 lhs 成为开始符号
+GrammarResultVoid grammar_append_rule(Grammar* grammar, SymbolId lhs, const SymbolId* rhs, uint32_t count) {
+    if (!grammar || lhs < 0 || (uint32_t)lhs >= grammar->symbol_count || grammar_symbol_is_terminal(grammar, lhs) ||
+        (count && !rhs)) {
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (rhs[i] < 0 || (uint32_t)rhs[i] >= grammar->symbol_count)
+            return (GrammarResultVoid){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
     }
+    GrammarResultVoid res = grammar_add_rule(grammar, lhs, rhs, count, grammar->arena);
+    if (res.status == GRAMMAR_OK && grammar->start_symbol == GRAMMAR_NO_SYMBOL) grammar->start_symbol = lhs;
+    return res;
+}
 
+/// 删除第 index 条产生式：最后一条产生式移到 index 处，其余产生式的下标不变。符号与开始符号保持不变
+GrammarResultVoid grammar_remove_rule(Grammar* grammar, uint32_t index) {
+    if (!grammar || index >= grammar->rule_count)
+        return (GrammarResultVoid){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
+    grammar->rules[index] = grammar->rules[--grammar->rule_count];
     return (GrammarResultVoid){ .status = GRAMMAR_OK };
 }
 
-/// 提取 LHS 非终结符（必须是箭头左侧的第一个非空字符）
-static GrammarResultChar grammar_extract_lhs(const char* line) {
-    if (!line) return (GrammarResultChar){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
-
-    const char* arrow = strstr(line, "->");
-    if (!arrow || arrow == line) return (GrammarResultChar){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
-
-    size_t lhs_len = arrow - line;
-    if (lhs_len != 1) return (GrammarResultChar){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
-
-    char candidate = line[0];
-    if (!grammar_is_nonterminal(candidate)) {
-        return (GrammarResultChar){ .status = GRAMMAR_ERROR_INVALID_NONTERMINAL };
+#define GRAMMAR_RHS_CHUNK_MIN 256
+#define GRAMMAR_RHS_CHUNK_MAX 4096
+
+/// 整个文法文本上的扫描状态。文本不要求以 '\0' 结尾，行号与列号从 1 开始
+typedef struct GrammarLexer {
+    const char* source;      //出错信息中显示的名字
+    const char* p;
+    const char* end;
+    const char* line_start;
+    uint32_t line;
+    uint32_t error_line;     //第一个错误的位置，0 表示没有错误
+    uint32_t error_column;
+    Grammar* grammar;
+    SymbolId* chunk;         //右部编号直接写入按块分配的存储，产生式引用其中的一段
+    uint32_t chunk_used;
+    uint32_t chunk_capacity;
+} GrammarLexer;
+
+/// 以 "文件:行:列" 的形式报告 at 处的错误，并记下位置
+static void grammar_report_error_at(GrammarLexer* lex, const char* at, const char* format, ...) {
+    uint32_t column = (uint32_t)(at - lex->line_start) + 1;
+    if (lex->error_line == 0) {
+        lex->error_line = lex->line;
+        lex->error_column = column;
     }
-
-    return (GrammarResultChar){ .status = GRAMMAR_OK, .value = candidate };
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[Grammar Error] %s:%u:%u: ", lex->source, lex->line, column);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
 }
 
-// 提取 RHS：即 "->" 之后的部分（去除前导空格），返回状态码
-static GrammarResultString grammar_extract_rhs(const char* line) {
-    if (!line) return (GrammarResultString){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
-
-    const char* arrow = strstr(line, "->");
-    if (!arrow) return (GrammarResultString){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
-
-    arrow += 2;
-    while (isspace((unsigned char)*arrow)) arrow++;
-    if (*arrow == '\0') return (GrammarResultString){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
+/// 行内空白：换行单独处理，'\r' 视为空白，因此 "\r\n" 结尾的文件同样可读
+static inline bool lexer_is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-    return (GrammarResultString){ .status = GRAMMAR_OK, .value = (char*)arrow };
+static inline void lexer_skip_blanks(GrammarLexer* lex) {
+    while (lex->p < lex->end && lexer_is_blank(*lex->p)) lex->p++;
 }
 
-/// 处理文法文件中的一行，解析为规则并添加进文法
-static GrammarResultVoid grammar_process_line(char* line, Grammar* grammar, Arena* arena) {
-    line_remove_spaces(line);
-    if (line[0] == '\0') return (GrammarResultVoid){ .status = GRAMMAR_OK };
+static inline bool lexer_at_arrow(const GrammarLexer* lex) {
+    return lex->end - lex->p >= 2 && lex->p[0] == '-' && lex->p[1] == '>';
+}
 
-    GrammarResultChar lhs_res = grammar_extract_lhs(line);
-    if (lhs_res.status != GRAMMAR_OK) {
-        grammar_report_error("Invalid LHS in line: %s", line);
-        return (GrammarResultVoid){ .status = lhs_res.status };
+/// 词法意义上的一个符号：名字在原文中的位置与类别，尚未登记到文法
+typedef struct SymbolToken {
+    const char* name;
+    size_t length;
+    bool terminal;
+} SymbolToken;
+
+typedef struct GrammarResultToken {
+    GrammarStatus status;
+    SymbolToken value;
+} GrammarResultToken;
+
+/// 读出一个符号并前移：<name>、'name'、"name" 或单个字符。名字不能跨行，<name> 中不能有空白
+static GrammarResultToken grammar_scan_symbol(GrammarLexer* lex) {
+    const char* start = lex->p;
+    char c = *start;
+    if (c == '<' || c == '\'' || c == '"') {
+        char close = (c == '<') ? '>' : c;
+        const char* q = start + 1;
+        while (q < lex->end && *q != close && *q != '\n') {
+            if (c == '<' && lexer_is_blank(*q)) {
+                grammar_report_error_at(lex, q, "Whitespace in nonterminal name.");
+                return (GrammarResultToken){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
+            }
+            q++;
+        }
+        if (q == lex->end || *q != close) {
+            grammar_report_error_at(lex, start, "Unterminated symbol name, expected '%c'.", close);
+            return (GrammarResultToken){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
+        }
+        if (q == start + 1) {
+            grammar_report_error_at(lex, start, "Empty symbol name.");
+            return (GrammarResultToken){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
+        }
+        lex->p = q + 1;
+        return (GrammarResultToken){ .status = GRAMMAR_OK, .value = { start + 1, (size_t)(q - start - 1), c != '<' } };
+    }
+    if ((unsigned char)c < 0x20 || c == 0x7f) {
+        grammar_report_error_at(lex, start, "Unexpected control character 0x%02x.", (unsigned char)c);
+        return (GrammarResultToken){ .status = GRAMMAR_ERROR_INVALID_FORMAT };
     }
-    GrammarResultVoid add_res = grammar_add_unique_symbol(grammar->nonterminals, &grammar->nonterminals_count, lhs_res.value);
-    if (add_res.status != GRAMMAR_OK) return add_res;
+    lex->p = start + 1;
+    return (GrammarResultToken){ .status = GRAMMAR_OK, .value = { start, 1, !grammar_is_nonterminal(c) } };
+}
 
-    GrammarResultString rhs_res = grammar_extract_rhs(line);
-    if (rhs_res.status != GRAMMAR_OK) {
-        grammar_report_error("Invalid RHS in line: %s", line);
-        return (GrammarResultVoid){ .status = rhs_res.status };
+/// 当前候选式已写入 count 个编号，保证还能再写一个；块用完时把这一段移到新块的开头。
+/// 块从小到大倍增，小文法不会占用多少 arena
+static bool lexer_reserve_rhs(GrammarLexer* lex, uint32_t count) {
+    if (lex->chunk_used + count < lex->chunk_capacity) return true;
+    uint32_t capacity = lex->chunk_capacity ? lex->chunk_capacity * 2 : GRAMMAR_RHS_CHUNK_MIN;
+    if (capacity > GRAMMAR_RHS_CHUNK_MAX) capacity = GRAMMAR_RHS_CHUNK_MAX;
+    while (capacity <= count * 2) capacity *= 2;
+    SymbolId* chunk = arena_alloc(lex->grammar->arena, capacity * sizeof(SymbolId));
+    if (!chunk) {
+        grammar_report_error("Failed to allocate memory for rule bodies.");
+        return false;
     }
+    if (count) memcpy(chunk, lex->chunk + lex->chunk_used, count * sizeof(SymbolId));
+    lex->chunk = chunk;
+    lex->chunk_used = 0;
+    lex->chunk_capacity = capacity;
+    return true;
+}
 
-    GrammarResultVoid parse_res = grammar_parse_rhs(grammar, lhs_res.value, rhs_res.value, arena);
-    if (parse_res.status != GRAMMAR_OK) return parse_res;
+/// 解析 "->" 之后直到行尾的右部：候选式用 | 分隔，'#' 表示空串、不进入右部。
+/// 与旧格式一致，完全为空的候选式（如 "a||b"）被跳过，空产生式须显式写 '#'
+static GrammarStatus grammar_parse_rhs(GrammarLexer* lex, SymbolId l_hs) {
+    Grammar* grammar = lex->grammar;
+    lexer_skip_blanks(lex);
+    if (lex->p == lex->end || *lex->p == '\n') {
+        grammar_report_error_at(lex, lex->p, "Missing right-hand side after '->'.");
+        return GRAMMAR_ERROR_INVALID_FORMAT;
+    }
+    for (;;) {
+        uint32_t count = 0;
+        bool present = false;
+        while (lex->p < lex->end && *lex->p != '\n' && *lex->p != '|') {
+            if (lexer_is_blank(*lex->p)) {
+                lex->p++;
+                continue;
+            }
+            present = true;
+            if (*lex->p == '#') {
+                lex->p++;
+                continue;
+            }
+            GrammarResultToken tok = grammar_scan_symbol(lex);
+            if (tok.status != GRAMMAR_OK) return tok.status;
+            GrammarResultSymbol sym = grammar_intern_symbol(grammar, tok.value.name, tok.value.length, tok.value.terminal);
+            if (sym.status != GRAMMAR_OK) {
+                grammar_report_error_at(lex, tok.value.name, "Invalid symbol '%.*s'.", (int)tok.value.length, tok.value.name);
+                return sym.status;
+            }
+            if (!lexer_reserve_rhs(lex, count)) return GRAMMAR_ERROR_ALLOCATION_FAILED;
+            lex->chunk[lex->chunk_used + count++] = sym.value;
+        }
+        if (present) {
+            GrammarResultVoid res = grammar_push_rule(grammar, l_hs, lex->chunk + lex->chunk_used, count, grammar->arena);
+            if (res.status != GRAMMAR_OK) return res.status;
+            lex->chunk_used += count;
+        }
+        if (lex->p == lex->end || *lex->p != '|') break;
+        lex->p++;
+    }
+    return GRAMMAR_OK;
+}
 
-    GRAMMAR_DEBUG("Processed line successfully: %s", line);
-    return (GrammarResultVoid){ .status = GRAMMAR_OK };
+/// 解析一条 "LHS -> RHS" 定义，左部恰好是一个非终结符。返回时 lex->p 停在行尾
+static GrammarStatus grammar_parse_definition(GrammarLexer* lex) {
+    Grammar* grammar = lex->grammar;
+    const char* at = lex->p;
+    if (lexer_at_arrow(lex)) {
+        grammar_report_error_at(lex, at, "Missing left-hand side before '->'.");
+        return GRAMMAR_ERROR_INVALID_FORMAT;
+    }
+    GrammarResultToken tok = grammar_scan_symbol(lex);
+    if (tok.status != GRAMMAR_OK) return tok.status;
+    lexer_skip_blanks(lex);
+    if (!lexer_at_arrow(lex)) {
+        grammar_report_error_at(lex, lex->p, "Expected '->' after the left-hand side.");
+        return GRAMMAR_ERROR_INVALID_FORMAT;
+    }
+    if (tok.value.terminal) {
+        grammar_report_error_at(lex, at, "Left-hand side '%.*s' is not a nonterminal.", (int)tok.value.length, tok.value.name);
+        return GRAMMAR_ERROR_INVALID_NONTERMINAL;
+    }
+    GrammarResultSymbol lhs = grammar_intern_symbol(grammar, tok.value.name, tok.value.length, false);
+    if (lhs.status != GRAMMAR_OK) {
+        grammar_report_error_at(lex, at, "Invalid left-hand side '%.*s'.", (int)tok.value.length, tok.value.name);
+        return lhs.status;
+    }
+    if (grammar->start_symbol == GRAMMAR_NO_SYMBOL) grammar->start_symbol = lhs.value;
+    lex->p += 2;
+    return grammar_parse_rhs(lex, lhs.value);
 }
 
-/// 从文件读取文法定义，解析并构建 Grammar 结构
-GrammarResultGrammar read_grammar(const char* filename, Arena* arena) {
-    GRAMMAR_DEBUG("Reading grammar from file: %s", filename);
+/// 一遍扫描整段文法文本：每行一条定义，空行和只有空白的行被跳过，行长不受限制
+GrammarResultGrammar parse_grammar(const char* text, size_t length, const char* source, Arena* arena) {
     GrammarResultGrammar init_res = init_grammar(arena);
     if (init_res.status != GRAMMAR_OK) return init_res;
+    if (!text && length) return (GrammarResultGrammar){ .status = GRAMMAR_ERROR_INVALID_ARGUMENT };
+
+    GrammarLexer lex = { .source = source ? source : "<input>", .p = text, .end = text + length,
+                         .line_start = text, .line = 1, .grammar = init_res.value };
+    while (lex.p < lex.end) {
+        lexer_skip_blanks(&lex);
+        if (lex.p < lex.end && *lex.p != '\n') {
+            GrammarStatus status = grammar_parse_definition(&lex);
+            if (status != GRAMMAR_OK) {
+                return (GrammarResultGrammar){ .status = status, .line = lex.error_line, .column = lex.error_column };
+            }
+        }
+        if (lex.p < lex.end) {
+            lex.p++;
+            lex.line_start = lex.p;
+            lex.line++;
+        }
+    }
+    GRAMMAR_DEBUG("Parsed %u lines, %u rules.", lex.line, init_res.value->rule_count);
+    return init_res;
+}
 
-    Grammar* grammar = init_res.value;
-    FILE* file = fopen(filename, "r");
+/// 从文件读取文法定义：整个文件一次读入临时缓冲，解析完即释放（符号名已拷入 arena）
+GrammarResultGrammar read_grammar(const char* filename, Arena* arena) {
+    GRAMMAR_DEBUG("Reading grammar from file: %s", filename);
+    FILE* file = fopen(filename, "rb");
     if (!file) {
         grammar_report_error("Failed to open the file.");
         return (GrammarResultGrammar){ .status = GRAMMAR_ERROR_IO_FAILED };
     }
-
-    char line[GRAMMAR_MAX_LINE_LEN];
-    while (fgets(line, sizeof(line), file)) {
-        line[strcspn(line, "\r\n")] = '\0';
-        GrammarResultVoid line_res = grammar_process_line(line, grammar, arena);
-        if (line_res.status != GRAMMAR_OK) {
-            fclose(file);
-            return (GrammarResultGrammar){ .status = line_res.status };
-        }
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        grammar_report_error("Failed to determine the size of %s.", filename);
+        fclose(file);
+        return (GrammarResultGrammar){ .status = GRAMMAR_ERROR_IO_FAILED };
     }
-
+    char* text = malloc((size_t)size + 1);
+    if (!text) {
+        grammar_report_error("Failed to allocate memory for the grammar text.");
+        fclose(file);
+        return (GrammarResultGrammar){ .status = GRAMMAR_ERROR_ALLOCATION_FAILED };
+    }
+    size_t length = fread(text, 1, (size_t)size, file);
+    bool failed = ferror(file);
     fclose(file);
+    if (failed) {
+        grammar_report_error("Failed to read %s.", filename);
+        free(text);
+        return (GrammarResultGrammar){ .status = GRAMMAR_ERROR_IO_FAILED };
+    }
+
+    GrammarResultGrammar res = parse_grammar(text, length, filename, arena);
+    free(text);
     GRAMMAR_DEBUG("Finished reading grammar file.");
-    return (GrammarResultGrammar){ .status = GRAMMAR_OK, .value = grammar };
+    return res;
 }
@@ -0,0 +1,259 @@
+#include "lalr_table.h"
+#include "../../ll1/src/digraph.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 关系的边表，按需倍增，最后交给 digraph_build 转成 CSR
+typedef struct EdgeList{
+    int* from;
+    int* to;
+    int count;
+    int capacity;
+} EdgeList;
+
+static bool edge_push(EdgeList* edges, int from, int to, Arena* arena){
+    if(edges->count >= edges->capacity){
+        int capacity = edges->capacity ? edges->capacity * 2 : 256;
+        int* new_from = arena_alloc(arena, (size_t)capacity * sizeof(int));
+        int* new_to = arena_alloc(arena, (size_t)capacity * sizeof(int));
+        if(!new_from || !new_to){
+            fprintf(stderr, "Error: Failed to allocate memory for LALR relation.\n");
+            return false;
+        }
+        if(edges->count){
+            memcpy(new_from, edges->from, (size_t)edges->count * sizeof(int));
+            memcpy(new_to, edges->to, (size_t)edges->count * sizeof(int));
+        }
+        edges->from = new_from;
+        edges->to = new_to;
+        edges->capacity = capacity;
+    }
+    edges->from[edges->count] = from;
+    edges->to[edges->count++] = to;
+    return true;
+}
+
+typedef struct LalrContext{
+    const DFA* dfa;
+    const Grammar* grammar;
+    const SymbolSet* sets;
+    Arena* arena;
+    int* transition_of;         //state * nonterminals_count + A -> 非终结符转移编号，-1 表示无
+    int transition_count;
+    uint32_t* transition_state; //转移 (p, A) 的 p
+    uint32_t* transition_lhs;   //转移 (p, A) 的 A（非终结符编号）
+    uint64_t** follow;          //先存 DR，再依次变为 Read 与 Follow
+    size_t words;
+} LalrContext;
+
+static inline int transition_id(const LalrContext* ctx, uint32_t state, uint32_t nonterminal){
+    return ctx->transition_of[(size_t)state * ctx->grammar->nonterminals_count + nonterminal];
+}
+
+static inline bool symbol_nullable(const LalrContext* ctx, SymbolId symbol){
+    return !grammar_symbol_is_terminal(ctx->grammar, symbol) && ctx->sets[grammar_nonterminal_id(ctx->grammar, symbol)].nullable;
+}
+
+/// 给全部非终结符转移编号，并为每个转移分配集合，填入 DR
+static bool number_transitions(LalrContext* ctx){
+    const DFA* dfa = ctx->dfa;
+    const Grammar* grammar = ctx->grammar;
+    Arena* arena = ctx->arena;
+    size_t cells = (size_t)dfa->state_count * grammar->nonterminals_count;
+    int count = 0;
+    for(uint32_t t = 0; t < dfa->transition_count; t++){
+        if(!grammar_symbol_is_terminal(grammar, dfa->transitions[t].symbol)) count++;
+    }
+    ctx->transition_of = arena_alloc(arena, (cells ? cells : 1) * sizeof(int));
+    ctx->transition_state = arena_alloc(arena, (count + 1) * sizeof(uint32_t));
+    ctx->transition_lhs = arena_alloc(arena, (count + 1) * sizeof(uint32_t));
+    ctx->follow = arena_alloc(arena, (count + 1) * sizeof(uint64_t*));
+    uint64_t* storage = arena_alloc(arena, ((size_t)count * ctx->words + 1) * sizeof(uint64_t));
+    if(!ctx->transition_of || !ctx->transition_state || !ctx->transition_lhs || !ctx->follow || !storage){
+        fprintf(stderr, "Error: Failed to allocate memory for LALR lookaheads.\n");
+        return false;
+    }
+    memset(ctx->transition_of, 0xff, cells * sizeof(int));
+    memset(storage, 0, (size_t)count * ctx->words * sizeof(uint64_t));
+
+    int x = 0;
+    for(uint32_t p = 0; p < dfa->state_count; p++){
+        uint32_t degree;
+        const Transition* edges = dfa_transitions(dfa, p, &degree);
+        for(uint32_t k = 0; k < degree; k++){
+            if(grammar_symbol_is_terminal(grammar, edges[k].symbol)) continue;
+            uint32_t a = (uint32_t)grammar_nonterminal_id(grammar, edges[k].symbol);
+            ctx->transition_of[(size_t)p * grammar->nonterminals_count + a] = x;
+            ctx->transition_state[x] = p;
+            ctx->transition_lhs[x] = a;
+            ctx->follow[x] = storage + (size_t)x * ctx->words;
+
+            // DR(p, A)：A 之后的状态上可以直接移进的终结符
+            uint32_t r_degree;
+            const Transition* r_edges = dfa_transitions(dfa, edges[k].to_state, &r_degree);
+            for(uint32_t j = 0; j < r_degree; j++){
+                if(grammar_symbol_is_terminal(grammar, r_edges[j].symbol))
+                    bitset_add(ctx->follow[x], grammar_terminal_id(grammar, r_edges[j].symbol));
+            }
+            x++;
+        }
+    }
+    ctx->transition_count = count;
+
+    // rules[0] 为增广产生式 S' -> α，α 之后是输入结束：从状态 0 沿 α 走，之后部分可空的非终结符转移的 DR 含 '$'
+    const Rule* start = &grammar->rules[0];
+    uint32_t state = 0;
+    for(uint32_t j = 0; j < start->right_hs_count; j++){
+        SymbolId symbol = start->right_hs[j];
+        if(!grammar_symbol_is_terminal(grammar, symbol)){
+            bool tail_nullable = true;
+            for(uint32_t t = j + 1; t < start->right_hs_count && tail_nullable; t++) tail_nullable = symbol_nullable(ctx, start->right_hs[t]);
+            if(tail_nullable) bitset_add(ctx->follow[transition_id(ctx, state, (uint32_t)grammar_nonterminal_id(grammar, symbol))], grammar_end_marker_id(grammar));
+        }
+        state = (uint32_t)dfa_goto(dfa, state, symbol);
+    }
+    return true;
+}
+
+/// Read = DR 沿 reads 关系传播
+static bool compute_read_sets(LalrContext* ctx){
+    const DFA* dfa = ctx->dfa;
+    const Grammar* grammar = ctx->grammar;
+    EdgeList reads = {0};
+    for(int x = 0; x < ctx->transition_count; x++){
+        int32_t r = dfa_goto(dfa, ctx->transition_state[x], grammar->nonterminals[ctx->transition_lhs[x]]);
+        uint32_t degree;
+        const Transition* edges = dfa_transitions(dfa, (uint32_t)r, &degree);
+        for(uint32_t k = 0; k < degree; k++){
+            if(!symbol_nullable(ctx, edges[k].symbol)) continue;
+            int y = transition_id(ctx, (uint32_t)r, (uint32_t)grammar_nonterminal_id(grammar, edges[k].symbol));
+            if(!edge_push(&reads, x, y, ctx->arena)) return false;
+        }
+    }
+    Digraph relation;
+    return digraph_build(&relation, ctx->transition_count, reads.from, reads.to, reads.count, ctx->arena) &&
+           digraph_solve(&relation, ctx->follow, ctx->words, ctx->arena);
+}
+
+/// Follow = Read 沿 includes 关系传播。对每个转移 (p, A) 与 A 的每条产生式，从 p 出发沿右部走一遍：
+/// 途经的 (p_j, B) 在 B 之后的部分可空时 includes (p, A)
+static bool compute_follow_sets_lalr(LalrContext* ctx, const uint32_t* rule_start, const uint32_t* rule_by_lhs){
+    const DFA* dfa = ctx->dfa;
+    const Grammar* grammar = ctx->grammar;
+    EdgeList includes = {0};
+    for(int x = 0; x < ctx->transition_count; x++){
+        uint32_t p = ctx->transition_state[x];
+        for(uint32_t k = rule_start[ctx->transition_lhs[x]]; k < rule_start[ctx->transition_lhs[x] + 1]; k++){
+            const Rule* rule = &grammar->rules[rule_by_lhs[k]];
+            uint32_t state = p;
+            for(uint32_t j = 0; j < rule->right_hs_count; j++){
+                SymbolId symbol = rule->right_hs[j];
+                if(!grammar_symbol_is_terminal(grammar, symbol)){
+                    bool tail_nullable = true;
+                    for(uint32_t t = j + 1; t < rule->right_hs_count && tail_nullable; t++) tail_nullable = symbol_nullable(ctx, rule->right_hs[t]);
+                    if(tail_nullable){
+                        int y = transition_id(ctx, state, (uint32_t)grammar_nonterminal_id(grammar, symbol));
+                        if(y != x && !edge_push(&includes, y, x, ctx->arena)) return false;
+                    }
+                }
+                state = (uint32_t)dfa_goto(dfa, state, symbol);
+            }
+        }
+    }
+    Digraph relation;
+    return digraph_build(&relation, ctx->transition_count, includes.from, includes.to, includes.count, ctx->arena) &&
+           digraph_solve(&relation, ctx->follow, ctx->words, ctx->arena);
+}
+
+bool build_lalr1_table(const DFA* dfa, const SymbolSet* sets, LRTable* table, Arena* arena){
+    if(!lr_table_init(dfa, table, arena)) return false;
+    const Grammar* grammar = dfa->grammar;
+    LalrContext ctx = {
+        .dfa = dfa,
+        .grammar = grammar,
+        .sets = sets,
+        .arena = arena,
+        .words = symbol_set_words(grammar)
+    };
+
+    // 按左部分组产生式（CSR），lookback 与 includes 都要按非终结符找它的产生式
+    uint32_t n = grammar->nonterminals_count;
+    uint32_t* rule_start = arena_alloc(arena, (n + 2) * sizeof(uint32_t));
+    uint32_t* rule_by_lhs = arena_alloc(arena, (grammar->rule_count + 1) * sizeof(uint32_t));
+    if(!rule_start || !rule_by_lhs){
+        fprintf(stderr, "Error: Failed to allocate memory for LALR lookaheads.\n");
+        return false;
+    }
+    memset(rule_start, 0, (n + 2) * sizeof(uint32_t));
+    for(uint32_t r = 0; r < grammar->rule_count; r++) rule_start[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs) + 2]++;
+    for(uint32_t a = 0; a < n; a++) rule_start[a + 2] += rule_start[a + 1];
+    for(uint32_t r = 0; r < grammar->rule_count; r++) rule_by_lhs[rule_start[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs) + 1]++] = r;
+
+    if(!number_transitions(&ctx) || !compute_read_sets(&ctx) || !compute_follow_sets_lalr(&ctx, rule_start, rule_by_lhs)) return false;
+
+    // rules[0] 完成时接受
+    uint32_t state = 0;
+    for(uint32_t j = 0; j < grammar->rules[0].right_hs_count; j++) state = (uint32_t)dfa_goto(dfa, state, grammar->rules[0].right_hs[j]);
+    if(!lr_table_set_action(table, state, grammar_end_marker_id(grammar), lr_accept(), arena)) return false;
+
+    // 给每个状态中的完成项（rules[0] 除外）编号：状态 q 的完成项为 reduction_rule[reduction_start[q] .. reduction_start[q + 1])
+    uint32_t* reduction_start = arena_alloc(arena, (dfa->state_count + 1) * sizeof(uint32_t));
+    if(!reduction_start){
+        fprintf(stderr, "Error: Failed to allocate memory for LALR lookaheads.\n");
+        return false;
+    }
+    ItemSet set = {0};
+    uint32_t reduction_count = 0;
+    for(uint32_t q = 0; q < dfa->state_count; q++){
+        reduction_start[q] = reduction_count;
+        dfa_state_closure(dfa, q, &set);
+        for(uint32_t i = 0; i < set.item_count; i++){
+            if(dfa_item_next(dfa, set.items[i]) == LR_ITEM_END && dfa_item_rule(dfa, set.items[i]) != 0) reduction_count++;
+        }
+    }
+    reduction_start[dfa->state_count] = reduction_count;
+    uint32_t* reduction_rule = arena_alloc(arena, (reduction_count + 1) * sizeof(uint32_t));
+    uint64_t* lookahead = arena_alloc(arena, ((size_t)reduction_count * ctx.words + 1) * sizeof(uint64_t));
+    if(!reduction_rule || !lookahead){
+        fprintf(stderr, "Error: Failed to allocate memory for LALR lookaheads.\n");
+        return false;
+    }
+    memset(lookahead, 0, (size_t)reduction_count * ctx.words * sizeof(uint64_t));
+    for(uint32_t q = 0, id = 0; q < dfa->state_count; q++){
+        dfa_state_closure(dfa, q, &set);
+        for(uint32_t i = 0; i < set.item_count; i++){
+            uint32_t rule = dfa_item_rule(dfa, set.items[i]);
+            if(dfa_item_next(dfa, set.items[i]) == LR_ITEM_END && rule != 0) reduction_rule[id++] = rule;
+        }
+    }
+
+    // lookback：从 p 沿 A -> ω 走到 q，LA(q, A -> ω) 并入 Follow(p, A)。同一个 (q, A -> ω) 可能由多个 p 到达，
+    // 先把向前看集合并完再填表，每格只写一次
+    for(int x = 0; x < ctx.transition_count; x++){
+        uint32_t a = ctx.transition_lhs[x];
+        for(uint32_t k = rule_start[a]; k < rule_start[a + 1]; k++){
+            uint32_t r = rule_by_lhs[k];
+            const Rule* rule = &grammar->rules[r];
+            uint32_t q = ctx.transition_state[x];
+            for(uint32_t j = 0; j < rule->right_hs_count; j++) q = (uint32_t)dfa_goto(dfa, q, rule->right_hs[j]);
+            uint32_t id = reduction_start[q];
+            while(reduction_rule[id] != r) id++;
+            bitset_union(lookahead + (size_t)id * ctx.words, ctx.follow[x], ctx.words);
+        }
+    }
+
+    for(uint32_t q = 0; q < dfa->state_count; q++){
+        for(uint32_t id = reduction_start[q]; id < reduction_start[q + 1]; id++){
+            const uint64_t* la = lookahead + (size_t)id * ctx.words;
+            for(size_t w = 0; w < ctx.words; w++){
+                for(uint64_t bits = la[w]; bits; bits &= bits - 1){
+                    uint32_t column = (uint32_t)(w * SYMBOL_SET_WORD_BITS + __builtin_ctzll(bits));
+                    if(!lr_table_set_action(table, q, column, lr_reduce(reduction_rule[id]), arena)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef LALR_TABLE_H
+#define LALR_TABLE_H
+
+#include "arena.h"
+#include "../../ll1/src/first_follow.h"
+#include "lr_table.h"
+#include "viable_prefix_dfa.h"
+#include <stdbool.h>
+
+// LALR(1) 分析表：在 LR(0) 自动机上用 DeRemer–Pennello 算法求向前看集合。
+// 结点为非终结符转移 (p, A)：
+//   DR(p, A)   = { t | goto(goto(p, A), t) 有定义 }
+//   (p, A) reads (r, C)      当 p --A--> r --C--> 且 C 可空
+//   (p, B) includes (p', A)  当 A -> βBγ，γ 可空且 p' --β--> p
+//   (q, A -> ω) lookback (p, A) 当 p --ω--> q
+// Read 与 Follow 各用一次 digraph 沿强连通分量传播，LA(q, A -> ω) 为 lookback 到的各 Follow 之并。
+// sets 只用到 nullable（compute_first_sets 的结果）。与 LR(0) 表相同，rules[0] 视为增广产生式，完成时在 '$' 上接受
+bool build_lalr1_table(const DFA* dfa, const SymbolSet* sets, LRTable* table, Arena* arena);
+
+#endif
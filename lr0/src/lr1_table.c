@@ -0,0 +1,416 @@
+#include "lr1_table.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+static void* lr1_alloc(Arena* arena, size_t size){
+    void* ptr = arena_alloc(arena, size ? size : 1);
+    if(!ptr) fprintf(stderr, "Error: Failed to allocate memory for LR(1) automaton.\n");
+    return ptr;
+}
+
+// 构造与填表共用的预计算与临时区
+typedef struct LR1Context{
+    const Grammar* grammar;
+    const DFA* dfa;
+    const SymbolSet* sets;
+    Arena* arena;
+    size_t words;
+    uint64_t* first;            //项目 i 对应 First(右部从点开始的部分)，每项 words 个字
+    bool* nullable;             //右部从点开始的部分能否推出空串
+    uint32_t* rule_start;       //按左部分组的产生式（CSR）
+    uint32_t* rule_by_lhs;
+    uint64_t* closure_la;       //非终结符 B 的闭包项 B -> .γ 共用的向前看集合，每行 words 个字
+    uint32_t* touched;          //本次用过的 closure_la 行，用完清零
+    uint32_t touched_count;
+    uint32_t* pending;          //向前看集合有增长、待传给左角的非终结符
+    bool* marks;                //[0, n) 标记 touched，[n, 2n) 标记 pending
+} LR1Context;
+
+static bool lr1_context_init(LR1Context* ctx, const DFA* dfa, const SymbolSet* sets, Arena* arena){
+    const Grammar* grammar = dfa->grammar;
+    const LRItemSpace* space = &dfa->items;
+    uint32_t n = grammar->nonterminals_count;
+    memset(ctx, 0, sizeof(LR1Context));
+    ctx->grammar = grammar;
+    ctx->dfa = dfa;
+    ctx->sets = sets;
+    ctx->arena = arena;
+    ctx->words = symbol_set_words(grammar);
+    ctx->first = lr1_alloc(arena, ((size_t)space->item_count + 1) * ctx->words * sizeof(uint64_t));
+    ctx->nullable = lr1_alloc(arena, ((size_t)space->item_count + 1) * sizeof(bool));
+    ctx->rule_start = lr1_alloc(arena, (n + 2) * sizeof(uint32_t));
+    ctx->rule_by_lhs = lr1_alloc(arena, grammar->rule_count * sizeof(uint32_t));
+    ctx->closure_la = lr1_alloc(arena, (size_t)n * ctx->words * sizeof(uint64_t));
+    ctx->touched = lr1_alloc(arena, n * sizeof(uint32_t));
+    ctx->pending = lr1_alloc(arena, n * sizeof(uint32_t));
+    ctx->marks = lr1_alloc(arena, 2 * n * sizeof(bool));
+    if(!ctx->first || !ctx->nullable || !ctx->rule_start || !ctx->rule_by_lhs ||
+       !ctx->closure_la || !ctx->touched || !ctx->pending || !ctx->marks) return false;
+    memset(ctx->first, 0, ((size_t)space->item_count + 1) * ctx->words * sizeof(uint64_t));
+    memset(ctx->closure_la, 0, (size_t)n * ctx->words * sizeof(uint64_t));
+    memset(ctx->marks, 0, 2 * n * sizeof(bool));
+
+    // 从右往左：First(X β) = First(X) ∪ (X 可空时 First(β))
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        LRItem base = space->rule_base[r];
+        ctx->nullable[base + rule->right_hs_count] = true;
+        for(uint32_t dot = rule->right_hs_count; dot-- > 0;){
+            uint64_t* row = ctx->first + (size_t)(base + dot) * ctx->words;
+            SymbolId symbol = rule->right_hs[dot];
+            if(grammar_symbol_is_terminal(grammar, symbol)){
+                bitset_add(row, grammar_terminal_id(grammar, symbol));
+                ctx->nullable[base + dot] = false;
+                continue;
+            }
+            const SymbolSet* set = &sets[grammar_nonterminal_id(grammar, symbol)];
+            bitset_union(row, set->first, ctx->words);
+            ctx->nullable[base + dot] = set->nullable && ctx->nullable[base + dot + 1];
+            if(set->nullable) bitset_union(row, row + ctx->words, ctx->words);
+        }
+    }
+
+    memset(ctx->rule_start, 0, (n + 2) * sizeof(uint32_t));
+    for(uint32_t r = 0; r < grammar->rule_count; r++) ctx->rule_start[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs) + 2]++;
+    for(uint32_t a = 0; a < n; a++) ctx->rule_start[a + 2] += ctx->rule_start[a + 1];
+    for(uint32_t r = 0; r < grammar->rule_count; r++) ctx->rule_by_lhs[ctx->rule_start[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs) + 1]++] = r;
+    return true;
+}
+
+static inline uint64_t* closure_row(LR1Context* ctx, uint32_t nonterminal){
+    return ctx->closure_la + (size_t)nonterminal * ctx->words;
+}
+
+// 项 A -> α.Bβ [L] 传给 B 的向前看：First(β) ∪ (β 可空时 L)。β 从项目 item + 1 的点位置开始。
+// closure_la[b] 有增长且 b 不在 pending 中时把 b 加入 pending
+static void add_closure_lookahead(LR1Context* ctx, uint32_t b, LRItem item, const uint64_t* la, uint32_t* top){
+    uint32_t n = ctx->grammar->nonterminals_count;
+    uint64_t* row = closure_row(ctx, b);
+    if(!ctx->marks[b]){
+        ctx->marks[b] = true;
+        ctx->touched[ctx->touched_count++] = b;
+    }
+    bool changed = bitset_union(row, ctx->first + (size_t)(item + 1) * ctx->words, ctx->words);
+    if(ctx->nullable[item + 1]) changed |= bitset_union(row, la, ctx->words);
+    if(changed && !ctx->marks[n + b]){
+        ctx->marks[n + b] = true;
+        ctx->pending[(*top)++] = b;
+    }
+}
+
+/// 求状态闭包中各非终结符 B 的项 B -> .γ 共用的向前看集合，结果留在 closure_la 中。
+/// 核心项的向前看先传给点后的非终结符，再沿左角 B -> Cδ 传给 C，直到不再增长
+static void compute_closure_lookaheads(LR1Context* ctx, const DFAState* state, const uint64_t* kernel_la){
+    const Grammar* grammar = ctx->grammar;
+    const LRItemSpace* space = &ctx->dfa->items;
+    uint32_t n = grammar->nonterminals_count;
+    for(uint32_t i = 0; i < ctx->touched_count; i++){
+        memset(closure_row(ctx, ctx->touched[i]), 0, ctx->words * sizeof(uint64_t));
+        ctx->marks[ctx->touched[i]] = false;
+    }
+    ctx->touched_count = 0;
+
+    uint32_t top = 0;
+    for(uint32_t k = 0; k < state->kernel_count; k++){
+        SymbolId next = space->item_next[state->kernel[k]];
+        if(next == LR_ITEM_END || grammar_symbol_is_terminal(grammar, next)) continue;
+        add_closure_lookahead(ctx, (uint32_t)grammar_nonterminal_id(grammar, next), state->kernel[k], kernel_la + (size_t)k * ctx->words, &top);
+    }
+    while(top){
+        uint32_t b = ctx->pending[--top];
+        ctx->marks[n + b] = false;
+        for(uint32_t k = ctx->rule_start[b]; k < ctx->rule_start[b + 1]; k++){
+            uint32_t r = ctx->rule_by_lhs[k];
+            const Rule* rule = &grammar->rules[r];
+            if(!rule->right_hs_count || grammar_symbol_is_terminal(grammar, rule->right_hs[0])) continue;
+            add_closure_lookahead(ctx, (uint32_t)grammar_nonterminal_id(grammar, rule->right_hs[0]), space->rule_base[r], closure_row(ctx, b), &top);
+        }
+    }
+}
+
+/// 闭包第 i 项的向前看集合：核心项取自状态，闭包项取所属左部的 closure_la 行
+static inline const uint64_t* item_lookahead(LR1Context* ctx, const ItemSet* set, uint32_t i, uint32_t kernel_count, const uint64_t* kernel_la){
+    if(i < kernel_count) return kernel_la + (size_t)i * ctx->words;
+    const Grammar* grammar = ctx->grammar;
+    uint32_t rule = ctx->dfa->items.item_rule[set->items[i]];
+    return closure_row(ctx, (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[rule].left_hs));
+}
+
+static bool lookahead_subset(const uint64_t* a, const uint64_t* b, size_t words){
+    for(size_t w = 0; w < words; w++){
+        if(a[w] & ~b[w]) return false;
+    }
+    return true;
+}
+
+static bool lookahead_intersects(const uint64_t* a, const uint64_t* b, size_t words){
+    for(size_t w = 0; w < words; w++){
+        if(a[w] & b[w]) return true;
+    }
+    return false;
+}
+
+/// Pager 弱相容：合并后第 i、j 项在同一终结符上都要归约时，合并前的某一方已经如此
+static bool weakly_compatible(const uint64_t* a, const uint64_t* b, uint32_t count, size_t words){
+    for(uint32_t i = 0; i < count; i++){
+        const uint64_t* a_i = a + (size_t)i * words;
+        const uint64_t* b_i = b + (size_t)i * words;
+        for(uint32_t j = i + 1; j < count; j++){
+            const uint64_t* a_j = a + (size_t)j * words;
+            const uint64_t* b_j = b + (size_t)j * words;
+            if(!lookahead_intersects(a_i, b_j, words) && !lookahead_intersects(b_i, a_j, words)) continue;
+            if(lookahead_intersects(a_i, a_j, words) || lookahead_intersects(b_i, b_j, words)) continue;
+            return false;
+        }
+    }
+    return true;
+}
+
+// goto 核心的一项与它带来的向前看集合
+typedef struct GotoItem{
+    LRItem item;
+    const uint64_t* la;
+} GotoItem;
+
+static int compare_goto_item(const void* a, const void* b){
+    LRItem x = ((const GotoItem*)a)->item, y = ((const GotoItem*)b)->item;
+    return (x > y) - (x < y);
+}
+
+static void sort_goto_items(GotoItem* items, uint32_t count){
+    if(count > 16){
+        qsort(items, count, sizeof(GotoItem), compare_goto_item);
+        return;
+    }
+    for(uint32_t i = 1; i < count; i++){
+        GotoItem item = items[i];
+        uint32_t j = i;
+        while(j > 0 && items[j - 1].item > item.item){
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = item;
+    }
+}
+
+#define LR1_PROCESSED 1
+#define LR1_QUEUED 2
+
+typedef struct LR1Builder{
+    LR1Context ctx;
+    LR1Automaton* lr1;
+    LR1Merge merge;
+    uint32_t* first_transition;     //状态第一次处理时转移的起点，之后重新处理时按相同顺序改写
+    uint8_t* flags;
+    uint32_t state_capacity;
+    uint32_t* queue;                //先进先出；合并后向前看增长的已处理状态重新入队
+    uint32_t queue_head;
+    uint32_t queue_count;
+    uint32_t queue_capacity;
+    GotoItem* gotos;
+    LRItem* kernel;
+    uint64_t* kernel_la;
+    uint32_t goto_capacity;
+} LR1Builder;
+
+static bool enqueue(LR1Builder* b, uint32_t state){
+    if(b->flags[state] & LR1_QUEUED) return true;
+    if(b->queue_count >= b->queue_capacity){
+        uint32_t capacity = b->queue_capacity ? b->queue_capacity * 2 : 64;
+        uint32_t* queue = lr1_alloc(b->ctx.arena, capacity * sizeof(uint32_t));
+        if(!queue) return false;
+        if(b->queue_count) memcpy(queue, b->queue, b->queue_count * sizeof(uint32_t));
+        b->queue = queue;
+        b->queue_capacity = capacity;
+    }
+    b->queue[b->queue_count++] = state;
+    b->flags[state] |= LR1_QUEUED;
+    return true;
+}
+
+/// 以 kernel/la 新建状态，返回状态号，失败时返回 -1
+static int add_lr1_state(LR1Builder* b, const LRItem* kernel, uint32_t count, const uint64_t* la){
+    LR1Automaton* lr1 = b->lr1;
+    size_t words = b->ctx.words;
+    if(lr1->dfa.state_count >= b->state_capacity){
+        uint32_t capacity = b->state_capacity ? b->state_capacity * 2 : 64;
+        uint64_t** lookaheads = lr1_alloc(b->ctx.arena, capacity * sizeof(uint64_t*));
+        uint32_t* first_transition = lr1_alloc(b->ctx.arena, capacity * sizeof(uint32_t));
+        uint8_t* flags = lr1_alloc(b->ctx.arena, capacity * sizeof(uint8_t));
+        if(!lookaheads || !first_transition || !flags) return -1;
+        if(lr1->dfa.state_count){
+            memcpy(lookaheads, lr1->lookaheads, lr1->dfa.state_count * sizeof(uint64_t*));
+            memcpy(first_transition, b->first_transition, lr1->dfa.state_count * sizeof(uint32_t));
+            memcpy(flags, b->flags, lr1->dfa.state_count * sizeof(uint8_t));
+        }
+        lr1->lookaheads = lookaheads;
+        b->first_transition = first_transition;
+        b->flags = flags;
+        b->state_capacity = capacity;
+    }
+    uint64_t* stored = lr1_alloc(b->ctx.arena, (size_t)count * words * sizeof(uint64_t));
+    if(!stored) return -1;
+    memcpy(stored, la, (size_t)count * words * sizeof(uint64_t));
+    uint32_t id = dfa_add_state(&lr1->dfa, kernel, count);
+    lr1->lookaheads[id] = stored;
+    b->first_transition[id] = 0;
+    b->flags[id] = 0;
+    return enqueue(b, id) ? (int)id : -1;
+}
+
+/// 把 la 并入状态 state，有增长时状态重新入队
+static bool merge_lookaheads(LR1Builder* b, uint32_t state, const uint64_t* la, uint32_t count){
+    if(!bitset_union(b->lr1->lookaheads[state], la, (size_t)count * b->ctx.words)) return true;
+    b->lr1->merge_count++;
+    return enqueue(b, state);
+}
+
+/// 找到 goto 核心的目标状态：向前看集合相同（规范 LR(1)）或包含它、弱相容（Pager）的同核心状态，都没有时新建。
+/// skip 为已经检查过的状态，不再考虑
+static int find_lr1_state(LR1Builder* b, const LRItem* kernel, uint32_t count, const uint64_t* la, int skip){
+    const LR1Automaton* lr1 = b->lr1;
+    size_t bytes = (size_t)count * b->ctx.words * sizeof(uint64_t);
+    uint32_t cursor = 0;
+    int compatible = -1;
+    for(int s; (s = dfa_find_kernel(&lr1->dfa, kernel, count, &cursor)) != -1;){
+        if(s == skip) continue;
+        const uint64_t* stored = lr1->lookaheads[s];
+        if(b->merge == LR1_CANONICAL){
+            if(memcmp(stored, la, bytes) == 0) return s;
+            continue;
+        }
+        if(lookahead_subset(la, stored, (size_t)count * b->ctx.words)) return s;
+        if(compatible == -1 && weakly_compatible(stored, la, count, b->ctx.words)) compatible = s;
+    }
+    if(compatible != -1) return merge_lookaheads(b, (uint32_t)compatible, la, count) ? compatible : -1;
+    return add_lr1_state(b, kernel, count, la);
+}
+
+static bool reserve_gotos(LR1Builder* b, uint32_t count){
+    if(count <= b->goto_capacity) return true;
+    uint32_t capacity = b->goto_capacity ? b->goto_capacity : 16;
+    while(capacity < count) capacity *= 2;
+    b->gotos = lr1_alloc(b->ctx.arena, capacity * sizeof(GotoItem));
+    b->kernel = lr1_alloc(b->ctx.arena, capacity * sizeof(LRItem));
+    b->kernel_la = lr1_alloc(b->ctx.arena, (size_t)capacity * b->ctx.words * sizeof(uint64_t));
+    b->goto_capacity = capacity;
+    return b->gotos && b->kernel && b->kernel_la;
+}
+
+/// 处理一个状态：求闭包与向前看，对每个符号求 goto 核心并找到目标。第一次处理时追加转移，
+/// 之后（Pager 合并使向前看增长）按同样的符号顺序把增长传给原目标，原目标不再相容时改指别的状态
+static bool process_lr1_state(LR1Builder* b, uint32_t s, ItemSet* set, uint32_t* seen, uint32_t stamp){
+    DFA* dfa = &b->lr1->dfa;
+    const LRItemSpace* space = &dfa->items;
+    size_t words = b->ctx.words;
+    uint64_t* kernel_la = b->lr1->lookaheads[s];
+    uint32_t kernel_count = dfa->states[s].kernel_count;
+    bool processed = b->flags[s] & LR1_PROCESSED;
+
+    compute_closure_lookaheads(&b->ctx, &dfa->states[s], kernel_la);
+    dfa_state_closure(dfa, s, set);
+
+    uint32_t edge = processed ? b->first_transition[s] : dfa->transition_count;
+    if(!processed) b->first_transition[s] = edge;
+    for(uint32_t j = 0; j < set->item_count; j++){
+        SymbolId sym = space->item_next[set->items[j]];
+        if(sym == LR_ITEM_END || seen[sym] == stamp) continue;
+        seen[sym] = stamp;
+
+        uint32_t count = 0;
+        for(uint32_t k = j; k < set->item_count; k++) count += space->item_next[set->items[k]] == sym;
+        if(!reserve_gotos(b, count)) return false;
+        count = 0;
+        for(uint32_t k = j; k < set->item_count; k++){
+            if(space->item_next[set->items[k]] != sym) continue;
+            b->gotos[count++] = (GotoItem){ set->items[k] + 1, item_lookahead(&b->ctx, set, k, kernel_count, kernel_la) };
+        }
+        sort_goto_items(b->gotos, count);
+        for(uint32_t k = 0; k < count; k++){
+            b->kernel[k] = b->gotos[k].item;
+            memcpy(b->kernel_la + (size_t)k * words, b->gotos[k].la, words * sizeof(uint64_t));
+        }
+
+        if(!processed){
+            int target = find_lr1_state(b, b->kernel, count, b->kernel_la, -1);
+            if(target < 0) return false;
+            dfa_add_transition(dfa, s, sym, (uint32_t)target);
+            continue;
+        }
+        Transition* t = &dfa->transitions[edge++];
+        const uint64_t* stored = b->lr1->lookaheads[t->to_state];
+        if(lookahead_subset(b->kernel_la, stored, (size_t)count * words)) continue;
+        if(weakly_compatible(stored, b->kernel_la, count, words)){
+            if(!merge_lookaheads(b, t->to_state, b->kernel_la, count)) return false;
+            continue;
+        }
+        int target = find_lr1_state(b, b->kernel, count, b->kernel_la, (int)t->to_state);
+        if(target < 0) return false;
+        dfa->transitions[edge - 1].to_state = (uint32_t)target;
+    }
+    b->flags[s] |= LR1_PROCESSED;
+    return true;
+}
+
+bool build_lr1_automaton(const Grammar* grammar, const SymbolSet* sets, LR1Merge merge, LR1Automaton* lr1, Arena* arena){
+    memset(lr1, 0, sizeof(LR1Automaton));
+    if(!lr_grammar_is_augmented(grammar)) return false;
+    dfa_init(&lr1->dfa, grammar, arena);
+    lr1->sets = sets;
+    LR1Builder b = { .lr1 = lr1, .merge = merge };
+    if(!lr1_context_init(&b.ctx, &lr1->dfa, sets, arena)) return false;
+    lr1->words = b.ctx.words;
+
+    // 开始状态：rules[0] 点在最左，向前看为 '$'
+    LRItem start = lr1->dfa.items.rule_base[0];
+    uint64_t* la = lr1_alloc(arena, lr1->words * sizeof(uint64_t));
+    uint32_t* seen = lr1_alloc(arena, (grammar->symbol_count + 1) * sizeof(uint32_t));
+    if(!la || !seen) return false;
+    memset(la, 0, lr1->words * sizeof(uint64_t));
+    memset(seen, 0, (grammar->symbol_count + 1) * sizeof(uint32_t));
+    bitset_add(la, grammar_end_marker_id(grammar));
+    if(add_lr1_state(&b, &start, 1, la) < 0) return false;
+
+    // seen[sym] == stamp 表示本次处理已经求过 sym 上的转移；同一状态可能处理多次，故按处理次数而不是状态号标记
+    ItemSet set = {0};
+    for(uint32_t stamp = 1; b.queue_head < b.queue_count; stamp++){
+        uint32_t s = b.queue[b.queue_head++];
+        b.flags[s] &= (uint8_t)~LR1_QUEUED;
+        if(!process_lr1_state(&b, s, &set, seen, stamp)) return false;
+    }
+    dfa_finish(&lr1->dfa);
+    return true;
+}
+
+bool build_lr1_table(const LR1Automaton* lr1, LRTable* table, Arena* arena){
+    const DFA* dfa = &lr1->dfa;
+    if(!lr_table_init(dfa, table, arena)) return false;
+    const Grammar* grammar = dfa->grammar;
+    uint32_t end = grammar->terminals_count;
+    LR1Context ctx;
+    if(!lr1_context_init(&ctx, dfa, lr1->sets, arena)) return false;
+    ItemSet set = {0};
+    for(uint32_t s = 0; s < dfa->state_count; s++){
+        compute_closure_lookaheads(&ctx, &dfa->states[s], lr1->lookaheads[s]);
+        dfa_state_closure(dfa, s, &set);
+        for(uint32_t i = 0; i < set.item_count; i++){
+            if(dfa_item_next(dfa, set.items[i]) != LR_ITEM_END) continue;
+            uint32_t rule = dfa_item_rule(dfa, set.items[i]);
+            if(rule == 0){
+                if(!lr_table_set_action(table, s, end, lr_accept(), arena)) return false;
+                continue;
+            }
+            const uint64_t* la = item_lookahead(&ctx, &set, i, dfa->states[s].kernel_count, lr1->lookaheads[s]);
+            for(size_t w = 0; w < ctx.words; w++){
+                for(uint64_t bits = la[w]; bits; bits &= bits - 1){
+                    uint32_t column = (uint32_t)(w * SYMBOL_SET_WORD_BITS + __builtin_ctzll(bits));
+                    if(!lr_table_set_action(table, s, column, lr_reduce(rule), arena)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
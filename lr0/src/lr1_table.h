@@ -0,0 +1,37 @@
+#ifndef LR1_TABLE_H
+#define LR1_TABLE_H
+
+#include "arena.h"
+#include "../../ll1/src/first_follow.h"
+#include "lr_table.h"
+#include "viable_prefix_dfa.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum LR1Merge{
+    LR1_CANONICAL = 0,      //不合并，核心与向前看集合都相同才是同一状态
+    LR1_PAGER               //核心相同且满足 Pager 弱相容时合并
+} LR1Merge;
+
+// LR(1) 自动机。状态、转移与核心项沿用 DFA 的表示，同一核心可以对应多个状态；
+// lookaheads[s] 依次存放状态 s 各核心项的向前看集合，每项 words 个字，位的含义与 Follow 集相同
+typedef struct LR1Automaton{
+    DFA dfa;
+    uint64_t** lookaheads;
+    size_t words;
+    const SymbolSet* sets;
+    uint32_t merge_count;   //Pager 合并的次数
+} LR1Automaton;
+
+// 构造 LR(1) 自动机。sets 为 compute_first_sets 的结果（First 与 nullable），用于求闭包项的向前看集合。
+// Pager 合并：新状态与已有的同核心状态弱相容，即任意两项 i != j 满足
+//   (L_i ∩ L'_j) ∪ (L'_i ∩ L_j) = ∅，或 L_i ∩ L_j ≠ ∅，或 L'_i ∩ L'_j ≠ ∅
+// 时并入已有状态，向前看集合有增长的状态重新计算后继并把增长传下去。
+// 弱相容的合并不会引入规范 LR(1) 没有的归约-归约冲突，状态数通常与 LALR(1) 相当
+// rules[0] 不是增广产生式（见 lr_grammar_is_augmented）时报错并返回 false
+bool build_lr1_automaton(const Grammar* grammar, const SymbolSet* sets, LR1Merge merge, LR1Automaton* lr1, Arena* arena);
+
+// 完成项 A -> α. 在其向前看集合上归约；rules[0] 只在开始状态读完右部后完成，在 '$' 上接受
+bool build_lr1_table(const LR1Automaton* lr1, LRTable* table, Arena* arena);
+
+#endif
@@ -0,0 +1,52 @@
+#include "lr_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct CachedLRTableHeader{
+    uint32_t state_count;
+    uint32_t action_columns;
+    uint32_t goto_columns;
+    uint32_t conflict_count;
+} CachedLRTableHeader;
+
+bool cache_put_lr_table(GrammarCacheWriter* writer, const LRTable* table, Arena* arena){
+    CachedLRTableHeader header = { table->state_count, table->action_columns, table->goto_columns, table->conflict_count };
+    size_t action = (size_t)header.state_count * header.action_columns * sizeof(LRAction);
+    size_t goto_table = (size_t)header.state_count * header.goto_columns * sizeof(int32_t);
+    size_t conflicts = header.conflict_count * sizeof(LRConflict);
+    size_t size = cache_align(sizeof(header)) + cache_align(action) + cache_align(goto_table) + cache_align(conflicts);
+    char* data = arena_alloc(arena, size);
+    if(!data){
+        fprintf(stderr, "Error: Failed to allocate memory for the cached LR table.\n");
+        return false;
+    }
+    memset(data, 0, size);
+    CacheCursor cursor = { data, 0, size };
+    *(CachedLRTableHeader*)cache_cursor_take(&cursor, sizeof(header)) = header;
+    memcpy(cache_cursor_take(&cursor, action), table->action, action);
+    memcpy(cache_cursor_take(&cursor, goto_table), table->goto_table, goto_table);
+    if(conflicts) memcpy(cache_cursor_take(&cursor, conflicts), table->conflicts, conflicts);
+    return grammar_cache_writer_add(writer, CACHE_SECTION_LR_TABLE, data, size);
+}
+
+bool cache_load_lr_table(const GrammarCache* cache, const Grammar* grammar, LRTable* table){
+    size_t size;
+    char* data = (char*)grammar_cache_section(cache, CACHE_SECTION_LR_TABLE, &size);
+    if(!data) return false;
+    CacheCursor cursor = { data, 0, size };
+    const CachedLRTableHeader* header = cache_cursor_take(&cursor, sizeof(CachedLRTableHeader));
+    if(!header || header->action_columns != grammar->terminals_count + 1 || header->goto_columns != grammar->nonterminals_count){
+        return false;
+    }
+    memset(table, 0, sizeof(LRTable));
+    table->state_count = header->state_count;
+    table->action_columns = header->action_columns;
+    table->goto_columns = header->goto_columns;
+    table->action = cache_cursor_take(&cursor, (size_t)header->state_count * header->action_columns * sizeof(LRAction));
+    table->goto_table = cache_cursor_take(&cursor, (size_t)header->state_count * header->goto_columns * sizeof(int32_t));
+    table->conflicts = cache_cursor_take(&cursor, header->conflict_count * sizeof(LRConflict));
+    table->conflict_count = header->conflict_count;
+    table->conflict_capacity = header->conflict_count;
+    return table->action && table->goto_table && table->conflicts;
+}
@@ -0,0 +1,14 @@
+#ifndef LR_CACHE_H
+#define LR_CACHE_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "../../ll1/src/grammar_cache.h"
+#include "lr_table.h"
+#include <stdbool.h>
+
+// LR ACTION/GOTO 表在缓存中的段。读出的表直接引用映射；状态数之外的规模与文法不符时视为失配
+bool cache_put_lr_table(GrammarCacheWriter* writer, const LRTable* table, Arena* arena);
+bool cache_load_lr_table(const GrammarCache* cache, const Grammar* grammar, LRTable* table);
+
+#endif
@@ -0,0 +1,143 @@
+#include "lr_parser.h"
+#include "lr_table.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int token_array_next(void* context){
+    TokenArray* input = context;
+    if(input->pos >= input->count) return input->end;
+    return input->tokens[input->pos++];
+}
+
+bool lr_parser_init(LRParser* parser, const Grammar* grammar, const LRTable* table,
+                    size_t stack_capacity, size_t event_capacity,
+                    ParseEventSink sink, void* sink_context, Arena* arena)
+{
+    memset(parser, 0, sizeof(LRParser));
+    if(!grammar || !table || grammar->rule_count == 0 || table->state_count == 0 || stack_capacity < 2 || event_capacity == 0){
+        fprintf(stderr, "Error: Invalid arguments for LR parser.\n");
+        return false;
+    }
+    parser->grammar = grammar;
+    parser->table = table;
+    parser->stack_capacity = stack_capacity;
+    parser->event_capacity = event_capacity;
+    parser->sink = sink;
+    parser->sink_context = sink_context;
+    parser->states = arena_alloc(arena, stack_capacity * sizeof(int32_t));
+    parser->values = arena_alloc(arena, stack_capacity * sizeof(LRValue));
+    parser->events = arena_alloc(arena, event_capacity * sizeof(ParseEvent));
+    parser->rule_length = arena_alloc(arena, grammar->rule_count * sizeof(uint32_t));
+    parser->rule_lhs = arena_alloc(arena, grammar->rule_count * sizeof(uint32_t));
+    if(!parser->states || !parser->values || !parser->events || !parser->rule_length || !parser->rule_lhs){
+        fprintf(stderr, "Error: Failed to allocate memory for parser stack.\n");
+        return false;
+    }
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        parser->rule_length[r] = grammar->rules[r].right_hs_count;
+        parser->rule_lhs[r] = (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[r].left_hs);
+    }
+    return true;
+}
+
+void lr_parser_set_actions(LRParser* parser, const LRReduceAction* actions, void* context){
+    parser->actions = actions;
+    parser->action_context = context;
+}
+
+/// 事件先写入定长缓冲，满了再整批交给 sink
+static inline void emit_event(LRParser* parser, size_t* count, ParseEvent event){
+    if(*count == parser->event_capacity){
+        parser->sink(parser->sink_context, parser->events, *count);
+        *count = 0;
+    }
+    parser->events[(*count)++] = event;
+}
+
+/// 由值栈上 rule 右部的值求左部的值
+static inline LRValue reduce_value(const LRParser* parser, uint32_t rule, size_t top){
+    uint32_t n = parser->rule_length[rule];
+    LRReduceAction action = parser->actions ? parser->actions[rule] : NULL;
+    if(action) return action(parser->action_context, rule, parser->values + top, n);
+    return n ? parser->values[top] : 0;
+}
+
+/// 移进-归约主循环：按栈顶状态与当前 token 查 ACTION。移进时压入目标状态与 token 下标并读入下一个 token；
+/// 归约时弹出右部、执行语义动作，再按露出的状态与左部查 GOTO 压入新状态
+LRParseResult lr_parse(LRParser* parser, TokenIterator* input){
+    const LRTable* table = parser->table;
+    const LRAction* action = table->action;
+    const int32_t* goto_table = table->goto_table;
+    const size_t action_columns = table->action_columns;
+    const size_t goto_columns = table->goto_columns;
+    const int end = (int)action_columns - 1;
+    const uint32_t* rule_length = parser->rule_length;
+    const uint32_t* rule_lhs = parser->rule_lhs;
+    const bool emit = parser->sink != NULL;
+    int32_t* states = parser->states;
+    LRValue* values = parser->values;
+    size_t capacity = parser->stack_capacity;
+    size_t top = 0;
+    size_t event_count = 0;
+    LRParseResult result = { LR_PARSE_OK, 0, -1, 0 };
+
+    states[top] = 0;
+    values[top++] = 0;
+    int token = input->next(input->context);
+    if(token < 0 || token > end) token = -1;
+
+    for(;;){
+        LRAction a = token < 0 ? LR_ACTION_ERROR : action[(size_t)states[top - 1] * action_columns + token];
+        LRActionKind kind = lr_action_kind(a);
+        if(kind == LR_SHIFT){
+            if(top == capacity){
+                result.status = LR_PARSE_STACK_OVERFLOW;
+                break;
+            }
+            states[top] = (int32_t)lr_action_value(a);
+            values[top++] = (LRValue)result.token_count;
+            if(emit) emit_event(parser, &event_count, ~token);
+            result.token_count++;
+            token = input->next(input->context);
+            if(token < 0 || token > end) token = -1;
+            continue;
+        }
+        if(kind == LR_REDUCE){
+            uint32_t rule = lr_action_value(a);
+            top -= rule_length[rule];
+            LRValue value = reduce_value(parser, rule, top);
+            if(emit) emit_event(parser, &event_count, (ParseEvent)rule);
+            int32_t next = goto_table[(size_t)states[top - 1] * goto_columns + rule_lhs[rule]];
+            // 由增广文法构造的表在归约后总有转移，这里只防止不一致的表把状态号 -1 压栈
+            if(next == LR_GOTO_NONE){
+                result.status = LR_PARSE_SYNTAX_ERROR;
+                break;
+            }
+            if(top == capacity){
+                result.status = LR_PARSE_STACK_OVERFLOW;
+                break;
+            }
+            states[top] = next;
+            values[top++] = value;
+            continue;
+        }
+        if(kind == LR_ACCEPT){
+            top -= rule_length[0];
+            if(top != 1){
+                result.status = LR_PARSE_SYNTAX_ERROR;
+                break;
+            }
+            result.value = reduce_value(parser, 0, top);
+            if(emit) emit_event(parser, &event_count, 0);
+            break;
+        }
+        result.status = LR_PARSE_SYNTAX_ERROR;
+        break;
+    }
+
+    if(result.status != LR_PARSE_OK) result.error_terminal = token;
+    if(event_count && parser->sink) parser->sink(parser->sink_context, parser->events, event_count);
+    return result;
+}
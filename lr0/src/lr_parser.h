@@ -0,0 +1,86 @@
+#ifndef LR_PARSER_H
+#define LR_PARSER_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "lr_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 输入：每次返回下一个 token 的终结符编号（grammar->terminals 中的下标），
+// 输入结束时返回 grammar->terminals_count，即 '$'
+typedef int (*TokenNext)(void* context);
+
+typedef struct TokenIterator{
+    TokenNext next;
+    void* context;
+} TokenIterator;
+
+// 现成的数组输入，直接引用调用方的 token 数组，不做复制
+typedef struct TokenArray{
+    const int32_t* tokens;
+    size_t count;
+    size_t pos;
+    int end;    //结束符编号，即 terminals_count
+} TokenArray;
+
+int token_array_next(void* context);
+
+// 输出为最右推导的逆序事件流：非负值为归约所用的产生式下标，负值 ~t 为移进了终结符 t
+typedef int32_t ParseEvent;
+
+static inline bool parse_event_is_rule(ParseEvent event){ return event >= 0; }
+static inline int parse_event_rule(ParseEvent event){ return event; }
+static inline int parse_event_terminal(ParseEvent event){ return ~event; }
+
+// 事件缓冲写满或分析结束时调用，sink 为 NULL 时不产生事件
+typedef void (*ParseEventSink)(void* context, const ParseEvent* events, size_t count);
+
+// 语义值。终结符的值为它在输入中的下标，语义动作可以据此回到调用方的 token/词素数组取值
+typedef intptr_t LRValue;
+
+// 按产生式 rule 归约时的语义动作：values 指向值栈上右部各符号的值（共 count 个），返回左部的值
+typedef LRValue (*LRReduceAction)(void* context, uint32_t rule, const LRValue* values, uint32_t count);
+
+typedef enum {
+    LR_PARSE_OK = 0,
+    LR_PARSE_SYNTAX_ERROR,
+    LR_PARSE_STACK_OVERFLOW
+} LRParseStatus;
+
+typedef struct LRParseResult{
+    LRParseStatus status;
+    size_t token_count;     //已移进的 token 数；出错时即出错 token 的下标
+    int error_terminal;     //出错时读到的终结符编号
+    LRValue value;          //接受时 rules[0] 左部的值
+} LRParseResult;
+
+// 非递归的表驱动移进-归约分析器。状态栈与值栈、事件缓冲、各产生式的右部长度与左部在初始化时一次分配好，
+// 分析过程中不再分配内存：栈深超过 stack_capacity 时报 LR_PARSE_STACK_OVERFLOW。
+// 每个 token 查一次 ACTION 表；归约按产生式下标查 actions 分派语义动作（为 NULL 或对应项为 NULL 时
+// 取右部第一个符号的值，空产生式取 0），并查一次 GOTO 表。rules[0] 视为增广产生式，接受前也按它归约一次
+typedef struct LRParser{
+    const Grammar* grammar;
+    const LRTable* table;
+    uint32_t* rule_length;      //产生式右部长度，即归约时弹栈的深度
+    uint32_t* rule_lhs;         //产生式左部的非终结符编号，即 GOTO 的列
+    int32_t* states;
+    LRValue* values;            //与 states 对齐，values[i] 为 states[i] 所读入符号的值
+    size_t stack_capacity;
+    const LRReduceAction* actions;
+    void* action_context;
+    ParseEvent* events;
+    size_t event_capacity;
+    ParseEventSink sink;
+    void* sink_context;
+} LRParser;
+
+bool lr_parser_init(LRParser* parser, const Grammar* grammar, const LRTable* table,
+                    size_t stack_capacity, size_t event_capacity,
+                    ParseEventSink sink, void* sink_context, Arena* arena);
+// actions 为 rule_count 项的分派表，分析期间须保持有效
+void lr_parser_set_actions(LRParser* parser, const LRReduceAction* actions, void* context);
+LRParseResult lr_parse(LRParser* parser, TokenIterator* input);
+
+#endif
@@ -0,0 +1,196 @@
+#include "lr_table.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+bool lr_grammar_is_augmented(const Grammar* grammar){
+    if(grammar->rule_count == 0){
+        fprintf(stderr, "Error: Empty grammar for LR table.\n");
+        return false;
+    }
+    SymbolId start = grammar->rules[0].left_hs;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        bool used = r != 0 && rule->left_hs == start;
+        for(uint32_t i = 0; i < rule->right_hs_count && !used; i++) used = rule->right_hs[i] == start;
+        if(used){
+            fprintf(stderr, "Error: The first rule is not an augmented start rule: ");
+            fprint_symbol(stderr, grammar, start);
+            fprintf(stderr, " has other rules or appears on a right side. Add a new start rule S' -> S first.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool lr_table_init(const DFA* dfa, LRTable* table, Arena* arena){
+    const Grammar* grammar = dfa->grammar;
+    memset(table, 0, sizeof(LRTable));
+    if(!lr_grammar_is_augmented(grammar)) return false;
+    table->state_count = dfa->state_count;
+    table->action_columns = grammar->terminals_count + 1;
+    table->goto_columns = grammar->nonterminals_count;
+
+    size_t action_cells = (size_t)table->state_count * table->action_columns;
+    size_t goto_cells = (size_t)table->state_count * table->goto_columns;
+    table->action = arena_alloc(arena, (action_cells ? action_cells : 1) * sizeof(LRAction));
+    table->goto_table = arena_alloc(arena, (goto_cells ? goto_cells : 1) * sizeof(int32_t));
+    if(!table->action || !table->goto_table){
+        fprintf(stderr, "Error: Failed to allocate memory for LR table.\n");
+        return false;
+    }
+    memset(table->action, 0, action_cells * sizeof(LRAction));
+    memset(table->goto_table, 0xff, goto_cells * sizeof(int32_t));
+
+    for(uint32_t s = 0; s < dfa->state_count; s++){
+        uint32_t count;
+        const Transition* edges = dfa_transitions(dfa, s, &count);
+        for(uint32_t i = 0; i < count; i++){
+            const Transition* t = &edges[i];
+            if(grammar_symbol_is_terminal(grammar, t->symbol)){
+                uint32_t column = (uint32_t)grammar_terminal_id(grammar, t->symbol);
+                if(!lr_table_set_action(table, s, column, lr_shift(t->to_state), arena)) return false;
+            }else{
+                uint32_t column = (uint32_t)grammar_nonterminal_id(grammar, t->symbol);
+                table->goto_table[(size_t)s * table->goto_columns + column] = (int32_t)t->to_state;
+            }
+        }
+    }
+    return true;
+}
+
+static bool record_conflict(LRTable* table, uint32_t state, uint32_t terminal, LRAction chosen, LRAction rejected, Arena* arena){
+    if(table->conflict_count >= table->conflict_capacity){
+        uint32_t capacity = table->conflict_capacity ? table->conflict_capacity * 2 : 16;
+        LRConflict* conflicts = arena_alloc(arena, capacity * sizeof(LRConflict));
+        if(!conflicts){
+            fprintf(stderr, "Error: Failed to allocate memory for LR conflicts.\n");
+            return false;
+        }
+        if(table->conflict_count) memcpy(conflicts, table->conflicts, table->conflict_count * sizeof(LRConflict));
+        table->conflicts = conflicts;
+        table->conflict_capacity = capacity;
+    }
+    table->conflicts[table->conflict_count++] = (LRConflict){ state, terminal, chosen, rejected };
+    return true;
+}
+
+bool lr_table_set_action(LRTable* table, uint32_t state, uint32_t terminal, LRAction action, Arena* arena){
+    LRAction* cell = &table->action[(size_t)state * table->action_columns + terminal];
+    if(*cell == LR_ACTION_ERROR){
+        *cell = action;
+        return true;
+    }
+    if(*cell == action) return true;
+    return record_conflict(table, state, terminal, *cell, action, arena);
+}
+
+/// 完成项对应的产生式下标，不是完成项时返回 -1
+static int completed_rule(const DFA* dfa, LRItem item){
+    return dfa_item_next(dfa, item) == LR_ITEM_END ? (int)dfa_item_rule(dfa, item) : -1;
+}
+
+bool build_lr0_table(const DFA* dfa, LRTable* table, Arena* arena){
+    if(!lr_table_init(dfa, table, arena)) return false;
+    const Grammar* grammar = dfa->grammar;
+    uint32_t end = grammar->terminals_count;
+    ItemSet set = {0};
+    for(uint32_t s = 0; s < dfa->state_count; s++){
+        dfa_state_closure(dfa, s, &set);
+        for(uint32_t i = 0; i < set.item_count; i++){
+            int rule = completed_rule(dfa, set.items[i]);
+            if(rule < 0) continue;
+            if(rule == 0){
+                if(!lr_table_set_action(table, s, end, lr_accept(), arena)) return false;
+                continue;
+            }
+            for(uint32_t column = 0; column <= end; column++){
+                if(!lr_table_set_action(table, s, column, lr_reduce((uint32_t)rule), arena)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool compress_lr_table(const LRTable* table, CompressedTable* action, CompressedTable* goto_table, Arena* arena){
+    return compress_table(table->action, table->state_count, table->action_columns, LR_ACTION_ERROR, true, action, arena)
+        && compress_table(table->goto_table, table->state_count, table->goto_columns, LR_GOTO_NONE, true, goto_table, arena);
+}
+
+static void print_column(const Grammar* grammar, uint32_t column){
+    if(column == grammar->terminals_count) printf("$");
+    else fprint_symbol(stdout, grammar, grammar->terminals[column]);
+}
+
+static void print_action(LRAction action){
+    switch(lr_action_kind(action)){
+    case LR_SHIFT: printf("s%u", lr_action_value(action)); break;
+    case LR_REDUCE: printf("r%u", lr_action_value(action)); break;
+    case LR_ACCEPT: printf("acc"); break;
+    default: printf("-"); break;
+    }
+}
+
+/// 逐个状态打印非空格：先 ACTION，后 GOTO
+void print_lr_table(const Grammar* grammar, const LRTable* table){
+    for(uint32_t s = 0; s < table->state_count; s++){
+        printf("State %u:", s);
+        for(uint32_t column = 0; column < table->action_columns; column++){
+            LRAction action = lr_table_action(table, s, column);
+            if(action == LR_ACTION_ERROR) continue;
+            printf(" ");
+            print_column(grammar, column);
+            printf(":");
+            print_action(action);
+        }
+        for(uint32_t column = 0; column < table->goto_columns; column++){
+            int32_t target = lr_table_goto(table, s, column);
+            if(target == LR_GOTO_NONE) continue;
+            printf(" ");
+            fprint_symbol(stdout, grammar, grammar->nonterminals[column]);
+            printf(":%d", target);
+        }
+        printf("\n");
+    }
+}
+
+static void print_conflict(const Grammar* grammar, const LRConflict* c){
+    printf("Conflict at ACTION[%u, ", c->state);
+    print_column(grammar, c->terminal);
+    printf("]: ");
+    print_action(c->chosen);
+    printf("  vs  ");
+    print_action(c->rejected);
+    printf("\n");
+}
+
+void print_lr_conflicts(const Grammar* grammar, const LRTable* table){
+    for(uint32_t i = 0; i < table->conflict_count; i++) print_conflict(grammar, &table->conflicts[i]);
+}
+
+/// 项目是否产生了该动作：移进对应点后为该终结符的项，归约与接受对应相应产生式的完成项
+static bool item_yields(const DFA* dfa, LRItem item, uint32_t terminal, LRAction action){
+    SymbolId next = dfa_item_next(dfa, item);
+    switch(lr_action_kind(action)){
+    case LR_SHIFT: return next != LR_ITEM_END && terminal < dfa->grammar->terminals_count && next == dfa->grammar->terminals[terminal];
+    case LR_REDUCE: return next == LR_ITEM_END && dfa_item_rule(dfa, item) == lr_action_value(action);
+    case LR_ACCEPT: return next == LR_ITEM_END && dfa_item_rule(dfa, item) == 0;
+    default: return false;
+    }
+}
+
+void print_lr_conflict_items(const DFA* dfa, const LRTable* table){
+    ItemSet set = {0};
+    for(uint32_t i = 0; i < table->conflict_count; i++){
+        const LRConflict* c = &table->conflicts[i];
+        print_conflict(dfa->grammar, c);
+        dfa_state_closure(dfa, c->state, &set);
+        for(uint32_t k = 0; k < set.item_count; k++){
+            if(!item_yields(dfa, set.items[k], c->terminal, c->chosen) && !item_yields(dfa, set.items[k], c->terminal, c->rejected)) continue;
+            printf("    ");
+            fprint_item(stdout, dfa, set.items[k]);
+            printf("\n");
+        }
+    }
+}
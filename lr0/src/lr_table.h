@@ -0,0 +1,78 @@
+#ifndef LR_TABLE_H
+#define LR_TABLE_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "../../ll1/src/table_compress.h"
+#include "viable_prefix_dfa.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ACTION 表项：低 2 位为动作类型，其余位为参数（移进的目标状态或归约的产生式下标），0 即出错
+typedef int32_t LRAction;
+
+typedef enum LRActionKind{
+    LR_ERROR = 0,
+    LR_SHIFT = 1,
+    LR_REDUCE = 2,
+    LR_ACCEPT = 3
+} LRActionKind;
+
+#define LR_ACTION_ERROR 0
+#define LR_GOTO_NONE (-1)
+
+static inline LRAction lr_shift(uint32_t state){ return (LRAction)(state << 2 | LR_SHIFT); }
+static inline LRAction lr_reduce(uint32_t rule){ return (LRAction)(rule << 2 | LR_REDUCE); }
+static inline LRAction lr_accept(void){ return LR_ACCEPT; }
+static inline LRActionKind lr_action_kind(LRAction action){ return (LRActionKind)(action & 3); }
+static inline uint32_t lr_action_value(LRAction action){ return (uint32_t)action >> 2; }
+
+// 同一格中出现两个动作：chosen 为保留在表中的动作，rejected 为被舍弃的动作
+typedef struct LRConflict{
+    uint32_t state;
+    uint32_t terminal;      //终结符编号，terminals_count 为 '$'
+    LRAction chosen;
+    LRAction rejected;
+} LRConflict;
+
+// ACTION/GOTO 表，均按行主序存放，每行对应自动机的一个状态。
+// ACTION 的列为终结符（最后一列为 '$'），GOTO 的列为非终结符，LR_GOTO_NONE 表示无转移
+typedef struct LRTable{
+    LRAction* action;
+    int32_t* goto_table;
+    uint32_t state_count;
+    uint32_t action_columns;
+    uint32_t goto_columns;
+    LRConflict* conflicts;
+    uint32_t conflict_count;
+    uint32_t conflict_capacity;
+} LRTable;
+
+static inline LRAction lr_table_action(const LRTable* table, uint32_t state, uint32_t terminal){
+    return table->action[(size_t)state * table->action_columns + terminal];
+}
+
+static inline int32_t lr_table_goto(const LRTable* table, uint32_t state, uint32_t nonterminal){
+    return table->goto_table[(size_t)state * table->goto_columns + nonterminal];
+}
+
+// 各 LR 构造都把 rules[0] 当作增广产生式 S' -> α：S' 没有别的产生式，也不出现在任何右部，
+// 于是 rules[0] 只在开始状态出现、只在 '$' 上接受。不满足时报错并返回 false
+bool lr_grammar_is_augmented(const Grammar* grammar);
+// 分配空表并由自动机的转移填入移进与 GOTO（先检查 lr_grammar_is_augmented）；其余格由具体的分析方法（LR(0)、SLR(1) ...）填入归约
+bool lr_table_init(const DFA* dfa, LRTable* table, Arena* arena);
+// 填入一格：格已有不同动作时记录冲突并保留原动作（移进先于归约填入，即移进优先）
+bool lr_table_set_action(LRTable* table, uint32_t state, uint32_t terminal, LRAction action, Arena* arena);
+// LR(0) 分析表：含完成项 A -> α. 的状态在每一列上归约；rules[0] 完成时在 '$' 上接受
+bool build_lr0_table(const DFA* dfa, LRTable* table, Arena* arena);
+
+// 压缩 ACTION 与 GOTO 表。ACTION 中出错格由每行最常见的动作（通常是归约）填充，即默认归约，
+// 错误仍会在下一次移进之前发现；GOTO 只会在归约后以合法的状态查询，出错格同样可以任意填充
+bool compress_lr_table(const LRTable* table, CompressedTable* action, CompressedTable* goto_table, Arena* arena);
+
+void print_lr_table(const Grammar* grammar, const LRTable* table);
+void print_lr_conflicts(const Grammar* grammar, const LRTable* table);
+// 同 print_lr_conflicts，并在每处冲突下列出状态中引起两个动作的项目
+void print_lr_conflict_items(const DFA* dfa, const LRTable* table);
+
+#endif
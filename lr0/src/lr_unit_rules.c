@@ -0,0 +1,194 @@
+#include "lr_unit_rules.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct UnitContext{
+    LRTable* table;
+    Arena* arena;
+    const bool* unit;           //unit[r]：产生式 r 可以绕过
+    const uint32_t* rule_lhs;   //产生式左部的非终结符编号
+    uint32_t original_count;    //原有状态数，之后的行都是新建的
+    uint32_t row_capacity;
+    uint32_t* slots;            //新行按内容散列去重：0 为空，否则为行号 + 1
+    uint32_t slot_capacity;
+    uint64_t* row_hash;         //新行的散列，下标为行号 - original_count
+    LRAction* action;           //正在构造的一行
+    int32_t* goto_row;
+    uint32_t* chain;            //本行用到的链上状态
+    uint32_t chain_count;
+} UnitContext;
+
+static uint64_t row_hash(const LRAction* action, uint32_t action_columns, const int32_t* goto_row, uint32_t goto_columns){
+    uint64_t h = 1469598103934665603ULL;
+    for(uint32_t c = 0; c < action_columns; c++){
+        h ^= (uint32_t)action[c];
+        h *= 1099511628211ULL;
+    }
+    for(uint32_t c = 0; c < goto_columns; c++){
+        h ^= (uint32_t)goto_row[c];
+        h *= 1099511628211ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+/// 扩大行数容量，ACTION/GOTO 整表搬到新的空间
+static bool reserve_rows(UnitContext* ctx, uint32_t rows){
+    LRTable* table = ctx->table;
+    if(rows <= ctx->row_capacity) return true;
+    uint32_t capacity = ctx->row_capacity * 2;
+    while(capacity < rows) capacity *= 2;
+    LRAction* action = arena_alloc(ctx->arena, (size_t)capacity * table->action_columns * sizeof(LRAction));
+    int32_t* goto_table = arena_alloc(ctx->arena, ((size_t)capacity * table->goto_columns + 1) * sizeof(int32_t));
+    uint64_t* hashes = arena_alloc(ctx->arena, (capacity - ctx->original_count + 1) * sizeof(uint64_t));
+    if(!action || !goto_table || !hashes){
+        fprintf(stderr, "Error: Failed to allocate memory for unit rule elimination.\n");
+        return false;
+    }
+    memcpy(action, table->action, (size_t)table->state_count * table->action_columns * sizeof(LRAction));
+    memcpy(goto_table, table->goto_table, (size_t)table->state_count * table->goto_columns * sizeof(int32_t));
+    if(table->state_count > ctx->original_count) memcpy(hashes, ctx->row_hash, (table->state_count - ctx->original_count) * sizeof(uint64_t));
+    table->action = action;
+    table->goto_table = goto_table;
+    ctx->row_hash = hashes;
+    ctx->row_capacity = capacity;
+    return true;
+}
+
+static void insert_row_slot(uint32_t* slots, uint32_t capacity, uint64_t hash, uint32_t row){
+    uint32_t slot = (uint32_t)hash & (capacity - 1);
+    while(slots[slot]) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = row + 1;
+}
+
+/// 查找与 ctx->action/goto_row 内容相同的新行，没有时追加，返回行号；失败时返回 -1
+static int64_t intern_row(UnitContext* ctx){
+    LRTable* table = ctx->table;
+    uint64_t hash = row_hash(ctx->action, table->action_columns, ctx->goto_row, table->goto_columns);
+    uint32_t mask = ctx->slot_capacity - 1;
+    for(uint32_t slot = (uint32_t)hash & mask; ctx->slots[slot]; slot = (slot + 1) & mask){
+        uint32_t row = ctx->slots[slot] - 1;
+        if(ctx->row_hash[row - ctx->original_count] == hash &&
+           memcmp(table->action + (size_t)row * table->action_columns, ctx->action, table->action_columns * sizeof(LRAction)) == 0 &&
+           memcmp(table->goto_table + (size_t)row * table->goto_columns, ctx->goto_row, table->goto_columns * sizeof(int32_t)) == 0){
+            return row;
+        }
+    }
+    if(!reserve_rows(ctx, table->state_count + 1)) return -1;
+    uint32_t row = table->state_count++;
+    memcpy(table->action + (size_t)row * table->action_columns, ctx->action, table->action_columns * sizeof(LRAction));
+    memcpy(table->goto_table + (size_t)row * table->goto_columns, ctx->goto_row, table->goto_columns * sizeof(int32_t));
+    ctx->row_hash[row - ctx->original_count] = hash;
+
+    // 装载因子保持在 1/2 以下
+    uint32_t added = table->state_count - ctx->original_count;
+    if(added * 2 > ctx->slot_capacity){
+        uint32_t capacity = ctx->slot_capacity * 2;
+        uint32_t* slots = arena_alloc(ctx->arena, capacity * sizeof(uint32_t));
+        if(!slots){
+            fprintf(stderr, "Error: Failed to allocate memory for unit rule elimination.\n");
+            return -1;
+        }
+        memset(slots, 0, capacity * sizeof(uint32_t));
+        for(uint32_t r = ctx->original_count; r < row; r++) insert_row_slot(slots, capacity, ctx->row_hash[r - ctx->original_count], r);
+        ctx->slots = slots;
+        ctx->slot_capacity = capacity;
+    }
+    insert_row_slot(ctx->slots, ctx->slot_capacity, hash, row);
+    return row;
+}
+
+/// 把状态 state 的 GOTO 行并入正在构造的行，同一列指向不同状态时返回 false
+static bool merge_goto_row(UnitContext* ctx, uint32_t state){
+    const int32_t* row = ctx->table->goto_table + (size_t)state * ctx->table->goto_columns;
+    for(uint32_t c = 0; c < ctx->table->goto_columns; c++){
+        if(row[c] == LR_GOTO_NONE || row[c] == ctx->goto_row[c]) continue;
+        if(ctx->goto_row[c] != LR_GOTO_NONE) return false;
+        ctx->goto_row[c] = row[c];
+    }
+    return true;
+}
+
+/// 构造 p 之上 q = GOTO[p, B] 的替代行。返回 false 表示 (p, B) 不改动：q 在任何向前看上都不按单产生式归约，
+/// 或者链上状态的 GOTO 互相冲突
+static bool build_bypass_row(UnitContext* ctx, uint32_t p, uint32_t q){
+    const LRTable* table = ctx->table;
+    const uint32_t columns = table->action_columns;
+    const int32_t* p_goto = table->goto_table + (size_t)p * table->goto_columns;
+    bool changed = false;
+    ctx->chain_count = 0;
+    memcpy(ctx->goto_row, table->goto_table + (size_t)q * table->goto_columns, table->goto_columns * sizeof(int32_t));
+    for(uint32_t a = 0; a < columns; a++){
+        LRAction action = table->action[(size_t)q * columns + a];
+        // A -> B 归约后露出 p，再经 GOTO[p, A] 到达的状态仍在 p 之上；链长不超过非终结符数，防止单产生式成环
+        for(uint32_t steps = 0; steps < table->goto_columns; steps++){
+            if(lr_action_kind(action) != LR_REDUCE || !ctx->unit[lr_action_value(action)]) break;
+            int32_t next = p_goto[ctx->rule_lhs[lr_action_value(action)]];
+            if(next == LR_GOTO_NONE) break;
+            action = table->action[(size_t)next * columns + a];
+            changed = true;
+            bool listed = false;
+            for(uint32_t i = 0; i < ctx->chain_count && !listed; i++) listed = ctx->chain[i] == (uint32_t)next;
+            if(!listed){
+                if(!merge_goto_row(ctx, (uint32_t)next)) return false;
+                ctx->chain[ctx->chain_count++] = (uint32_t)next;
+            }
+        }
+        ctx->action[a] = action;
+    }
+    return changed;
+}
+
+bool eliminate_unit_reductions(const Grammar* grammar, const bool* keep, LRTable* table, Arena* arena){
+    uint32_t n = table->goto_columns;
+    UnitContext ctx = {
+        .table = table,
+        .arena = arena,
+        .original_count = table->state_count,
+        .row_capacity = table->state_count,
+        .slot_capacity = 64
+    };
+    bool* unit = arena_alloc(arena, grammar->rule_count * sizeof(bool));
+    uint32_t* rule_lhs = arena_alloc(arena, grammar->rule_count * sizeof(uint32_t));
+    bool* has_unit = arena_alloc(arena, table->state_count * sizeof(bool));
+    ctx.slots = arena_alloc(arena, ctx.slot_capacity * sizeof(uint32_t));
+    ctx.row_hash = arena_alloc(arena, sizeof(uint64_t));
+    ctx.action = arena_alloc(arena, table->action_columns * sizeof(LRAction));
+    ctx.goto_row = arena_alloc(arena, (n + 1) * sizeof(int32_t));
+    ctx.chain = arena_alloc(arena, (n + 1) * sizeof(uint32_t));
+    if(!unit || !rule_lhs || !has_unit || !ctx.slots || !ctx.row_hash || !ctx.action || !ctx.goto_row || !ctx.chain){
+        fprintf(stderr, "Error: Failed to allocate memory for unit rule elimination.\n");
+        return false;
+    }
+    memset(ctx.slots, 0, ctx.slot_capacity * sizeof(uint32_t));
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        rule_lhs[r] = (uint32_t)grammar_nonterminal_id(grammar, rule->left_hs);
+        unit[r] = r != 0 && rule->right_hs_count == 1 && !grammar_symbol_is_terminal(grammar, rule->right_hs[0]) && !(keep && keep[r]);
+    }
+    ctx.unit = unit;
+    ctx.rule_lhs = rule_lhs;
+
+    // 只有在某个向前看上按单产生式归约的原有状态才需要绕过
+    for(uint32_t q = 0; q < table->state_count; q++){
+        has_unit[q] = false;
+        for(uint32_t a = 0; a < table->action_columns && !has_unit[q]; a++){
+            LRAction action = lr_table_action(table, q, a);
+            has_unit[q] = lr_action_kind(action) == LR_REDUCE && unit[lr_action_value(action)];
+        }
+    }
+
+    // 新行的 GOTO 也可能指向要绕过的状态，行数增长时一并处理；新行按内容去重，行数有限
+    for(uint32_t p = 0; p < table->state_count; p++){
+        for(uint32_t b = 0; b < n; b++){
+            int32_t q = table->goto_table[(size_t)p * n + b];
+            if(q == LR_GOTO_NONE || (uint32_t)q >= ctx.original_count || !has_unit[q]) continue;
+            if(!build_bypass_row(&ctx, p, (uint32_t)q)) continue;
+            int64_t row = intern_row(&ctx);
+            if(row < 0) return false;
+            table->goto_table[(size_t)p * n + b] = (int32_t)row;
+        }
+    }
+    return true;
+}
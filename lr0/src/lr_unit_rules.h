@@ -0,0 +1,18 @@
+#ifndef LR_UNIT_RULES_H
+#define LR_UNIT_RULES_H
+
+#include "arena.h"
+#include "grammar.h"
+#include "lr_table.h"
+#include <stdbool.h>
+
+// 在 ACTION/GOTO 表中绕过单产生式 A -> B（B 为非终结符）的归约。
+// 状态 q = GOTO[p, B] 在某个向前看上按 A -> B 归约时，分析器弹出 q 后查 GOTO[p, A] 再继续；
+// 对每个这样的 (p, B) 新建一行：q 的动作中按单产生式归约的格换成沿 GOTO[p, A]（及其后的单产生式链）
+// 最终得到的动作，GOTO 取 q 与链上各状态的并，再令 GOTO[p, B] 指向新行。内容相同的新行只保留一份。
+// 被绕过的归约不再执行语义动作、也不产生事件，所以只能用于语义动作为恒等（lr_parser 的默认动作）的产生式：
+// keep 为 NULL 时绕过全部单产生式，否则 keep[r] 为 true 的产生式保留。rules[0] 始终保留。
+// 新行追加在原有状态之后，原有状态号与冲突记录不变；GOTO 合并时同一列指向不同状态的 (p, B) 不做改动
+bool eliminate_unit_reductions(const Grammar* grammar, const bool* keep, LRTable* table, Arena* arena);
+
+#endif
@@ -0,0 +1,33 @@
+#include "slr_table.h"
+#include "grammar.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// 逐个状态展开闭包，完成项按 Follow 集的置位逐个填入归约，代价与表中填入的格数成正比
+bool build_slr1_table(const DFA* dfa, const SymbolSet* sets, LRTable* table, Arena* arena){
+    if(!lr_table_init(dfa, table, arena)) return false;
+    const Grammar* grammar = dfa->grammar;
+    uint32_t end = grammar->terminals_count;
+    size_t words = symbol_set_words(grammar);
+    ItemSet set = {0};
+    for(uint32_t s = 0; s < dfa->state_count; s++){
+        dfa_state_closure(dfa, s, &set);
+        for(uint32_t i = 0; i < set.item_count; i++){
+            if(dfa_item_next(dfa, set.items[i]) != LR_ITEM_END) continue;
+            uint32_t rule = dfa_item_rule(dfa, set.items[i]);
+            if(rule == 0){
+                if(!lr_table_set_action(table, s, end, lr_accept(), arena)) return false;
+                continue;
+            }
+            const uint64_t* follow = sets[grammar_nonterminal_id(grammar, grammar->rules[rule].left_hs)].follow;
+            for(size_t w = 0; w < words; w++){
+                for(uint64_t bits = follow[w]; bits; bits &= bits - 1){
+                    uint32_t column = (uint32_t)(w * SYMBOL_SET_WORD_BITS + __builtin_ctzll(bits));
+                    if(!lr_table_set_action(table, s, column, lr_reduce(rule), arena)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
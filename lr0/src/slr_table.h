@@ -0,0 +1,15 @@
+#ifndef SLR_TABLE_H
+#define SLR_TABLE_H
+
+#include "arena.h"
+#include "../../ll1/src/first_follow.h"
+#include "lr_table.h"
+#include "viable_prefix_dfa.h"
+#include <stdbool.h>
+
+// SLR(1) 分析表：在 LR(0) 自动机上，完成项 A -> α. 只在 Follow(A) 中的终结符（含 '$'）上归约。
+// sets 为 compute_first_sets/compute_follow_sets 的结果，按非终结符编号索引；
+// 与 LR(0) 表相同，rules[0] 视为增广产生式，完成时在 '$' 上接受
+bool build_slr1_table(const DFA* dfa, const SymbolSet* sets, LRTable* table, Arena* arena);
+
+#endif
@@ -7,214 +7,369 @@
 #include <ctype.h>
 #include <stdbool.h>
 
-// 打印 DFA
+// 打印项目 A -> α.β
+void fprint_item(FILE* out, const DFA* dfa, LRItem item) {
+    const Rule* rule = &dfa->grammar->rules[dfa_item_rule(dfa, item)];
+    uint32_t dot = dfa_item_dot(dfa, item);
+    fprint_symbol(out, dfa->grammar, rule->left_hs);
+    fprintf(out, " -> ");
+    for (uint32_t k = 0; k < rule->right_hs_count; k++) {
+        if (k == dot) fprintf(out, ".");
+        fprint_symbol(out, dfa->grammar, rule->right_hs[k]);
+    }
+    if (dot == rule->right_hs_count) fprintf(out, ".");
+}
+
+// 打印 DFA，状态按闭包展开
 void print_dfa(const DFA* dfa) {
     printf("=== DFA States ===\n");
-    for (uint8_t i = 0; i < dfa->state_count; i++) {
-        printf("State %d:\n", i);
-        for (uint8_t j = 0; j < dfa->states[i].item_count; j++) {
-            const DFAItem* item = &dfa->states[i].items[j];
-            printf("  %c -> ", item->left_symbol);
-            for (uint8_t k = 0; k < item->right_len; k++) {
-                if (k == item->dot) printf(".");
-                printf("%c", item->right_symbols[k]);
-            }
-            if (item->dot == item->right_len) printf(".");
+    ItemSet set = {0};
+    for (uint32_t i = 0; i < dfa->state_count; i++) {
+        printf("State %u:\n", i);
+        dfa_state_closure(dfa, i, &set);
+        for (uint32_t j = 0; j < set.item_count; j++) {
+            printf("  ");
+            fprint_item(stdout, dfa, set.items[j]);
             printf("\n");
         }
     }
 
     printf("\n=== DFA Transitions ===\n");
-    for (uint8_t i = 0; i < dfa->transition_count; i++) {
-        printf("  %d --%c--> %d\n", dfa->transitions[i].from_state,
-               dfa->transitions[i].symbol, dfa->transitions[i].to_state);
+    for (uint32_t i = 0; i < dfa->state_count; i++) {
+        uint32_t count;
+        const Transition* edges = dfa_transitions(dfa, i, &count);
+        for (uint32_t k = 0; k < count; k++) {
+            printf("  %u --", i);
+            fprint_symbol(stdout, dfa->grammar, edges[k].symbol);
+            printf("--> %u\n", edges[k].to_state);
+        }
     }
 }
 
-// 判断两个 DFA 项是否相等
-static int item_equal(const DFAItem* a, const DFAItem* b) {
-    return (a->left_symbol == b->left_symbol) &&
-           (a->right_len == b->right_len) &&
-           (a->dot == b->dot) &&
-           (strncmp(a->right_symbols, b->right_symbols, a->right_len) == 0);
+static void* dfa_alloc(Arena* arena, size_t size, const char* what){
+    void* ptr = arena_alloc(arena, size);
+    if(!ptr){
+        fprintf(stderr, "Invalid %s.\n", what);
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
 }
 
-// 判断两个 ItemSet 是否相等
-static bool itemset_equal(const ItemSet* a, const ItemSet* b) {
-    if (a->item_count != b->item_count) return false;
-    for (uint8_t i = 0; i < a->item_count; i++) {
-        int found = 0;
-        for (uint8_t j = 0; j < b->item_count; j++) {
-            if (item_equal(&a->items[i], &b->items[j])) {
-                found = 1;
-                break;
+// 按左部给产生式分组，再对每个非终结符沿左角关系（A -> B... 中 A 到 B）做一次遍历，
+// 把途经的非终结符的产生式并入它的 closure_rules 行
+static void build_closure_rules(const Grammar* grammar, LRItemSpace* space, Arena* arena){
+    uint32_t n = grammar->nonterminals_count;
+    uint32_t words = (grammar->rule_count + 63) / 64;
+    uint32_t* start = dfa_alloc(arena, (n + 1) * sizeof(uint32_t), "dfa closure index");
+    uint32_t* by_lhs = dfa_alloc(arena, grammar->rule_count * sizeof(uint32_t), "dfa closure index");
+    uint32_t* stack = dfa_alloc(arena, n * sizeof(uint32_t), "dfa closure index");
+    uint32_t* visited = dfa_alloc(arena, n * sizeof(uint32_t), "dfa closure index");
+    memset(start, 0, (n + 1) * sizeof(uint32_t));
+    memset(visited, 0, n * sizeof(uint32_t));
+    for(uint32_t r = 0; r < grammar->rule_count; r++) start[grammar_nonterminal_id(grammar, grammar->rules[r].left_hs) + 1]++;
+    for(uint32_t a = 0; a < n; a++) start[a + 1] += start[a];
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        uint32_t a = (uint32_t)grammar_nonterminal_id(grammar, grammar->rules[r].left_hs);
+        by_lhs[start[a]++] = r;
+    }
+    for(uint32_t a = n; a > 0; a--) start[a] = start[a - 1];
+    start[0] = 0;
+
+    space->rule_words = words;
+    space->closure_rules = dfa_alloc(arena, (size_t)n * words * sizeof(uint64_t), "dfa closure index");
+    memset(space->closure_rules, 0, (size_t)n * words * sizeof(uint64_t));
+    for(uint32_t a = 0; a < n; a++){
+        uint64_t* row = space->closure_rules + (size_t)a * words;
+        uint32_t top = 0;
+        stack[top++] = a;
+        visited[a] = a + 1;
+        while(top){
+            uint32_t b = stack[--top];
+            for(uint32_t k = start[b]; k < start[b + 1]; k++){
+                const Rule* rule = &grammar->rules[by_lhs[k]];
+                row[by_lhs[k] >> 6] |= 1ULL << (by_lhs[k] & 63);
+                if(!rule->right_hs_count || grammar_symbol_is_terminal(grammar, rule->right_hs[0])) continue;
+                uint32_t c = (uint32_t)grammar_nonterminal_id(grammar, rule->right_hs[0]);
+                if(visited[c] != a + 1){
+                    visited[c] = a + 1;
+                    stack[top++] = c;
+                }
             }
         }
-        if (!found) return false;
     }
-    return true;
 }
 
-// 查找 DFA 中是否已存在某个项集
-static int find_state(const DFA* dfa, const ItemSet* set) {
-    for (uint8_t i = 0; i < dfa->state_count; i++) {
-        if (itemset_equal(&dfa->states[i], set)) {
-            return i;
+// 为每条产生式的每个点位置编号，并记下项目所属的产生式与点后的符号，最后预先算出各非终结符的闭包
+static void build_item_space(const Grammar* grammar, LRItemSpace* space, Arena* arena){
+    space->rule_base = dfa_alloc(arena, (grammar->rule_count + 1) * sizeof(uint32_t), "dfa item space");
+    uint32_t total = 0;
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        space->rule_base[r] = total;
+        total += grammar->rules[r].right_hs_count + 1;
+    }
+    space->rule_base[grammar->rule_count] = total;
+    space->item_count = total;
+    space->item_rule = dfa_alloc(arena, total * sizeof(uint32_t), "dfa item space");
+    space->item_next = dfa_alloc(arena, total * sizeof(SymbolId), "dfa item space");
+    for(uint32_t r = 0; r < grammar->rule_count; r++){
+        const Rule* rule = &grammar->rules[r];
+        LRItem base = space->rule_base[r];
+        for(uint32_t dot = 0; dot <= rule->right_hs_count; dot++){
+            space->item_rule[base + dot] = r;
+            space->item_next[base + dot] = dot < rule->right_hs_count ? rule->right_hs[dot] : LR_ITEM_END;
         }
     }
-    return -1;
+    build_closure_rules(grammar, space, arena);
 }
 
-static void closure(ItemSet* set, const Grammar* grammar, Arena* arena){
-    uint8_t i = 0;
-    while(i < set->item_count){
-        DFAItem* item = &set->items[i++];
-        if(item->dot >= item->right_len) continue;
-
-        char next_symbol = item->right_symbols[item->dot];
-        if(isupper(next_symbol)){
-            for(int j = 0; j < grammar->rule_count; j++){
-                if(grammar->rules[j].left_hs == next_symbol){
-                    DFAItem new_item = {
-                        .left_symbol = next_symbol,
-                        .right_symbols = grammar->rules[j].right_hs,
-                        .right_len = strlen(grammar->rules[j].right_hs),
-                        .dot = 0
-                    };
-                    int exists = 0;
-                    for(uint8_t k = 0; k < set->item_count; k++){
-                        if(item_equal(&set->items[k], &new_item)){
-                            exists = 1;
-                            break;
-                        }
-                    }
-                    if (!exists) {
-                        if (set->item_count >= set->item_capacity) {
-                            size_t new_capacity = set->item_capacity ? set->item_capacity * 2 : 8;
-                            DFAItem* new_items = arena_alloc(arena, new_capacity * sizeof(DFAItem));
-                            if(!new_items){
-                                fprintf(stderr, "Invalid newitems.\n");
-                                exit(EXIT_FAILURE);
-                            }
-                            memcpy(new_items, set->items, set->item_count * sizeof(DFAItem));
-                            set->items = new_items;
-                            set->item_capacity = new_capacity;
-                        }
-                        set->items[set->item_count++] = new_item;
-                    }
-                }
-            }
+static void itemset_push(ItemSet* set, LRItem item, Arena* arena){
+    if(set->item_count >= set->item_capacity){
+        size_t new_capacity = set->item_capacity ? set->item_capacity * 2 : 16;
+        LRItem* new_items = dfa_alloc(arena, new_capacity * sizeof(LRItem), "dfa items");
+        if(set->item_count) memcpy(new_items, set->items, set->item_count * sizeof(LRItem));
+        set->items = new_items;
+        set->item_capacity = new_capacity;
+    }
+    set->items[set->item_count++] = item;
+}
+
+// 闭包是核心项点后各非终结符的 closure_rules 行之并，代价只与核心大小和位图字数有关
+static void closure(const DFA* dfa, ItemSet* set){
+    const Grammar* grammar = dfa->grammar;
+    const LRItemSpace* space = &dfa->items;
+    uint32_t words = space->rule_words;
+    uint64_t* bits = set->rule_bits;
+    uint32_t kernel_count = set->item_count;
+    bool any = false;
+    for(uint32_t i = 0; i < kernel_count; i++){
+        SymbolId next_symbol = space->item_next[set->items[i]];
+        if(next_symbol == LR_ITEM_END || grammar_symbol_is_terminal(grammar, next_symbol)) continue;
+        const uint64_t* row = space->closure_rules + (size_t)grammar_nonterminal_id(grammar, next_symbol) * words;
+        for(uint32_t w = 0; w < words; w++) bits[w] |= row[w];
+        any = true;
+    }
+    if(!any) return;
+    // 点在最左的核心项（只有开始状态才有）已经在集合中
+    for(uint32_t i = 0; i < kernel_count; i++){
+        uint32_t rule = space->item_rule[set->items[i]];
+        if(set->items[i] == space->rule_base[rule]) bits[rule >> 6] &= ~(1ULL << (rule & 63));
+    }
+    for(uint32_t w = 0; w < words; w++){
+        uint64_t word = bits[w];
+        bits[w] = 0;
+        while(word){
+            uint32_t rule = w * 64 + (uint32_t)__builtin_ctzll(word);
+            word &= word - 1;
+            itemset_push(set, space->rule_base[rule], dfa->arena);
         }
     }
 }
 
-// 计算项集在给定符号下的转移
-static void goto_set(const ItemSet* set, char symbol, const Grammar* grammar, ItemSet* out, Arena* arena) {
+void dfa_state_closure(const DFA* dfa, uint32_t state, ItemSet* out){
+    if(!out->rule_bits){
+        size_t words = dfa->items.rule_words;
+        out->rule_bits = dfa_alloc(dfa->arena, words * sizeof(uint64_t), "dfa rule bitset");
+        memset(out->rule_bits, 0, words * sizeof(uint64_t));
+    }
+    const DFAState* s = &dfa->states[state];
     out->item_count = 0;
-    for (uint8_t i = 0; i < set->item_count; i++) {
-        const DFAItem* item = &set->items[i];
-        if (item->dot < item->right_len && item->right_symbols[item->dot] == symbol) {
-            if (out->item_count >= out->item_capacity) {
-                size_t new_capacity = out->item_capacity ? out->item_capacity * 2 : 8;
-                DFAItem* new_items = arena_alloc(arena, new_capacity * sizeof(DFAItem));
-                memcpy(new_items, out->items, out->item_count * sizeof(DFAItem));
-                out->items = new_items;
-                out->item_capacity = new_capacity;
-            }
-            out->items[out->item_count++] = (DFAItem){
-                .left_symbol = item->left_symbol,
-                .right_symbols = item->right_symbols,
-                .right_len = item->right_len,
-                .dot = item->dot + 1
-            };
+    for(uint32_t k = 0; k < s->kernel_count; k++) itemset_push(out, s->kernel[k], dfa->arena);
+    closure(dfa, out);
+}
+
+static int compare_item(const void* a, const void* b){
+    LRItem x = *(const LRItem*)a, y = *(const LRItem*)b;
+    return (x > y) - (x < y);
+}
+
+// 核心项一般只有几项，插入排序即可；偶尔很大时交给 qsort
+static void sort_items(LRItem* items, uint32_t count){
+    if(count > 16){
+        qsort(items, count, sizeof(LRItem), compare_item);
+        return;
+    }
+    for(uint32_t i = 1; i < count; i++){
+        LRItem item = items[i];
+        uint32_t j = i;
+        while(j > 0 && items[j - 1] > item){
+            items[j] = items[j - 1];
+            j--;
         }
+        items[j] = item;
     }
-    closure(out, grammar, arena);
 }
 
-void build_viable_prefix_dfa(const Grammar* grammar, DFA* dfa, Arena* arena){
+static uint64_t kernel_hash(const LRItem* kernel, uint32_t count){
+    uint64_t h = 1469598103934665603ULL;
+    for(uint32_t i = 0; i < count; i++){
+        h ^= kernel[i];
+        h *= 1099511628211ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// 在散列表中查找核心为 kernel 的状态，比较代价只与核心大小有关
+static int find_state(const DFA* dfa, const LRItem* kernel, uint32_t count, uint64_t hash){
+    uint32_t mask = dfa->slot_capacity - 1;
+    for(uint32_t slot = (uint32_t)hash & mask; dfa->state_slots[slot]; slot = (slot + 1) & mask){
+        const DFAState* state = &dfa->states[dfa->state_slots[slot] - 1];
+        if(state->kernel_hash == hash && state->kernel_count == count &&
+           memcmp(state->kernel, kernel, count * sizeof(LRItem)) == 0){
+            return (int)(dfa->state_slots[slot] - 1);
+        }
+    }
+    return -1;
+}
+
+int dfa_find_kernel(const DFA* dfa, const LRItem* kernel, uint32_t count, uint32_t* cursor){
+    if(!dfa->slot_capacity) return -1;
+    uint64_t hash = kernel_hash(kernel, count);
+    uint32_t mask = dfa->slot_capacity - 1;
+    for(uint32_t slot = *cursor ? *cursor - 1 : (uint32_t)hash & mask; dfa->state_slots[slot]; slot = (slot + 1) & mask){
+        const DFAState* state = &dfa->states[dfa->state_slots[slot] - 1];
+        if(state->kernel_hash == hash && state->kernel_count == count &&
+           memcmp(state->kernel, kernel, count * sizeof(LRItem)) == 0){
+            *cursor = ((slot + 1) & mask) + 1;
+            return (int)(dfa->state_slots[slot] - 1);
+        }
+    }
+    return -1;
+}
+
+static void insert_slot(uint32_t* slots, uint32_t capacity, uint64_t hash, uint32_t state){
+    uint32_t slot = (uint32_t)hash & (capacity - 1);
+    while(slots[slot]) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = state + 1;
+}
+
+// 以 kernel 为核心新建状态并登记到散列表，返回状态号。状态中只存核心，不求闭包
+static uint32_t add_state(DFA* dfa, const LRItem* kernel, uint32_t count, uint64_t hash){
+    Arena* arena = dfa->arena;
+    LRItem* stored = dfa_alloc(arena, count * sizeof(LRItem), "dfa kernel");
+    memcpy(stored, kernel, count * sizeof(LRItem));
+
+    if(dfa->state_count >= dfa->state_capacity){
+        size_t new_capacity = dfa->state_capacity ? dfa->state_capacity * 2 : 16;
+        DFAState* new_states = dfa_alloc(arena, new_capacity * sizeof(DFAState), "dfa state");
+        if(dfa->state_count) memcpy(new_states, dfa->states, dfa->state_count * sizeof(DFAState));
+        dfa->states = new_states;
+        dfa->state_capacity = new_capacity;
+    }
+    uint32_t id = dfa->state_count++;
+    dfa->states[id] = (DFAState){
+        .kernel = stored,
+        .kernel_count = count,
+        .kernel_hash = hash
+    };
+
+    // 装载因子保持在 1/2 以下
+    if(dfa->state_count * 2 > dfa->slot_capacity){
+        uint32_t new_capacity = dfa->slot_capacity ? dfa->slot_capacity * 2 : 64;
+        uint32_t* slots = dfa_alloc(arena, new_capacity * sizeof(uint32_t), "dfa state table");
+        memset(slots, 0, new_capacity * sizeof(uint32_t));
+        for(uint32_t s = 0; s < id; s++) insert_slot(slots, new_capacity, dfa->states[s].kernel_hash, s);
+        dfa->state_slots = slots;
+        dfa->slot_capacity = new_capacity;
+    }
+    insert_slot(dfa->state_slots, dfa->slot_capacity, hash, id);
+    return id;
+}
+
+uint32_t dfa_add_state(DFA* dfa, const LRItem* kernel, uint32_t count){
+    return add_state(dfa, kernel, count, kernel_hash(kernel, count));
+}
+
+void dfa_add_transition(DFA* dfa, uint32_t from, SymbolId symbol, uint32_t to){
+    if(dfa->transition_count >= dfa->transition_capacity){
+        size_t new_capacity = dfa->transition_capacity ? dfa->transition_capacity * 2 : 32;
+        Transition* new_transitions = dfa_alloc(dfa->arena, new_capacity * sizeof(Transition), "dfa transitions");
+        if(dfa->transition_count) memcpy(new_transitions, dfa->transitions, dfa->transition_count * sizeof(Transition));
+        dfa->transitions = new_transitions;
+        dfa->transition_capacity = new_capacity;
+    }
+    dfa->transitions[dfa->transition_count++] = (Transition){
+        .from_state = from,
+        .symbol = symbol,
+        .to_state = to
+    };
+}
+
+void dfa_init(DFA* dfa, const Grammar* grammar, Arena* arena){
     if(!grammar || grammar->rule_count <= 0){
         fprintf(stderr, "Invalid or empty grammar.\n");
         exit(EXIT_FAILURE);
     }
     memset(dfa, 0, sizeof(DFA));
+    dfa->grammar = grammar;
     dfa->arena = arena;
+    build_item_space(grammar, &dfa->items, arena);
+}
 
-    ItemSet start = {0};
-    start.item_capacity = 8;
-    start.items = arena_alloc(arena, start.item_capacity*sizeof(DFAItem));
-    if(!start.items){
-        fprintf(stderr, "Invalid start dfa item.\n");
-        exit(EXIT_FAILURE);
-    }
-    start.items[0] = (DFAItem){
-        .left_symbol = grammar->rules[0].left_hs,
-        .right_symbols = grammar->rules[0].right_hs,
-        .right_len = strlen(grammar->rules[0].right_hs),
-        .dot = 0
-    };
-    start.item_count = 1;
-    closure(&start, grammar, arena);
+void dfa_finish(DFA* dfa){
+    const Grammar* grammar = dfa->grammar;
+    Arena* arena = dfa->arena;
+    // 转移已按起始状态分组且组按状态编号排列，计数即可得到各组的起点
+    uint32_t* transition_start = dfa_alloc(arena, (dfa->state_count + 1) * sizeof(uint32_t), "dfa transition index");
+    memset(transition_start, 0, (dfa->state_count + 1) * sizeof(uint32_t));
+    for(uint32_t t = 0; t < dfa->transition_count; t++) transition_start[dfa->transitions[t].from_state + 1]++;
+    for(uint32_t s = 0; s < dfa->state_count; s++) transition_start[s + 1] += transition_start[s];
+    dfa->transition_start = transition_start;
 
-    dfa->state_capacity = 16;
-    dfa->states = arena_alloc(arena, dfa->state_capacity*sizeof(ItemSet));
-    if(!dfa->states){
-        fprintf(stderr, "Invalid dfa state.\n");
-        exit(EXIT_FAILURE);
+    size_t cells = (size_t)dfa->state_count * grammar->symbol_count;
+    dfa->successors = dfa_alloc(arena, (cells ? cells : 1) * sizeof(int32_t), "dfa successor table");
+    memset(dfa->successors, 0xff, cells * sizeof(int32_t));
+    for(uint32_t t = 0; t < dfa->transition_count; t++){
+        const Transition* edge = &dfa->transitions[t];
+        dfa->successors[(size_t)edge->from_state * grammar->symbol_count + edge->symbol] = (int32_t)edge->to_state;
     }
-    dfa->states[dfa->state_count++] = start;
+}
 
-    dfa->transition_capacity = 32;
-    dfa->transitions = arena_alloc(arena, dfa->transition_capacity * sizeof(Transition));
-    if(!dfa->transitions){
-        fprintf(stderr, "Invalid dfa transitions.\n");
-        exit(EXIT_FAILURE);
-    }
-    for (uint8_t i = 0; i < dfa->state_count; i++) {
-        const ItemSet* current = &dfa->states[i];
-        char seen_symbols[256] = {0};
-
-        for (uint8_t j = 0; j < current->item_count; j++) {
-            char sym = current->items[j].right_symbols[current->items[j].dot];
-            if (sym && !seen_symbols[(unsigned char)sym]) {
-                seen_symbols[(unsigned char)sym] = 1;
-
-                ItemSet next = {0};
-                next.item_capacity = 8;
-                next.items = arena_alloc(arena, next.item_capacity * sizeof(DFAItem));
-                goto_set(current, sym, grammar, &next, arena);
-
-                int existing = find_state(dfa, &next);
-                if (existing == -1) {
-                    if (dfa->state_count >= dfa->state_capacity) {
-                        size_t new_capacity = dfa->state_capacity * 2;
-                        ItemSet* new_states = arena_alloc(arena, new_capacity * sizeof(ItemSet));
-                        memcpy(new_states, dfa->states, dfa->state_count * sizeof(ItemSet));
-                        dfa->states = new_states;
-                        dfa->state_capacity = new_capacity;
-                    }
-                    dfa->states[dfa->state_count++] = next;
-                    existing = dfa->state_count - 1;
-                } else {
-                    next.items = NULL;
-                }
+void build_viable_prefix_dfa(const Grammar* grammar, DFA* dfa, Arena* arena){
+    dfa_init(dfa, grammar, arena);
+    const SymbolId* item_next = dfa->items.item_next;
+
+    // set 与 kernel 是复用的临时区：set 存放当前状态展开后的闭包，kernel 存放一次转移得到的核心
+    ItemSet set = {0};
+    uint32_t kernel_capacity = 16;
+    LRItem* kernel = dfa_alloc(arena, kernel_capacity * sizeof(LRItem), "dfa kernel");
+
+    kernel[0] = dfa->items.rule_base[0];    //开始产生式，点在最左
+    dfa_add_state(dfa, kernel, 1);
 
-                if (dfa->transition_count >= dfa->transition_capacity) {
-                    size_t new_capacity = dfa->transition_capacity * 2;
-                    Transition* new_transitions = arena_alloc(arena, new_capacity * sizeof(Transition));
-                    memcpy(new_transitions, dfa->transitions, dfa->transition_count * sizeof(Transition));
-                    dfa->transitions = new_transitions;
-                    dfa->transition_capacity = new_capacity;
+    // seen_in_state[s] == i + 1 表示状态 i 已经处理过符号 s 上的转移
+    uint32_t* seen_in_state = dfa_alloc(arena, (grammar->symbol_count + 1) * sizeof(uint32_t), "dfa symbol marks");
+    memset(seen_in_state, 0, (grammar->symbol_count + 1) * sizeof(uint32_t));
+    // 状态按编号依次处理，每个状态的转移连续地追加在 transitions 末尾
+    for(uint32_t i = 0; i < dfa->state_count; i++){
+        dfa_state_closure(dfa, i, &set);
+
+        for(uint32_t j = 0; j < set.item_count; j++){
+            SymbolId sym = item_next[set.items[j]];
+            if(sym == LR_ITEM_END || seen_in_state[sym] == i + 1) continue;
+            seen_in_state[sym] = i + 1;
+
+            // goto(i, sym) 的核心：闭包中点后为 sym 的项，点右移一位即编号加一
+            uint32_t count = 0;
+            for(uint32_t k = j; k < set.item_count; k++){
+                if(item_next[set.items[k]] != sym) continue;
+                if(count == kernel_capacity){
+                    LRItem* grown = dfa_alloc(arena, kernel_capacity * 2 * sizeof(LRItem), "dfa kernel");
+                    memcpy(grown, kernel, count * sizeof(LRItem));
+                    kernel = grown;
+                    kernel_capacity *= 2;
                 }
-                dfa->transitions[dfa->transition_count++] = (Transition){
-                    .from_state = i,
-                    .symbol = sym,
-                    .to_state = existing
-                };
+                kernel[count++] = set.items[k] + 1;
             }
+            sort_items(kernel, count);
+            uint64_t hash = kernel_hash(kernel, count);
+
+            int existing = find_state(dfa, kernel, count, hash);
+            if(existing == -1) existing = (int)add_state(dfa, kernel, count, hash);
+            dfa_add_transition(dfa, i, sym, (uint32_t)existing);
         }
     }
-
+    dfa_finish(dfa);
 }
 
 void dfa_free(DFA* dfa){
@@ -4,42 +4,111 @@
 #include "grammar.h"
 #include "arena.h"
 #include <stdint.h>
+#include <stdio.h>
 
 
-typedef struct DFAItem
+// 全局项目空间：产生式 r 的项目 (r, dot) 编号为 rule_base[r] + dot，0 <= dot <= |右部|。
+// 同一产生式的项目编号连续且随点右移递增，按编号排序即按 (r, dot) 排序
+typedef uint32_t LRItem;
+
+#define LR_ITEM_END (-1)    //点已在产生式末尾，没有下一个符号
+
+typedef struct LRItemSpace
 {
-    const char* restrict right_symbols;
-    size_t right_len;
-    char left_symbol;
-    uint8_t dot;
-} DFAItem;
+    uint32_t* rule_base;    //rule_count + 1 项，最后一项为项目总数
+    uint32_t* item_rule;    //项目所属的产生式
+    SymbolId* item_next;    //点后的符号，完成项为 LR_ITEM_END
+    uint32_t item_count;
+    // 闭包只会加入点在最左的项目，即整条产生式，因此按产生式建位图，每行 rule_words 个字。
+    // closure_rules 的第 n 行是点在非终结符 n 之前时闭包引入的全部产生式（沿左角关系传递）
+    uint64_t* closure_rules;
+    uint32_t rule_words;
+} LRItemSpace;
 
+// 展开的项集，用作求闭包的临时区：前面是核心项，其后是闭包加入的项（按产生式下标升序）。
+// rule_bits 是求闭包时合并各行 closure_rules 的位图，返回前清零
 typedef struct ItemSet
 {
-    DFAItem* items;
-    uint8_t item_count;
-    uint8_t item_capacity;
+    LRItem* items;
+    uint32_t item_count;
+    uint32_t item_capacity;
+    uint64_t* rule_bits;
 } ItemSet;
 
+// 状态只保存核心项：按项目编号升序排列，两个状态相同当且仅当 kernel 相同。
+// 闭包项由核心唯一确定，需要时用 dfa_state_closure 展开
+typedef struct DFAState
+{
+    const LRItem* kernel;
+    uint32_t kernel_count;
+    uint64_t kernel_hash;
+} DFAState;
+
 typedef struct Transition{
-    uint8_t from_state;
-    char symbol;
-    uint8_t to_state;
+    uint32_t from_state;
+    SymbolId symbol;
+    uint32_t to_state;
 } Transition;
 
+#define DFA_NO_STATE (-1)
+
 typedef struct DFA{
-    ItemSet* states;
-    uint8_t state_count;
-    uint8_t state_capacity;
+    DFAState* states;
+    uint32_t state_count;
+    uint32_t state_capacity;
+    // 转移按起始状态分组（CSR）：状态 s 的转移为 transitions[transition_start[s] .. transition_start[s + 1])，
+    // 组内按符号首次出现在闭包中的顺序排列
     Transition* transitions;
-    uint16_t transition_count;
-    uint16_t transition_capacity;
+    uint32_t transition_count;
+    uint32_t transition_capacity;
+    uint32_t* transition_start;
+    // 稠密后继表：第 s 行第 X 列为 goto(s, X)，列为符号编号，DFA_NO_STATE 表示无转移
+    int32_t* successors;
+    // 按核心散列的开放定址表，槽中存状态号 + 1，0 表示空槽
+    uint32_t* state_slots;
+    uint32_t slot_capacity;
+    LRItemSpace items;
+    const Grammar* grammar;
     Arena* arena;
 } DFA;
 
 void build_viable_prefix_dfa(const Grammar* grammar, DFA* dfa, Arena* arena);
+
+// 逐个状态构造自动机的接口，供其他构造方法（如 LR(1)）复用状态、转移与闭包的表示：
+// dfa_init 建立项目空间；dfa_add_state 新建核心为 kernel（须按编号升序）的状态，不去重；
+// dfa_add_transition 追加转移，须按起始状态编号成组追加；dfa_finish 在最后建立按状态的转移分组与稠密后继表
+void dfa_init(DFA* dfa, const Grammar* grammar, Arena* arena);
+uint32_t dfa_add_state(DFA* dfa, const LRItem* kernel, uint32_t count);
+// 依次找出核心为 kernel 的各个状态：*cursor 初值为 0，没有更多时返回 -1。两次调用之间不能新建状态
+int dfa_find_kernel(const DFA* dfa, const LRItem* kernel, uint32_t count, uint32_t* cursor);
+void dfa_add_transition(DFA* dfa, uint32_t from, SymbolId symbol, uint32_t to);
+void dfa_finish(DFA* dfa);
+// 把状态 state 的闭包展开到 out 中，out 的空间不足时从 dfa->arena 中重新分配，可在同一个 DFA 上多次复用
+void dfa_state_closure(const DFA* dfa, uint32_t state, ItemSet* out);
+
+static inline int32_t dfa_goto(const DFA* dfa, uint32_t state, SymbolId symbol){
+    return dfa->successors[(size_t)state * dfa->grammar->symbol_count + symbol];
+}
+
+static inline const Transition* dfa_transitions(const DFA* dfa, uint32_t state, uint32_t* count){
+    *count = dfa->transition_start[state + 1] - dfa->transition_start[state];
+    return dfa->transitions + dfa->transition_start[state];
+}
+
+static inline uint32_t dfa_item_rule(const DFA* dfa, LRItem item){
+    return dfa->items.item_rule[item];
+}
+
+static inline uint32_t dfa_item_dot(const DFA* dfa, LRItem item){
+    return item - dfa->items.rule_base[dfa->items.item_rule[item]];
+}
+
+static inline SymbolId dfa_item_next(const DFA* dfa, LRItem item){
+    return dfa->items.item_next[item];
+}
 void dfa_free(DFA* dfa);
 void dfa_export_dot(const DFA* dfa, const char* filename);
+void fprint_item(FILE* out, const DFA* dfa, LRItem item);
 void print_dfa(const DFA* dfa);
 
 #endif
\ No newline at end of file
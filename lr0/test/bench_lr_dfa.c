@@ -0,0 +1,90 @@
+// bench_lr_dfa.c
+// LR(0) 自动机构造的基准：在规模递增的合成文法上计时 build_viable_prefix_dfa，并记录状态数、核心项与闭包项的数目。
+// clang -std=c11 -O2 bench_lr_dfa.c -o bench_lr_dfa -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+/// levels 层左结合的二元运算，每层 ops 个运算符，与 bench_lr_table 相同
+static bool write_expression_grammar(const char* filename, int levels, int ops) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "<start> -> <e0>\n");
+    for (int i = 0; i < levels; i++) {
+        fprintf(f, "<e%d> ->", i);
+        for (int k = 0; k < ops; k++) fprintf(f, " <e%d> 'op%d_%d' <e%d> |", i, i, k, i + 1);
+        fprintf(f, " <e%d>\n", i + 1);
+    }
+    fprintf(f, "<e%d> -> '(' <e0> ')' | 'id' | 'num'\n", levels);
+    fclose(f);
+    return true;
+}
+
+/// 语句文法：kinds 种以关键字开头的语句，语句体中可嵌套语句块与表达式
+static bool write_statement_grammar(const char* filename, int kinds) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "<program> -> <stmts>\n<stmts> -> <stmts> <stmt> | <stmt>\n");
+    fprintf(f, "<block> -> '{' <stmts> '}' | '{' '}'\n");
+    fprintf(f, "<expr> -> <expr> '+' <term> | <term>\n<term> -> <term> '*' <atom> | <atom>\n");
+    fprintf(f, "<atom> -> 'id' | 'num' | '(' <expr> ')'\n");
+    for (int i = 0; i < kinds; i++) {
+        fprintf(f, "<stmt> -> 'kw%d' <expr> <body%d>\n", i, i);
+        fprintf(f, "<body%d> -> <block> | ';' | 'kw%d_else' <block>\n", i, i);
+    }
+    fclose(f);
+    return true;
+}
+
+static int bench(const char* name, bool expression, int a, int b) {
+    bool ok = expression ? write_expression_grammar("bench_lr_dfa.txt", a, b) : write_statement_grammar("bench_lr_dfa.txt", a);
+    if (!ok) return 1;
+    Arena* arena = arena_create(1024 * 1024 * 1024);
+    GrammarResultGrammar res = read_grammar("bench_lr_dfa.txt", arena);
+    remove("bench_lr_dfa.txt");
+    if (res.status != GRAMMAR_OK) return 1;
+    Grammar* g = res.value;
+
+    DFA dfa;
+    clock_t begin = clock();
+    build_viable_prefix_dfa(g, &dfa, arena);
+    double elapsed = seconds_since(begin);
+    size_t arena_used = arena->offset;
+    size_t kernel = 0, items = 0;
+    ItemSet set = {0};
+    for (uint32_t s = 0; s < dfa.state_count; s++) {
+        kernel += dfa.states[s].kernel_count;
+        dfa_state_closure(&dfa, s, &set);
+        items += set.item_count;
+    }
+    printf("%-16s %8u %8u %10zu %10zu %10.2f %10.1f\n", name, g->rule_count, dfa.state_count, kernel, items,
+           elapsed * 1e3, arena_used / 1024.0);
+    arena_free(arena);
+    return 0;
+}
+
+int main(void) {
+    printf("%-16s %8s %8s %10s %10s %10s %10s\n", "grammar", "rules", "states", "kernel", "items", "ms", "arena KB");
+    int failed = 0;
+    failed |= bench("expr 8x4", true, 8, 4);
+    failed |= bench("expr 16x4", true, 16, 4);
+    failed |= bench("expr 24x6", true, 24, 6);
+    failed |= bench("stmt 50", false, 50, 0);
+    failed |= bench("stmt 200", false, 200, 0);
+    return failed;
+}
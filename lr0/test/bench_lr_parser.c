@@ -0,0 +1,204 @@
+// bench_lr_parser.c
+// 表驱动 LR 分析器的吞吐量基准：在随机生成的表达式语句 token 流上，分别测只做识别、输出事件流、
+// 执行语义动作三种用法每秒处理的 token 数，并统计每个 token 平均的归约次数；同时对比绕过单产生式归约后的表。
+// clang -std=c11 -O2 bench_lr_parser.c -o bench_lr_parser -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../../ll1/src/first_follow.h"
+#include "../../ll1/src/first_follow.c"
+
+#include "../../ll1/src/digraph.h"
+#include "../../ll1/src/digraph.c"
+
+#include "../../ll1/src/first_set.h"
+#include "../../ll1/src/first_set.c"
+
+#include "../../ll1/src/follow_set.h"
+#include "../../ll1/src/follow_set.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../src/lalr_table.h"
+#include "../src/lalr_table.c"
+
+#include "../src/lr_parser.h"
+#include "../src/lr_parser.c"
+
+#include "../src/lr_unit_rules.h"
+#include "../src/lr_unit_rules.c"
+
+static const char* const expression_grammar =
+    "<program> -> <stmts>\n"
+    "<stmts> -> <stmts> <expr> ';' | <expr> ';'\n"
+    "<expr> -> <expr> '+' <term> | <expr> '-' <term> | <term>\n"
+    "<term> -> <term> '*' <factor> | <term> '/' <factor> | <factor>\n"
+    "<factor> -> '(' <expr> ')' | 'id' | 'num'\n";
+
+typedef struct {
+    int32_t* tokens;
+    size_t count;
+    size_t capacity;
+    int id, num, plus, minus, star, slash, lparen, rparen;
+} TokenBuffer;
+
+static void push(TokenBuffer* b, int token) {
+    if (b->count < b->capacity) b->tokens[b->count++] = token;
+}
+
+static void gen_expr(TokenBuffer* b, int depth);
+
+static void gen_factor(TokenBuffer* b, int depth) {
+    int r = rand() % 8;
+    if (depth > 0 && r == 0) {
+        push(b, b->lparen);
+        gen_expr(b, depth - 1);
+        push(b, b->rparen);
+    } else {
+        push(b, r & 1 ? b->id : b->num);
+    }
+}
+
+static void gen_term(TokenBuffer* b, int depth) {
+    gen_factor(b, depth);
+    while (rand() % 3 == 0) {
+        push(b, rand() & 1 ? b->star : b->slash);
+        gen_factor(b, depth);
+    }
+}
+
+static void gen_expr(TokenBuffer* b, int depth) {
+    gen_term(b, depth);
+    while (rand() % 2 == 0) {
+        push(b, rand() & 1 ? b->plus : b->minus);
+        gen_term(b, depth);
+    }
+}
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+typedef struct {
+    size_t events;
+    size_t reductions;
+} EventCount;
+
+static void count_events(void* context, const ParseEvent* events, size_t count) {
+    EventCount* c = context;
+    c->events += count;
+    for (size_t i = 0; i < count; i++) c->reductions += parse_event_is_rule(events[i]);
+}
+
+// 语义动作：二元运算的结果为两侧之和，其余沿用默认动作
+static LRValue sum_binary(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)context;
+    (void)rule;
+    (void)count;
+    return values[0] + values[2];
+}
+
+static int terminal(Grammar* g, const char* name) {
+    return grammar_terminal_id(g, grammar_lookup_symbol(g, name, strlen(name)));
+}
+
+static LRParseResult parse_rounds(LRParser* parser, const TokenBuffer* b, int rounds, const Grammar* g) {
+    LRParseResult r = { LR_PARSE_OK, 0, -1, 0 };
+    for (int i = 0; i < rounds && r.status == LR_PARSE_OK; i++) {
+        TokenArray array = { b->tokens, b->count, 0, (int)g->terminals_count };
+        TokenIterator input = { token_array_next, &array };
+        r = lr_parse(parser, &input);
+    }
+    return r;
+}
+
+int main(void) {
+    Arena* arena = arena_create(1024 * 1024 * 16);
+    GrammarResultGrammar res = parse_grammar(expression_grammar, strlen(expression_grammar), "bench", arena);
+    if (res.status != GRAMMAR_OK) return 1;
+    Grammar* g = res.value;
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int set_count = 0;
+    compute_first_sets(g, sets, &set_count, arena);
+    compute_follow_sets(g, sets, &set_count, arena);
+    // 同一张 LALR(1) 表，另一份绕过单产生式归约（E -> T、T -> F 等）
+    DFA dfa;
+    LRTable tables[2];
+    build_viable_prefix_dfa(g, &dfa, arena);
+    if (!build_lalr1_table(&dfa, sets, &tables[0], arena) || tables[0].conflict_count) return 1;
+    if (!build_lalr1_table(&dfa, sets, &tables[1], arena) || !eliminate_unit_reductions(g, NULL, &tables[1], arena)) return 1;
+    const char* const table_names[2] = { "lalr1", "lalr1 -u" };
+
+    // 每张表、每种用法各一个分析器，栈与事件缓冲都在这里一次分配
+    EventCount counted = {0};
+    LRParser parsers[2][3];
+    LRReduceAction* actions = arena_alloc(arena, g->rule_count * sizeof(LRReduceAction));
+    for (uint32_t r = 0; r < g->rule_count; r++) actions[r] = g->rules[r].right_hs_count == 3 ? sum_binary : NULL;
+    for (int t = 0; t < 2; t++) {
+        if (!lr_parser_init(&parsers[t][0], g, &tables[t], 4096, 1024, NULL, NULL, arena) ||
+            !lr_parser_init(&parsers[t][1], g, &tables[t], 4096, 1024, count_events, &counted, arena) ||
+            !lr_parser_init(&parsers[t][2], g, &tables[t], 4096, 1024, NULL, NULL, arena)) return 1;
+        lr_parser_set_actions(&parsers[t][2], actions, NULL);
+    }
+    printf("states: %u, %u after unit rule elimination\n", tables[0].state_count, tables[1].state_count);
+
+    size_t sizes[] = { 100000, 1000000, 10000000 };
+    int failed = 0;
+    printf("%12s %10s %14s %14s %14s %12s\n", "tokens", "table", "recognize/s", "events/s", "actions/s", "reduce/tok");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        TokenBuffer b = { malloc(sizes[s] * sizeof(int32_t)), 0, sizes[s],
+                          terminal(g, "id"), terminal(g, "num"), terminal(g, "+"), terminal(g, "-"),
+                          terminal(g, "*"), terminal(g, "/"), terminal(g, "("), terminal(g, ")") };
+        int semicolon = terminal(g, ";");
+        srand(1);
+        // 留出余量，保证最后一个表达式完整
+        b.capacity = sizes[s] - 2048;
+        while (b.count + 1024 < b.capacity) {
+            gen_expr(&b, 20);
+            b.tokens[b.count++] = semicolon;
+        }
+
+        int rounds = (int)(20000000 / b.count) + 1;
+        double total = (double)b.count * rounds;
+        LRValue values[2];
+        for (int t = 0; t < 2; t++) {
+            double rate[3], reductions = 0;
+            for (int p = 0; p < 3; p++) {
+                counted = (EventCount){0};
+                clock_t begin = clock();
+                LRParseResult r = parse_rounds(&parsers[t][p], &b, rounds, g);
+                double time = seconds_since(begin);
+                if (r.status != LR_PARSE_OK || r.token_count != b.count) failed = 1;
+                rate[p] = time > 0 ? total / time : 0.0;
+                values[t] = r.value;
+                if (p != 1) continue;
+                if (counted.events - counted.reductions != (size_t)total) failed = 1;
+                reductions = (double)counted.reductions / total;
+            }
+            printf("%12zu %10s %14.0f %14.0f %14.0f %12.2f\n", b.count, table_names[t], rate[0], rate[1], rate[2],
+                   reductions);
+        }
+        // 被绕过的都是默认动作，语义值不变
+        if (values[0] != values[1]) failed = 1;
+        free(b.tokens);
+    }
+    arena_free(arena);
+    if (failed) printf("FAIL: parse error or event mismatch on generated input\n");
+    return failed;
+}
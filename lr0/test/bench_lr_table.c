@@ -0,0 +1,103 @@
+// bench_lr_table.c
+// LR 分析表的规模基准：在多层优先级的合成表达式文法上构造 LR(0) 自动机与 ACTION/GOTO 表，
+// 比较稠密表与压缩表（等价列 + 默认动作 + 行位移）的大小和查表速度。
+// clang -std=c11 -O2 bench_lr_table.c -o bench_lr_table -Wall -Wextra
+#define UNITY_BUILD // 启用 Unity Build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+static double seconds_since(clock_t begin) {
+    return (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+/// levels 层左结合的二元运算，每层 ops 个运算符：<e0> -> <e0> 'op0_0' <e1> | ... | <e1>
+static bool write_expression_grammar(const char* filename, int levels, int ops) {
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+    fprintf(f, "<start> -> <e0>\n");
+    for (int i = 0; i < levels; i++) {
+        fprintf(f, "<e%d> ->", i);
+        for (int k = 0; k < ops; k++) fprintf(f, " <e%d> 'op%d_%d' <e%d> |", i, i, k, i + 1);
+        fprintf(f, " <e%d>\n", i + 1);
+    }
+    fprintf(f, "<e%d> -> '(' <e0> ')' | 'id' | 'num'\n", levels);
+    fclose(f);
+    return true;
+}
+
+int main(void) {
+    int sizes[][2] = { { 4, 2 }, { 8, 4 }, { 16, 4 }, { 24, 6 } };
+    int failed = 0;
+    printf("%8s %8s %8s %12s %12s %8s %10s %10s\n", "levels", "states", "columns", "dense B", "packed B", "ratio",
+           "dense ns", "packed ns");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        Arena* arena = arena_create(256 * 1024 * 1024);
+        if (!write_expression_grammar("bench_lr_grammar.txt", sizes[s][0], sizes[s][1])) return 1;
+        GrammarResultGrammar res = read_grammar("bench_lr_grammar.txt", arena);
+        remove("bench_lr_grammar.txt");
+        if (res.status != GRAMMAR_OK) return 1;
+        Grammar* g = res.value;
+
+        DFA dfa;
+        LRTable table;
+        CompressedTable action, goto_table;
+        build_viable_prefix_dfa(g, &dfa, arena);
+        if (!build_lr0_table(&dfa, &table, arena) || !compress_lr_table(&table, &action, &goto_table, arena)) return 1;
+
+        size_t dense = (size_t)table.state_count * (table.action_columns + table.goto_columns) * sizeof(int32_t);
+        size_t packed = compressed_table_bytes(&action) + compressed_table_bytes(&goto_table);
+
+        // 只查非出错格，两种表的结果必须一致
+        uint32_t* keys = malloc(4096 * 2 * sizeof(uint32_t));
+        int key_count = 0;
+        srand(4);
+        while (key_count < 4096) {
+            uint32_t state = (uint32_t)rand() % table.state_count;
+            uint32_t column = (uint32_t)rand() % table.action_columns;
+            if (lr_table_action(&table, state, column) == LR_ACTION_ERROR) continue;
+            keys[2 * key_count] = state;
+            keys[2 * key_count + 1] = column;
+            key_count++;
+        }
+        size_t lookups = 20000000;
+        long dense_sum = 0, packed_sum = 0;
+        clock_t begin = clock();
+        for (size_t i = 0; i < lookups; i++) {
+            const uint32_t* k = keys + 2 * (i & 4095);
+            dense_sum += lr_table_action(&table, k[0], k[1]);
+        }
+        double dense_time = seconds_since(begin);
+        begin = clock();
+        for (size_t i = 0; i < lookups; i++) {
+            const uint32_t* k = keys + 2 * (i & 4095);
+            packed_sum += compressed_table_lookup(&action, k[0], k[1]);
+        }
+        double packed_time = seconds_since(begin);
+        if (dense_sum != packed_sum) failed = 1;
+
+        printf("%8d %8u %8u %12zu %12zu %7.1f%% %10.2f %10.2f\n", sizes[s][0], table.state_count,
+               table.action_columns + table.goto_columns, dense, packed, 100.0 * packed / dense,
+               dense_time * 1e9 / lookups, packed_time * 1e9 / lookups);
+        free(keys);
+        arena_free(arena);
+    }
+    if (failed) printf("FAIL: compressed lookups differ from the dense table\n");
+    return failed;
+}
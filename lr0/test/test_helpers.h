@@ -0,0 +1,55 @@
+// lr0 各测试共用的夹具，在被测源文件之后包含；文法载入与 First/Follow 等沿用 ll1 的测试夹具
+#ifndef LR0_TEST_HELPERS_H
+#define LR0_TEST_HELPERS_H
+
+#include "../../ll1/test/test_helpers.h"
+
+/// 终结符在 ACTION 表中的列，"$" 为最后一列
+static inline uint32_t column_of(const Grammar* g, const char* terminal) {
+    if (strcmp(terminal, "$") == 0) return g->terminals_count;
+    return (uint32_t)grammar_terminal_id(g, grammar_lookup_symbol(g, terminal, strlen(terminal)));
+}
+
+/// 从状态 0 出发依次读入 path 中的单字符符号，返回到达的状态。路径上缺少转移说明测试本身写错了，
+/// 直接中止，免得之后的断言落在别的状态上照样通过
+static inline uint32_t walk(const DFA* dfa, const char* path) {
+    uint32_t state = 0;
+    for (const char* p = path; *p; p++) {
+        SymbolId sym = grammar_lookup_symbol(dfa->grammar, p, 1);
+        int32_t next = sym == GRAMMAR_NO_SYMBOL ? DFA_NO_STATE : dfa_goto(dfa, state, sym);
+        if (next == DFA_NO_STATE) {
+            printf("\033[0;31mFAIL: no transition on '%c' in walk(\"%s\")\n\033[0m", *p, path);
+            fflush(stdout);
+            abort();
+        }
+        state = (uint32_t)next;
+    }
+    return state;
+}
+
+/// 两张表的 ACTION 是否逐格相同
+static inline bool same_actions(const LRTable* a, const LRTable* b) {
+    return a->state_count == b->state_count && a->action_columns == b->action_columns &&
+           memcmp(a->action, b->action, (size_t)a->state_count * a->action_columns * sizeof(LRAction)) == 0;
+}
+
+#if defined(LR_PARSER_H) && defined(LALR_TABLE_H)
+/// 左递归的表达式文法，用 LALR(1) 表分析
+static inline Grammar* load_expression_grammar(Arena* arena, LRTable* table) {
+    Grammar* g = load_grammar("S->E\nE -> E+T | T\nT -> T*F | F\nF -> (E) | n\n", arena);
+    if (!g) return NULL;
+    SymbolSet* sets = grammar_sets(g, arena);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    return build_lalr1_table(&dfa, sets, table, arena) && table->conflict_count == 0 ? g : NULL;
+}
+
+static inline LRParseResult parse_text(Grammar* g, LRParser* parser, const char* text) {
+    int32_t tokens[256];
+    TokenArray array = { tokens, tokenize(g, text, tokens), 0, (int)g->terminals_count };
+    TokenIterator input = { token_array_next, &array };
+    return lr_parse(parser, &input);
+}
+#endif
+
+#endif
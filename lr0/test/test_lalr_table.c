@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../../ll1/src/first_follow.h"
+#include "../../ll1/src/first_follow.c"
+
+#include "../../ll1/src/digraph.h"
+#include "../../ll1/src/digraph.c"
+
+#include "../../ll1/src/first_set.h"
+#include "../../ll1/src/first_set.c"
+
+#include "../../ll1/src/follow_set.h"
+#include "../../ll1/src/follow_set.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../src/slr_table.h"
+#include "../src/slr_table.c"
+
+#include "../src/lalr_table.h"
+#include "../src/lalr_table.c"
+
+#include "test_helpers.h"
+
+static bool build_lalr(Grammar* g, DFA* dfa, LRTable* table, Arena* arena) {
+    SymbolSet* sets = grammar_sets(g, arena);
+    build_viable_prefix_dfa(g, dfa, arena);
+    return build_lalr1_table(dfa, sets, table, arena);
+}
+
+// --- Test functions ---
+TEST(test_lalr1_resolves_slr1_conflict) {
+    Arena* arena = arena_create(1024 * 256);
+    // 非 SLR(1) 的 L=R 文法：LALR(1) 中 R -> L. 的向前看只有 '$'
+    Grammar* g = load_grammar("Z->S\nS -> L=R | R\nL -> *R | i\nR -> L\n", arena);
+    ASSERT(g != NULL);
+    DFA dfa;
+    LRTable table;
+    ASSERT(build_lalr(g, &dfa, &table, arena));
+    ASSERT(table.conflict_count == 0);
+    uint32_t l = walk(&dfa, "L");
+    ASSERT(lr_action_kind(lr_table_action(&table, l, column_of(g, "="))) == LR_SHIFT);
+    LRAction a = lr_table_action(&table, l, column_of(g, "$"));
+    ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 5);
+    // *R 之后的 L -> *R. 在 '=' 与 '$' 上都要归约
+    uint32_t star = walk(&dfa, "*R");
+    ASSERT(lr_action_kind(lr_table_action(&table, star, column_of(g, "="))) == LR_REDUCE);
+    ASSERT(lr_action_kind(lr_table_action(&table, star, column_of(g, "$"))) == LR_REDUCE);
+    ASSERT(lr_action_kind(lr_table_action(&table, walk(&dfa, "S"), column_of(g, "$"))) == LR_ACCEPT);
+    arena_free(arena);
+}
+
+TEST(test_lalr1_matches_slr1) {
+    Arena* arena = arena_create(1024 * 1024);
+    // 表达式文法是 SLR(1) 的，两种方法得到同一张表
+    Grammar* g = load_grammar("S->E\nE -> E+T | T\nT -> T*F | F\nF -> (E) | i\n", arena);
+    SymbolSet* sets = grammar_sets(g, arena);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    LRTable slr, lalr;
+    ASSERT(build_slr1_table(&dfa, sets, &slr, arena));
+    ASSERT(build_lalr1_table(&dfa, sets, &lalr, arena));
+    ASSERT(lalr.conflict_count == 0);
+    ASSERT(same_actions(&slr, &lalr));
+    arena_free(arena);
+}
+
+TEST(test_lalr1_nullable) {
+    Arena* arena = arena_create(1024 * 256);
+    // 可空的 B 经 reads 把 c 带到 A 之后，经 includes 把 S 之后的 '$' 带到 B 之后
+    Grammar* g = load_grammar("Z->S\nS -> aAB | Bd\nA -> x\nB -> c | #\n", arena);
+    DFA dfa;
+    LRTable table;
+    ASSERT(build_lalr(g, &dfa, &table, arena));
+    ASSERT(table.conflict_count == 0);
+    uint32_t x = walk(&dfa, "ax");
+    ASSERT(lr_action_kind(lr_table_action(&table, x, column_of(g, "c"))) == LR_REDUCE);
+    ASSERT(lr_action_kind(lr_table_action(&table, x, column_of(g, "$"))) == LR_REDUCE);
+    ASSERT(lr_table_action(&table, x, column_of(g, "d")) == LR_ACTION_ERROR);
+    // 状态 0 上 B -> . 只在 'd' 上归约，aA 之后只在 '$' 上归约
+    LRAction a = lr_table_action(&table, 0, column_of(g, "d"));
+    ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 5);
+    ASSERT(lr_table_action(&table, 0, column_of(g, "$")) == LR_ACTION_ERROR);
+    a = lr_table_action(&table, walk(&dfa, "aA"), column_of(g, "$"));
+    ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 5);
+    arena_free(arena);
+}
+
+TEST(test_lalr1_merge_conflict) {
+    Arena* arena = arena_create(1024 * 256);
+    // LR(1) 但不是 LALR(1)：ac 与 bc 之后的两个状态核心相同，合并后 A -> c. 与 B -> c. 在 d、e 上归约-归约冲突
+    Grammar* g = load_grammar("Z->S\nS -> aAd | bBd | aBe | bAe\nA -> c\nB -> c\n", arena);
+    DFA dfa;
+    LRTable table;
+    ASSERT(build_lalr(g, &dfa, &table, arena));
+    ASSERT(walk(&dfa, "ac") == walk(&dfa, "bc"));
+    ASSERT(table.conflict_count == 2);
+    for (uint32_t i = 0; i < table.conflict_count; i++) {
+        ASSERT(table.conflicts[i].state == walk(&dfa, "ac"));
+        ASSERT(lr_action_kind(table.conflicts[i].chosen) == LR_REDUCE);
+        ASSERT(lr_action_kind(table.conflicts[i].rejected) == LR_REDUCE);
+    }
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_lalr1_resolves_slr1_conflict);
+    RUN_TEST(test_lalr1_matches_slr1);
+    RUN_TEST(test_lalr1_nullable);
+    RUN_TEST(test_lalr1_merge_conflict);
+
+    return failed;
+}
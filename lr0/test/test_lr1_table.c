@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../../ll1/src/first_follow.h"
+#include "../../ll1/src/first_follow.c"
+
+#include "../../ll1/src/digraph.h"
+#include "../../ll1/src/digraph.c"
+
+#include "../../ll1/src/first_set.h"
+#include "../../ll1/src/first_set.c"
+
+#include "../../ll1/src/follow_set.h"
+#include "../../ll1/src/follow_set.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../src/slr_table.h"
+#include "../src/slr_table.c"
+
+#include "../src/lalr_table.h"
+#include "../src/lalr_table.c"
+
+#include "../src/lr1_table.h"
+#include "../src/lr1_table.c"
+
+#include "test_helpers.h"
+
+// --- Test functions ---
+TEST(test_lr1_splits_lalr_merge) {
+    Arena* arena = arena_create(1024 * 256);
+    // LR(1) 但不是 LALR(1)：ac 与 bc 之后的两个状态核心相同、向前看交叉，Pager 不合并它们
+    Grammar* g = load_grammar("Z->S\nS -> aAd | bBd | aBe | bAe\nA -> c\nB -> c\n", arena);
+    ASSERT(g != NULL);
+    SymbolSet* sets = grammar_sets(g, arena);
+    DFA lr0;
+    build_viable_prefix_dfa(g, &lr0, arena);
+    for (int merge = LR1_CANONICAL; merge <= LR1_PAGER; merge++) {
+        LR1Automaton lr1;
+        LRTable table;
+        ASSERT(build_lr1_automaton(g, sets, (LR1Merge)merge, &lr1, arena));
+        ASSERT(build_lr1_table(&lr1, &table, arena));
+        ASSERT(table.conflict_count == 0);
+        ASSERT(walk(&lr1.dfa, "ac") != walk(&lr1.dfa, "bc"));
+        ASSERT(lr1.dfa.state_count == lr0.state_count + 1);
+        LRAction a = lr_table_action(&table, walk(&lr1.dfa, "ac"), column_of(g, "d"));
+        ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 5);
+        a = lr_table_action(&table, walk(&lr1.dfa, "bc"), column_of(g, "d"));
+        ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 6);
+    }
+    arena_free(arena);
+}
+
+TEST(test_lr1_pager_matches_lalr1) {
+    Arena* arena = arena_create(1024 * 1024);
+    // 对 LALR(1) 文法，Pager 合并回 LR(0) 的状态集合，编号与表都和 LALR(1) 相同；规范 LR(1) 的状态更多
+    const char* grammars[] = {
+        "S->E\nE -> E+T | T\nT -> T*F | F\nF -> (E) | i\n",
+        "Z->S\nS -> L=R | R\nL -> *R | i\nR -> L\n",
+    };
+    for (int i = 0; i < 2; i++) {
+        Grammar* g = load_grammar(grammars[i], arena);
+        SymbolSet* sets = grammar_sets(g, arena);
+        DFA dfa;
+        LRTable lalr, pager_table, canonical_table;
+        build_viable_prefix_dfa(g, &dfa, arena);
+        ASSERT(build_lalr1_table(&dfa, sets, &lalr, arena));
+        LR1Automaton pager, canonical;
+        ASSERT(build_lr1_automaton(g, sets, LR1_PAGER, &pager, arena));
+        ASSERT(build_lr1_automaton(g, sets, LR1_CANONICAL, &canonical, arena));
+        ASSERT(build_lr1_table(&pager, &pager_table, arena));
+        ASSERT(build_lr1_table(&canonical, &canonical_table, arena));
+        ASSERT(pager.dfa.state_count == dfa.state_count);
+        ASSERT(canonical.dfa.state_count > dfa.state_count);
+        ASSERT(canonical.merge_count == 0);
+        ASSERT(same_actions(&pager_table, &lalr));
+        ASSERT(canonical_table.conflict_count == 0);
+    }
+    arena_free(arena);
+}
+
+TEST(test_lr1_nullable) {
+    Arena* arena = arena_create(1024 * 256);
+    // 闭包项 B -> . 的向前看来自 S -> .Bd 的 First(d)；S -> aA.B 之后 B 可空，A -> x. 的向前看含 c 与 '$'
+    Grammar* g = load_grammar("Z->S\nS -> aAB | Bd\nA -> x\nB -> c | #\n", arena);
+    SymbolSet* sets = grammar_sets(g, arena);
+    LR1Automaton lr1;
+    LRTable table;
+    ASSERT(build_lr1_automaton(g, sets, LR1_CANONICAL, &lr1, arena));
+    ASSERT(build_lr1_table(&lr1, &table, arena));
+    ASSERT(table.conflict_count == 0);
+    LRAction a = lr_table_action(&table, 0, column_of(g, "d"));
+    ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 5);
+    ASSERT(lr_table_action(&table, 0, column_of(g, "$")) == LR_ACTION_ERROR);
+    uint32_t x = walk(&lr1.dfa, "ax");
+    ASSERT(lr_action_kind(lr_table_action(&table, x, column_of(g, "c"))) == LR_REDUCE);
+    ASSERT(lr_action_kind(lr_table_action(&table, x, column_of(g, "$"))) == LR_REDUCE);
+    ASSERT(lr_table_action(&table, x, column_of(g, "d")) == LR_ACTION_ERROR);
+    ASSERT(lr_action_kind(lr_table_action(&table, walk(&lr1.dfa, "S"), column_of(g, "$"))) == LR_ACCEPT);
+    arena_free(arena);
+}
+
+TEST(test_lr1_requires_augmented_grammar) {
+    Arena* arena = arena_create(1024 * 256);
+    // S 还有别的产生式且出现在右部，rules[0] 不是增广产生式，各构造都拒绝
+    Grammar* g = load_grammar("S -> aSc | b\n", arena);
+    SymbolSet* sets = grammar_sets(g, arena);
+    LR1Automaton lr1;
+    LRTable table;
+    ASSERT(!build_lr1_automaton(g, sets, LR1_PAGER, &lr1, arena));
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    ASSERT(!build_lalr1_table(&dfa, sets, &table, arena));
+    ASSERT(!build_lr0_table(&dfa, &table, arena));
+
+    // 加上 Z -> S 之后，开始状态在 b 上移进，读完 S 后在 '$' 上接受
+    g = load_grammar("Z->S\nS -> aSc | b\n", arena);
+    sets = grammar_sets(g, arena);
+    ASSERT(build_lr1_automaton(g, sets, LR1_PAGER, &lr1, arena));
+    ASSERT(build_lr1_table(&lr1, &table, arena));
+    ASSERT(lr_action_kind(lr_table_action(&table, 0, column_of(g, "b"))) == LR_SHIFT);
+    ASSERT(lr_table_action(&table, walk(&lr1.dfa, "S"), column_of(g, "$")) == lr_accept());
+    ASSERT(lr_table_action(&table, walk(&lr1.dfa, "aS"), column_of(g, "$")) == LR_ACTION_ERROR);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_lr1_splits_lalr_merge);
+    RUN_TEST(test_lr1_pager_matches_lalr1);
+    RUN_TEST(test_lr1_nullable);
+    RUN_TEST(test_lr1_requires_augmented_grammar);
+
+    return failed;
+}
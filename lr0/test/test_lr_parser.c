@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../../ll1/src/first_follow.h"
+#include "../../ll1/src/first_follow.c"
+
+#include "../../ll1/src/digraph.h"
+#include "../../ll1/src/digraph.c"
+
+#include "../../ll1/src/first_set.h"
+#include "../../ll1/src/first_set.c"
+
+#include "../../ll1/src/follow_set.h"
+#include "../../ll1/src/follow_set.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../src/lalr_table.h"
+#include "../src/lalr_table.c"
+
+#include "../src/lr_parser.h"
+#include "../src/lr_parser.c"
+
+#include "test_helpers.h"
+
+// 语义动作求值：n 的值取自与 token 对齐的数组
+typedef struct {
+    const LRValue* numbers;
+    int calls;
+} Evaluator;
+
+static LRValue eval_number(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)rule;
+    (void)count;
+    Evaluator* e = context;
+    e->calls++;
+    return e->numbers[values[0]];
+}
+
+static LRValue eval_add(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)rule;
+    (void)count;
+    ((Evaluator*)context)->calls++;
+    return values[0] + values[2];
+}
+
+static LRValue eval_mul(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)rule;
+    (void)count;
+    ((Evaluator*)context)->calls++;
+    return values[0] * values[2];
+}
+
+static LRValue eval_paren(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)rule;
+    (void)count;
+    ((Evaluator*)context)->calls++;
+    return values[1];
+}
+
+// --- Test functions ---
+TEST(test_rightmost_derivation_events) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    ASSERT(g != NULL);
+    EventLog log = { .grammar = g };
+    LRParser parser;
+    ASSERT(lr_parser_init(&parser, g, &table, 64, 64, log_events, &log, arena));
+
+    LRParseResult r = parse_text(g, &parser, "n+n*n");
+    ASSERT(r.status == LR_PARSE_OK);
+    ASSERT(r.token_count == 5);
+    ASSERT_STR_EQ(log.text, "nF>n T>F E>T +nF>n T>F *nF>n T>T*F E>E+T S>E ");
+    ASSERT(log.batches == 1);
+    arena_free(arena);
+}
+
+TEST(test_events_flushed_in_batches) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    EventLog small = { .grammar = g };
+    EventLog large = { .grammar = g };
+    LRParser p1, p2;
+    ASSERT(lr_parser_init(&p1, g, &table, 64, 3, log_events, &small, arena));
+    ASSERT(lr_parser_init(&p2, g, &table, 64, 256, log_events, &large, arena));
+
+    ASSERT(parse_text(g, &p1, "(n*(n+n))").status == LR_PARSE_OK);
+    ASSERT(parse_text(g, &p2, "(n*(n+n))").status == LR_PARSE_OK);
+    ASSERT_STR_EQ(small.text, large.text);
+    ASSERT(small.batches > 1);
+    arena_free(arena);
+}
+
+TEST(test_semantic_actions) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    LRParser parser;
+    ASSERT(lr_parser_init(&parser, g, &table, 64, 64, NULL, NULL, arena));
+    // 单个符号的产生式沿用默认动作，值原样上传
+    LRReduceAction actions[7] = { NULL, eval_add, NULL, eval_mul, NULL, eval_paren, eval_number };
+    ASSERT(g->rule_count == 7);
+    // "2*(3+4)+5" 的 token 与各 token 的值
+    LRValue numbers[] = { 2, 0, 0, 3, 0, 4, 0, 0, 5 };
+    Evaluator e = { numbers, 0 };
+    lr_parser_set_actions(&parser, actions, &e);
+    LRParseResult r = parse_text(g, &parser, "n*(n+n)+n");
+    ASSERT(r.status == LR_PARSE_OK);
+    ASSERT(r.value == 19);
+    ASSERT(e.calls == 8);
+    arena_free(arena);
+}
+
+TEST(test_syntax_errors) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    LRParser parser;
+    ASSERT(lr_parser_init(&parser, g, &table, 64, 64, NULL, NULL, arena));
+
+    LRParseResult r = parse_text(g, &parser, "n+*n");
+    ASSERT(r.status == LR_PARSE_SYNTAX_ERROR);
+    ASSERT(r.token_count == 2);
+    ASSERT(r.error_terminal == grammar_terminal_id(g, grammar_lookup_symbol(g, "*", 1)));
+
+    // 输入提前结束
+    r = parse_text(g, &parser, "(n+n");
+    ASSERT(r.status == LR_PARSE_SYNTAX_ERROR);
+    ASSERT(r.token_count == 4);
+    ASSERT(r.error_terminal == (int)g->terminals_count);
+    ASSERT(parse_text(g, &parser, "").status == LR_PARSE_SYNTAX_ERROR);
+    arena_free(arena);
+}
+
+TEST(test_stack_overflow) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    LRParser parser;
+    ASSERT(lr_parser_init(&parser, g, &table, 8, 64, NULL, NULL, arena));
+    ASSERT(parse_text(g, &parser, "((((((((n))))))))").status == LR_PARSE_STACK_OVERFLOW);
+    ASSERT(parse_text(g, &parser, "((n))").status == LR_PARSE_OK);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_rightmost_derivation_events);
+    RUN_TEST(test_events_flushed_in_batches);
+    RUN_TEST(test_semantic_actions);
+    RUN_TEST(test_syntax_errors);
+    RUN_TEST(test_stack_overflow);
+
+    return failed;
+}
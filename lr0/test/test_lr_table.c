@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../../ll1/src/grammar_cache.h"
+#include "../../ll1/src/grammar_cache.c"
+
+#include "../src/lr_cache.h"
+#include "../src/lr_cache.c"
+
+#include "test_helpers.h"
+
+// --- Test functions ---
+TEST(test_expression_lr0_table) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S->E\nE -> T\nE -> E+T\nT -> i\nT -> (E)\n", arena);
+    ASSERT(g != NULL);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    LRTable table;
+    ASSERT(build_lr0_table(&dfa, &table, arena));
+    ASSERT(table.conflict_count == 0);
+    ASSERT(table.state_count == 9);
+
+    LRAction a = lr_table_action(&table, 0, column_of(g, "i"));
+    ASSERT(lr_action_kind(a) == LR_SHIFT && lr_action_value(a) == walk(&dfa, "i"));
+    ASSERT(lr_table_action(&table, 0, column_of(g, "+")) == LR_ACTION_ERROR);
+    ASSERT(lr_action_kind(lr_table_action(&table, walk(&dfa, "E"), column_of(g, "$"))) == LR_ACCEPT);
+    // T -> i. 在每一列上归约
+    a = lr_table_action(&table, walk(&dfa, "i"), column_of(g, ")"));
+    ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 3);
+    int e = grammar_nonterminal_id(g, grammar_lookup_symbol(g, "E", 1));
+    ASSERT(lr_table_goto(&table, 0, (uint32_t)e) == (int32_t)walk(&dfa, "E"));
+    ASSERT(lr_table_goto(&table, walk(&dfa, "i"), (uint32_t)e) == LR_GOTO_NONE);
+    arena_free(arena);
+}
+
+TEST(test_dfa_states_unique) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S->E\nE -> T\nE -> E+T\nT -> i\nT -> (E)\n", arena);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    // 从不同前缀到达相同核心时复用同一状态
+    ASSERT(walk(&dfa, "((") == walk(&dfa, "("));
+    ASSERT(walk(&dfa, "(i") == walk(&dfa, "i"));
+    ASSERT(walk(&dfa, "E+(") == walk(&dfa, "("));
+    // 核心按项目编号升序，各状态的核心互不相同
+    int unsorted = 0, duplicates = 0;
+    for (uint32_t s = 0; s < dfa.state_count; s++) {
+        const DFAState* a = &dfa.states[s];
+        for (uint32_t k = 1; k < a->kernel_count; k++) unsorted += a->kernel[k - 1] >= a->kernel[k];
+        for (uint32_t t = s + 1; t < dfa.state_count; t++) {
+            const DFAState* b = &dfa.states[t];
+            duplicates += a->kernel_count == b->kernel_count &&
+                          memcmp(a->kernel, b->kernel, a->kernel_count * sizeof(LRItem)) == 0;
+        }
+    }
+    ASSERT(unsorted == 0);
+    ASSERT(duplicates == 0);
+    arena_free(arena);
+}
+
+TEST(test_dfa_state_closure) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S->E\nE -> T\nE -> E+T\nT -> i\nT -> (E)\n", arena);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    ItemSet set = {0};
+    // 开始状态的闭包沿 S -> E、E -> T 的左角关系引入全部产生式，点都在最左
+    dfa_state_closure(&dfa, 0, &set);
+    ASSERT(set.item_count == g->rule_count);
+    for (uint32_t i = 0; i < set.item_count; i++) ASSERT(dfa_item_dot(&dfa, set.items[i]) == 0);
+    // E+ 之后只引入 T 的产生式
+    dfa_state_closure(&dfa, walk(&dfa, "E+"), &set);
+    ASSERT(set.item_count == 3);
+    ASSERT(dfa_item_rule(&dfa, set.items[1]) == 3 && dfa_item_rule(&dfa, set.items[2]) == 4);
+
+    // 开始产生式左递归时，核心项 (0, 0) 不会被闭包重复加入
+    g = load_grammar("S -> Sa | b\n", arena);
+    build_viable_prefix_dfa(g, &dfa, arena);
+    set = (ItemSet){0};
+    dfa_state_closure(&dfa, 0, &set);
+    ASSERT(set.item_count == 2);
+    arena_free(arena);
+}
+
+TEST(test_lr0_conflicts) {
+    Arena* arena = arena_create(1024 * 256);
+    // E -> T. 与 E -> T.+E 在 '+' 上移进-归约冲突
+    Grammar* g = load_grammar("S->E\nE -> T | T+E\nT -> i\n", arena);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    LRTable table;
+    ASSERT(build_lr0_table(&dfa, &table, arena));
+    ASSERT(table.conflict_count == 1);
+    const LRConflict* c = &table.conflicts[0];
+    ASSERT(c->state == walk(&dfa, "T"));
+    ASSERT(c->terminal == column_of(g, "+"));
+    ASSERT(lr_action_kind(c->chosen) == LR_SHIFT);
+    ASSERT(lr_action_kind(c->rejected) == LR_REDUCE && lr_action_value(c->rejected) == 1);
+    arena_free(arena);
+}
+
+TEST(test_compressed_lr_table) {
+    Arena* arena = arena_create(1024 * 1024 * 4);
+    // 多层优先级的表达式文法，状态与符号都较多
+    Grammar* g = load_grammar("S->A\nA -> A~B | B\nB -> B&C | C\nC -> C=D | D\nD -> D^E | E\n"
+                              "E -> E+F | E-F | F\nF -> F*G | F/G | G\nG -> -G | !G | H\nH -> (A) | i | n\n", arena);
+    ASSERT(g != NULL);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    LRTable table;
+    CompressedTable action, goto_table;
+    ASSERT(build_lr0_table(&dfa, &table, arena));
+    ASSERT(compress_lr_table(&table, &action, &goto_table, arena));
+    int mismatches = 0;
+    for (uint32_t s = 0; s < table.state_count; s++) {
+        for (uint32_t c = 0; c < table.action_columns; c++) {
+            LRAction expected = lr_table_action(&table, s, c);
+            if (expected != LR_ACTION_ERROR && compressed_table_lookup(&action, s, c) != expected) mismatches++;
+        }
+        for (uint32_t c = 0; c < table.goto_columns; c++) {
+            int32_t expected = lr_table_goto(&table, s, c);
+            if (expected != LR_GOTO_NONE && compressed_table_lookup(&goto_table, s, c) != expected) mismatches++;
+        }
+    }
+    ASSERT(mismatches == 0);
+    // 只含归约的状态整行都由默认动作表示，不占用槽
+    uint32_t reduce_state = walk(&dfa, "i");
+    ASSERT(lr_action_kind(action.row_default[reduce_state]) == LR_REDUCE);
+    size_t dense = (size_t)table.state_count * (table.action_columns + table.goto_columns) * sizeof(int32_t);
+    ASSERT(compressed_table_bytes(&action) + compressed_table_bytes(&goto_table) < dense);
+    arena_free(arena);
+}
+
+TEST(test_lr_table_cache) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S->E\nE -> T | T+E\nT -> i\n", arena);
+    DFA dfa;
+    build_viable_prefix_dfa(g, &dfa, arena);
+    LRTable table;
+    ASSERT(build_lr0_table(&dfa, &table, arena));
+
+    GrammarCacheWriter writer;
+    grammar_cache_writer_init(&writer);
+    ASSERT(grammar_cache_put_grammar(&writer, g, arena) && cache_put_lr_table(&writer, &table, arena));
+    ASSERT(grammar_cache_write("temp_table.cache", 42, &writer));
+    GrammarCache cache;
+    ASSERT(grammar_cache_open("temp_table.cache", 42, &cache));
+    Grammar* cached = grammar_cache_load_grammar(&cache, arena);
+    LRTable loaded;
+    ASSERT(cached && cache_load_lr_table(&cache, cached, &loaded));
+    ASSERT(cached->rule_count == g->rule_count && loaded.state_count == table.state_count);
+    ASSERT(memcmp(loaded.action, table.action, (size_t)table.state_count * table.action_columns * sizeof(LRAction)) == 0);
+    ASSERT(memcmp(loaded.goto_table, table.goto_table, (size_t)table.state_count * table.goto_columns * sizeof(int32_t)) == 0);
+    ASSERT(loaded.conflict_count == 1 && loaded.conflicts[0].state == table.conflicts[0].state);
+    grammar_cache_close(&cache);
+    ASSERT(!grammar_cache_open("temp_table.cache", 43, &cache));
+    remove("temp_table.cache");
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_expression_lr0_table);
+    RUN_TEST(test_dfa_states_unique);
+    RUN_TEST(test_dfa_state_closure);
+    RUN_TEST(test_lr0_conflicts);
+    RUN_TEST(test_compressed_lr_table);
+    RUN_TEST(test_lr_table_cache);
+
+    return failed;
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../../ll1/src/first_follow.h"
+#include "../../ll1/src/first_follow.c"
+
+#include "../../ll1/src/digraph.h"
+#include "../../ll1/src/digraph.c"
+
+#include "../../ll1/src/first_set.h"
+#include "../../ll1/src/first_set.c"
+
+#include "../../ll1/src/follow_set.h"
+#include "../../ll1/src/follow_set.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../src/lalr_table.h"
+#include "../src/lalr_table.c"
+
+#include "../src/lr_parser.h"
+#include "../src/lr_parser.c"
+
+#include "../src/lr_unit_rules.h"
+#include "../src/lr_unit_rules.c"
+
+#include "test_helpers.h"
+
+typedef struct {
+    size_t reductions;
+    size_t shifts;
+} EventCount;
+
+static void count_events(void* context, const ParseEvent* events, size_t count) {
+    EventCount* c = context;
+    for (size_t i = 0; i < count; i++) {
+        if (parse_event_is_rule(events[i])) c->reductions++;
+        else c->shifts++;
+    }
+}
+
+static LRValue eval_add(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)context;
+    (void)rule;
+    (void)count;
+    return values[0] + values[2];
+}
+
+static LRValue eval_mul(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)context;
+    (void)rule;
+    (void)count;
+    return values[0] * values[2];
+}
+
+static LRValue eval_paren(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)context;
+    (void)rule;
+    (void)count;
+    return values[1];
+}
+
+// n 的值为它在输入中的下标加一
+static LRValue eval_number(void* context, uint32_t rule, const LRValue* values, uint32_t count) {
+    (void)context;
+    (void)rule;
+    (void)count;
+    return values[0] + 1;
+}
+
+// --- Test functions ---
+TEST(test_unit_reductions_bypassed) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    ASSERT(g != NULL);
+    uint32_t states = table.state_count;
+    ASSERT(eliminate_unit_reductions(g, NULL, &table, arena));
+    ASSERT(table.state_count > states);
+    EventLog log = { .grammar = g };
+    LRParser parser;
+    ASSERT(lr_parser_init(&parser, g, &table, 64, 64, log_events, &log, arena));
+    // T -> F 与 E -> T 不再出现，rules[0] 仍在接受时归约
+    ASSERT(parse_text(g, &parser, "n+n*n").status == LR_PARSE_OK);
+    ASSERT_STR_EQ(log.text, "nF>n +nF>n *nF>n T>T*F E>E+T S>E ");
+    arena_free(arena);
+}
+
+TEST(test_unit_elimination_same_language) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable original, bypassed;
+    Grammar* g = load_expression_grammar(arena, &original);
+    load_expression_grammar(arena, &bypassed);
+    ASSERT(eliminate_unit_reductions(g, NULL, &bypassed, arena));
+    LRParser p1, p2;
+    ASSERT(lr_parser_init(&p1, g, &original, 64, 64, NULL, NULL, arena));
+    ASSERT(lr_parser_init(&p2, g, &bypassed, 64, 64, NULL, NULL, arena));
+    LRReduceAction actions[7] = { NULL, eval_add, NULL, eval_mul, NULL, eval_paren, eval_number };
+    lr_parser_set_actions(&p1, actions, NULL);
+    lr_parser_set_actions(&p2, actions, NULL);
+    // 语义值、接受与否以及出错位置都与原表相同
+    const char* inputs[] = { "n", "n+n", "(n)", "n*(n+n)*n+n", "((n+n)*(n))", "n+", "n+*n", "(n", "n)", "", "nn", "(n+n))" };
+    int mismatches = 0;
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        LRParseResult a = parse_text(g, &p1, inputs[i]);
+        LRParseResult b = parse_text(g, &p2, inputs[i]);
+        mismatches += a.status != b.status || a.token_count != b.token_count || a.value != b.value;
+    }
+    ASSERT(mismatches == 0);
+    arena_free(arena);
+}
+
+TEST(test_unit_elimination_keep) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable table;
+    Grammar* g = load_expression_grammar(arena, &table);
+    // 保留 E -> T（例如它有自己的语义动作），只绕过 T -> F
+    bool keep[7] = { false, false, true, false, false, false, false };
+    ASSERT(eliminate_unit_reductions(g, keep, &table, arena));
+    EventLog log = { .grammar = g };
+    LRParser parser;
+    ASSERT(lr_parser_init(&parser, g, &table, 64, 64, log_events, &log, arena));
+    ASSERT(parse_text(g, &parser, "n+n").status == LR_PARSE_OK);
+    ASSERT_STR_EQ(log.text, "nF>n E>T +nF>n E>E+T S>E ");
+    arena_free(arena);
+}
+
+TEST(test_unit_elimination_reduction_count) {
+    Arena* arena = arena_create(1024 * 256);
+    LRTable original, bypassed;
+    Grammar* g = load_expression_grammar(arena, &original);
+    load_expression_grammar(arena, &bypassed);
+    ASSERT(eliminate_unit_reductions(g, NULL, &bypassed, arena));
+    EventCount before = {0}, after = {0};
+    LRParser p1, p2;
+    ASSERT(lr_parser_init(&p1, g, &original, 64, 4, count_events, &before, arena));
+    ASSERT(lr_parser_init(&p2, g, &bypassed, 64, 4, count_events, &after, arena));
+    const char* text = "n*(n+n)*n+n";
+    ASSERT(parse_text(g, &p1, text).status == LR_PARSE_OK);
+    ASSERT(parse_text(g, &p2, text).status == LR_PARSE_OK);
+    ASSERT(before.shifts == after.shifts);
+    // 原表：5 个 F -> n、4 个 T -> F、2 个 E -> T，外加 2 个 T -> T*F、2 个 E -> E+T、F -> (E) 与 S -> E；
+    // 绕过后少了 6 个单产生式归约
+    ASSERT(before.reductions == 17);
+    ASSERT(after.reductions == 11);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_unit_reductions_bypassed);
+    RUN_TEST(test_unit_elimination_same_language);
+    RUN_TEST(test_unit_elimination_keep);
+    RUN_TEST(test_unit_elimination_reduction_count);
+
+    return failed;
+}
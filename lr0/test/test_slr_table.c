@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "test_framework.h"
+
+#include "../src/arena.h"
+#include "../src/arena.c"
+
+#include "../src/grammar.h"
+#include "../src/grammar.c"
+
+#include "../../ll1/src/first_follow.h"
+#include "../../ll1/src/first_follow.c"
+
+#include "../../ll1/src/digraph.h"
+#include "../../ll1/src/digraph.c"
+
+#include "../../ll1/src/first_set.h"
+#include "../../ll1/src/first_set.c"
+
+#include "../../ll1/src/follow_set.h"
+#include "../../ll1/src/follow_set.c"
+
+#include "../src/viable_prefix_dfa.h"
+#include "../src/viable_prefix_dfa.c"
+
+#include "../../ll1/src/table_compress.h"
+#include "../../ll1/src/table_compress.c"
+
+#include "../src/lr_table.h"
+#include "../src/lr_table.c"
+
+#include "../src/slr_table.h"
+#include "../src/slr_table.c"
+
+#include "test_helpers.h"
+
+static bool build_slr(Grammar* g, DFA* dfa, LRTable* table, Arena* arena) {
+    SymbolSet* sets = arena_alloc(arena, (g->nonterminals_count + 1) * sizeof(SymbolSet));
+    int set_count = 0;
+    compute_first_sets(g, sets, &set_count, arena);
+    compute_follow_sets(g, sets, &set_count, arena);
+    build_viable_prefix_dfa(g, dfa, arena);
+    return build_slr1_table(dfa, sets, table, arena);
+}
+
+// --- Test functions ---
+TEST(test_slr1_resolves_lr0_conflict) {
+    Arena* arena = arena_create(1024 * 256);
+    // LR(0) 在状态 T. 上对 '+' 移进-归约冲突；Follow(E) = { $ }，SLR(1) 只在 '$' 上归约
+    Grammar* g = load_grammar("S->E\nE -> T | T+E\nT -> i\n", arena);
+    ASSERT(g != NULL);
+    DFA dfa;
+    LRTable table;
+    ASSERT(build_slr(g, &dfa, &table, arena));
+    ASSERT(table.conflict_count == 0);
+    uint32_t t = walk(&dfa, "T");
+    ASSERT(lr_action_kind(lr_table_action(&table, t, column_of(g, "+"))) == LR_SHIFT);
+    LRAction a = lr_table_action(&table, t, column_of(g, "$"));
+    ASSERT(lr_action_kind(a) == LR_REDUCE && lr_action_value(a) == 1);
+    // T -> i. 在 Follow(T) = { +, $ } 上归约，其余列出错
+    uint32_t i = walk(&dfa, "i");
+    ASSERT(lr_action_kind(lr_table_action(&table, i, column_of(g, "+"))) == LR_REDUCE);
+    ASSERT(lr_action_kind(lr_table_action(&table, i, column_of(g, "$"))) == LR_REDUCE);
+    ASSERT(lr_table_action(&table, i, column_of(g, "i")) == LR_ACTION_ERROR);
+    ASSERT(lr_action_kind(lr_table_action(&table, walk(&dfa, "E"), column_of(g, "$"))) == LR_ACCEPT);
+    arena_free(arena);
+}
+
+TEST(test_slr1_expression_table) {
+    Arena* arena = arena_create(1024 * 256);
+    Grammar* g = load_grammar("S->E\nE -> E+T | T\nT -> T*F | F\nF -> (E) | i\n", arena);
+    DFA dfa;
+    LRTable table;
+    ASSERT(build_slr(g, &dfa, &table, arena));
+    ASSERT(table.conflict_count == 0);
+    ASSERT(table.state_count == 12);
+    // E -> T. 与 T -> T.*F 共处一个状态：'*' 上移进，Follow(E) 上归约
+    uint32_t t = walk(&dfa, "T");
+    ASSERT(lr_action_kind(lr_table_action(&table, t, column_of(g, "*"))) == LR_SHIFT);
+    ASSERT(lr_action_kind(lr_table_action(&table, t, column_of(g, ")"))) == LR_REDUCE);
+    ASSERT(lr_table_action(&table, t, column_of(g, "(")) == LR_ACTION_ERROR);
+    arena_free(arena);
+}
+
+TEST(test_slr1_conflict) {
+    Arena* arena = arena_create(1024 * 256);
+    // 经典的非 SLR(1) 文法：'=' 在 Follow(R) 中，状态 {S -> L.=R, R -> L.} 上移进-归约冲突
+    Grammar* g = load_grammar("Z->S\nS -> L=R | R\nL -> *R | i\nR -> L\n", arena);
+    DFA dfa;
+    LRTable table;
+    ASSERT(build_slr(g, &dfa, &table, arena));
+    ASSERT(table.conflict_count == 1);
+    const LRConflict* c = &table.conflicts[0];
+    ASSERT(c->state == walk(&dfa, "L"));
+    ASSERT(c->terminal == column_of(g, "="));
+    ASSERT(lr_action_kind(c->chosen) == LR_SHIFT);
+    ASSERT(lr_action_kind(c->rejected) == LR_REDUCE && lr_action_value(c->rejected) == 5);
+    arena_free(arena);
+}
+
+// --- Main ---
+int main() {
+    RUN_TEST(test_slr1_resolves_lr0_conflict);
+    RUN_TEST(test_slr1_expression_table);
+    RUN_TEST(test_slr1_conflict);
+
+    return failed;
+}